@@ -5,19 +5,36 @@
 #ifndef MFPTLIB_CORE_CACHE_HPP
 #define MFPTLIB_CORE_CACHE_HPP
 
+#include <algorithm>
 #include <utility>
 
 #include <Eigen/Dense>
 
+#include <mfptlib/core/Compaction.hpp>
 #include <mfptlib/core/Errors.hpp>
+#include <mfptlib/core/Storage.hpp>
 #include <mfptlib/core/Types.hpp>
 
 
 namespace mfptlib {
 
+// Rows of per-state data, which follow the states through filter_rows(),
+// split_rows(), and join_rows().
+//
+// A cache can also be bound to columns owned by someone else, e.g., an
+// Ensemble, which then moves the rows along with the states. While bound,
+// filter_rows() only drops the rows beyond the selected ones, and
+// split_rows() and join_rows() hand out adjacent parts of the columns.
+// Copies of a bound cache share its columns.
 template<typename Array>
 class Cache
 {
+public:
+    using Scalar = typename Array::Scalar;
+    using View = Eigen::Map<Array, 0, Eigen::OuterStride<>>;
+    using ConstView = Eigen::Map<const Array, 0, Eigen::OuterStride<>>;
+
+
 public:
     explicit Cache() noexcept = default;
 
@@ -29,78 +46,202 @@ class Cache
 
     auto operator=(Cache&& rhs) noexcept -> Cache& = default;
 
+    // New storage is padded to a multiple of BlockRows rows,
+    // which aligns the columns as well as the allocator does.
     template<typename Derived>
     auto operator=(const Eigen::EigenBase<Derived>& rhs) noexcept -> Cache&
     {
-        rows_ = rhs.rows();
-        if(rhs.cols() == array_.cols() and rhs.rows() <= array_.cols())
-            **this = rhs;
-        else
-            array_ = rhs;
+        resize(rhs.rows(), rhs.cols());
+        **this = rhs.derived();
 
         return *this;
     }
 
     auto operator=(Array&& rhs) noexcept -> Cache&
     {
+        if(bound_data_)
+            return *this = static_cast<const Eigen::EigenBase<Array>&>(rhs);
+
         array_ = std::move(rhs);
         rows_ = array_.rows();
         return *this;
     }
 
 
-    auto operator*() noexcept
-    { return array_.topRows(rows_); }
+    auto operator*() noexcept -> View
+    { return View{data(), rows_, cols(), Eigen::OuterStride<>{stride()}}; }
 
-    auto operator*() const noexcept
-    { return array_.topRows(rows_); }
+    auto operator*() const noexcept -> ConstView
+    {
+        return ConstView{
+            data(), rows_, cols(), Eigen::OuterStride<>{stride()}};
+    }
 
     auto rows() const noexcept -> Index
     { return rows_; }
 
     auto cols() const noexcept -> Index
-    { return array_.cols(); }
+    { return bound_data_ ? bound_cols_ : array_.cols(); }
 
     auto size() const noexcept -> Index
     { return rows() * cols(); }
 
+    auto bound() const noexcept -> bool
+    { return bound_data_ != nullptr; }
+
+
+    // Change the shape without preserving the contents, e.g., for buffers.
+    // The storage is only reallocated if it is too small. Bound caches
+    // fall back to their own storage if the columns do not fit.
+    void resize(Index rows, Index cols)
+    {
+        if(bound_data_ and (cols != bound_cols_ or rows > bound_rows_))
+            bound_data_ = nullptr;
+
+        if(!bound_data_ and (cols != array_.cols() or rows > array_.rows()))
+            array_.resize(padded_rows(rows), cols);
 
+        rows_ = rows;
+    }
+
+    // Filtering an empty cache is a no-op, since there is nothing cached yet.
     void filter_rows(const Booleans& predicate)
     {
+        if(rows_ == 0)
+            return;
+
         expect(rows_ == predicate.size(),
             "The predicate size must match the number of rows.");
 
-        auto block = **this;
-        Index write{0};
+        // The owner of bound columns has already moved the rows.
+        rows_ = bound_data_
+            ? predicate.count()
+            : compress_rows(**this, RowMask{predicate});
+    }
+
+    // Move rows [first, rows()) into a new cache and drop them from this one.
+    // Like filtering, splitting an empty cache yields two empty caches,
+    // e.g., if the states are split before the first step.
+    [[nodiscard]]
+    auto split_rows(Index first) -> Cache
+    {
+        if(bound_data_)
+        {
+            expect(0 <= first and first <= bound_rows_,
+                "The split point must not exceed the number of rows.");
+
+            Cache tail{*this};
+            tail.bound_data_ += first;
+            tail.bound_rows_ -= first;
+            tail.rows_ = rows_ == 0 ? 0 : rows_ - first;
+            bound_rows_ = first;
+            rows_ = std::min(rows_, first);
+            return tail;
+        }
+
+        if(rows_ == 0)
+            return Cache{};
+
+        expect(0 <= first and first <= rows_,
+            "The split point must not exceed the number of rows.");
 
-        for(;; ++write)
+        Cache tail{};
+        tail = (**this).bottomRows(rows_ - first);
+        rows_ = first;
+        return tail;
+    }
+
+    // Append the rows of a cache that was split off this one, or off a copy.
+    // Unless both caches are filled, there is nothing consistent to keep,
+    // so the joined cache is empty.
+    void join_rows(Cache&& tail)
+    {
+        const bool adjacent = bound_data_
+            and tail.bound_data_ == bound_data_ + bound_rows_
+            and tail.bound_stride_ == bound_stride_;
+        if(adjacent)
         {
-            for(;; ++write)
-            {
-                if(write == rows_)
-                    return;
-                if(!predicate[write])
-                    break;
-            }
-
-            do
-            {
-                if(write == --rows_)
-                    return;
-            }
-            while(!predicate[rows_]);
-
-            block.row(write) = block.row(rows_);
+            const bool filled = rows_ == bound_rows_
+                and tail.rows_ == tail.bound_rows_;
+            rows_ = filled ? rows_ + tail.rows_ : 0;
+            bound_rows_ += tail.bound_rows_;
+            return;
         }
+
+        if(rows_ == 0 or tail.rows_ == 0)
+            return reset();
+
+        expect(cols() == tail.cols(),
+            "The number of columns of joined caches must match.");
+
+        Array joined{padded_rows(rows_ + tail.rows_), cols()};
+        joined.topRows(rows_) = **this;
+        joined.middleRows(rows_, tail.rows_) = *tail;
+        rows_ += tail.rows_;
+        bound_data_ = nullptr;
+        array_ = std::move(joined);
     }
 
+    // Store the rows in the given columns from now on. Cached rows, if any,
+    // are copied over and have to match the columns.
+    void bind(Eigen::Ref<Array> columns)
+    {
+        expect(rows_ == 0
+                or (rows_ == columns.rows() and cols() == columns.cols()),
+            "Size of the bound columns is incompatible with the cache. "
+            "Did you forget to call reset() or filter_states()?");
+
+        if(rows_ != 0)
+            columns = **this;
+
+        bound_data_ = columns.data();
+        bound_rows_ = columns.rows();
+        bound_cols_ = columns.cols();
+        bound_stride_ = columns.outerStride();
+        array_ = Array{};
+    }
+
+    // Copy the rows back into storage owned by the cache.
+    void unbind()
+    {
+        if(!bound_data_)
+            return;
+
+        Array own{padded_rows(rows_), bound_cols_};
+        own.topRows(rows_) = **this;
+        bound_data_ = nullptr;
+        array_ = std::move(own);
+    }
+
+    // Bound caches stay bound, but no longer contain any rows.
     void reset()
-    { *this = Array{}; }
+    {
+        if(bound_data_)
+            rows_ = 0;
+        else
+            *this = Array{};
+    }
+
+
+private:
+    auto data() noexcept -> Scalar*
+    { return bound_data_ ? bound_data_ : array_.data(); }
+
+    auto data() const noexcept -> const Scalar*
+    { return bound_data_ ? bound_data_ : array_.data(); }
+
+    auto stride() const noexcept -> Index
+    { return bound_data_ ? bound_stride_ : array_.outerStride(); }
 
 
 private:
     Array array_{};
     Index rows_{0};
+    // Columns owned by someone else, see bind().
+    Scalar* bound_data_{nullptr};
+    Index bound_rows_{0};
+    Index bound_cols_{0};
+    Index bound_stride_{0};
 };
 
 } // namespace mfptlib
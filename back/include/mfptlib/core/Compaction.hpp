@@ -0,0 +1,62 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef MFPTLIB_CORE_COMPACTION_HPP
+#define MFPTLIB_CORE_COMPACTION_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <mfptlib/core/Types.hpp>
+
+
+namespace mfptlib {
+
+// Packed representation of a row predicate with one bit per row.
+class RowMask
+{
+public:
+    using Word = std::uint64_t;
+    static constexpr Index WordBits = 64;
+
+
+public:
+    explicit RowMask(const Booleans& predicate);
+
+    auto size() const noexcept -> Index
+    { return size_; }
+
+    auto count() const noexcept -> Index
+    { return count_; }
+
+    auto words() const noexcept -> const Word*
+    { return words_.data(); }
+
+    auto operator[](Index row) const noexcept -> bool
+    { return (words_[std::size_t(row / WordBits)] >> (row % WordBits)) & 1u; }
+
+
+private:
+    std::vector<Word> words_;
+    Index size_;
+    Index count_;
+};
+
+
+// Move all rows selected by the mask to the top of the array,
+// preserving their relative order, and return their number.
+// The contents of the remaining rows are unspecified.
+auto compress_rows(VectorsRef array, const RowMask& mask) -> Index;
+
+// Stable partition: rows selected by the mask are moved to the top,
+// all other rows to the bottom, preserving the relative order in both parts.
+auto partition_rows(VectorsRef array, const RowMask& mask) -> Index;
+auto partition_rows(IndicesRef array, const RowMask& mask) -> Index;
+
+// Move row i to row order[i] in a single scatter pass per column.
+void scatter_rows(VectorsRef array, const Indices& order);
+
+} // namespace mfptlib
+
+#endif
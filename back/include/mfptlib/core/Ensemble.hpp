@@ -0,0 +1,88 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef MFPTLIB_CORE_ENSEMBLE_HPP
+#define MFPTLIB_CORE_ENSEMBLE_HPP
+
+#include <utility>
+
+#include <mfptlib/core/Errors.hpp>
+#include <mfptlib/core/Types.hpp>
+
+
+namespace mfptlib {
+
+// States of an ensemble together with auxiliary columns per state, e.g.,
+// labels or parameters of the trajectories, in a single allocation.
+// The states occupy the first columns and the auxiliary columns follow in
+// the order they were added. Rows are only ever moved as a whole, so that
+// all columns of a row keep belonging to the same trajectory.
+// During propagate_while(), further columns hold the original index of
+// every state and the per-state data that steppers and baths bind to the
+// ensemble (see Stepper::bind_columns()), so that a compaction moves all
+// of them in a single pass. They are removed again afterwards.
+class Ensemble
+{
+public:
+    explicit Ensemble(Vectors states) noexcept
+        : data_{std::move(states)}
+        , state_cols_{data_.cols()}
+    {}
+
+    // Append cols auxiliary columns initialized to value and return the
+    // index of the first one, which can be passed to columns().
+    auto add_columns(Index cols, double value = 0.0) -> Index
+    {
+        expect(cols >= 0, "The number of columns must be >= 0.");
+
+        const Index first = data_.cols();
+        data_.conservativeResize(Eigen::NoChange, first + cols);
+        data_.rightCols(cols).setConstant(value);
+        return first;
+    }
+
+    // Drop the auxiliary columns from first on.
+    void remove_columns(Index first)
+    {
+        expect(state_cols_ <= first and first <= data_.cols(),
+            "Only auxiliary columns can be removed.");
+
+        data_.conservativeResize(Eigen::NoChange, first);
+    }
+
+    auto rows() const noexcept -> Index
+    { return data_.rows(); }
+
+    auto state_cols() const noexcept -> Index
+    { return state_cols_; }
+
+    auto states() noexcept
+    { return data_.leftCols(state_cols_); }
+
+    auto states() const noexcept
+    { return data_.leftCols(state_cols_); }
+
+    auto columns(Index first, Index cols) noexcept
+    { return data_.middleCols(first, cols); }
+
+    auto columns(Index first, Index cols) const noexcept
+    { return data_.middleCols(first, cols); }
+
+    // States followed by all auxiliary columns. The view cannot be resized,
+    // use add_columns() to append columns.
+    auto data() noexcept -> VectorsRef
+    { return data_; }
+
+    auto data() const noexcept -> VectorsCRef
+    { return data_; }
+
+
+private:
+    Vectors data_;
+    Index state_cols_;
+};
+
+} // namespace mfptlib
+
+#endif
@@ -0,0 +1,41 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef MFPTLIB_CORE_MAPPEDFILE_HPP
+#define MFPTLIB_CORE_MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+
+
+namespace mfptlib {
+
+// Read-only memory mapping of a whole file.
+// Copies share the mapping, which is released together with the last copy
+// or the last pointer obtained from bytes().
+class MappedFile
+{
+public:
+    // Throws std::runtime_error if the file cannot be opened or mapped.
+    explicit MappedFile(const std::filesystem::path& path);
+
+    auto bytes() const noexcept -> const std::shared_ptr<const std::byte>&
+    { return bytes_; }
+
+    auto data() const noexcept -> const std::byte*
+    { return bytes_.get(); }
+
+    auto size() const noexcept -> std::size_t
+    { return size_; }
+
+
+private:
+    std::shared_ptr<const std::byte> bytes_{};
+    std::size_t size_{0};
+};
+
+} // namespace mfptlib
+
+#endif
@@ -0,0 +1,75 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef MFPTLIB_CORE_STATEPARAMETERS_HPP
+#define MFPTLIB_CORE_STATEPARAMETERS_HPP
+
+#include <memory>
+#include <utility>
+
+#include <mfptlib/core/Cache.hpp>
+#include <mfptlib/core/Types.hpp>
+
+
+namespace mfptlib {
+
+// Parameters with one row per state, e.g., to sweep over a parameter grid
+// in a single ensemble. Like the rows of a Cache, they follow the states
+// through filter_rows(), split_rows(), and join_rows(), and reset()
+// restores all of them.
+// Default-constructed parameters are empty, i.e., shared by all states.
+class StateParameters
+{
+public:
+    explicit StateParameters() noexcept = default;
+
+    explicit StateParameters(Vectors values)
+        : all_{std::make_shared<const Vectors>(std::move(values))}
+    { reset(); }
+
+    auto empty() const noexcept -> bool
+    { return all_ == nullptr; }
+
+    auto operator*() const noexcept
+    { return *rows_; }
+
+    auto rows() const noexcept -> Index
+    { return rows_.rows(); }
+
+    auto cols() const noexcept -> Index
+    { return all_ ? all_->cols() : 0; }
+
+    void filter_rows(const Booleans& predicate)
+    { rows_.filter_rows(predicate); }
+
+    [[nodiscard]]
+    auto split_rows(Index first) -> StateParameters
+    {
+        StateParameters tail{};
+        if(empty())
+            return tail;
+
+        tail.all_ = all_;
+        tail.rows_ = rows_.split_rows(first);
+        return tail;
+    }
+
+    void join_rows(StateParameters&& tail)
+    { rows_.join_rows(std::move(tail.rows_)); }
+
+    void reset()
+    {
+        if(all_)
+            rows_ = *all_;
+    }
+
+
+private:
+    std::shared_ptr<const Vectors> all_{};
+    Cache<Vectors> rows_{};
+};
+
+} // namespace mfptlib
+
+#endif
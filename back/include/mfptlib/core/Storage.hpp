@@ -0,0 +1,140 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef MFPTLIB_CORE_STORAGE_HPP
+#define MFPTLIB_CORE_STORAGE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include <Eigen/Dense>
+
+#include <mfptlib/core/Errors.hpp>
+#include <mfptlib/core/Types.hpp>
+
+
+namespace mfptlib {
+
+// Rows are allocated in blocks of this size, matching 512-bit SIMD registers.
+inline constexpr Index BlockRows = 8;
+
+// Alignment of every column of padded storage in bytes.
+inline constexpr std::size_t StorageAlignment = 64;
+
+
+constexpr auto padded_rows(Index rows) noexcept -> Index
+{ return (rows + BlockRows - 1) / BlockRows * BlockRows; }
+
+
+// Column-major storage for states with the leading dimension padded to a
+// multiple of BlockRows and every column aligned to StorageAlignment bytes,
+// for callers that want their states to start on cache-line boundaries.
+// The padding rows are zero-initialized and never part of view(), so the
+// storage can be passed as VectorsRef to steppers, baths, and systems.
+// These treat it like any other strided states: they neither rely on the
+// alignment nor touch the padding rows, and the last rows of a column that
+// do not fill a SIMD register are processed as for unpadded states.
+class PaddedVectors
+{
+public:
+    using View = Eigen::Map<Vectors, Eigen::Aligned64, Eigen::OuterStride<>>;
+    using ConstView =
+        Eigen::Map<const Vectors, Eigen::Aligned64, Eigen::OuterStride<>>;
+
+
+public:
+    PaddedVectors() noexcept = default;
+
+    PaddedVectors(Index rows, Index cols)
+    {
+        expect(rows >= 0 and cols >= 0, "The size must not be negative.");
+
+        rows_ = rows;
+        cols_ = cols;
+        stride_ = padded_rows(rows);
+        data_ = allocate(stride_ * cols);
+        padded().setZero();
+    }
+
+    explicit PaddedVectors(const VectorsCRef& states)
+        : PaddedVectors(states.rows(), states.cols())
+    { view() = states; }
+
+    PaddedVectors(const PaddedVectors& rhs)
+        : PaddedVectors(rhs.rows_, rhs.cols_)
+    { std::copy_n(rhs.data(), stride_ * cols_, data()); }
+
+    PaddedVectors(PaddedVectors&& rhs) noexcept = default;
+
+    auto operator=(const PaddedVectors& rhs) -> PaddedVectors&
+    { return *this = PaddedVectors{rhs}; }
+
+    auto operator=(PaddedVectors&& rhs) noexcept -> PaddedVectors& = default;
+
+
+    auto rows() const noexcept -> Index
+    { return rows_; }
+
+    auto cols() const noexcept -> Index
+    { return cols_; }
+
+    // Distance between the starts of two adjacent columns.
+    auto stride() const noexcept -> Index
+    { return stride_; }
+
+    auto data() noexcept -> double*
+    { return data_.get(); }
+
+    auto data() const noexcept -> const double*
+    { return data_.get(); }
+
+
+    auto view() noexcept -> View
+    { return View{data(), rows_, cols_, Eigen::OuterStride<>{stride_}}; }
+
+    auto view() const noexcept -> ConstView
+    { return ConstView{data(), rows_, cols_, Eigen::OuterStride<>{stride_}}; }
+
+    // The states including the padding rows.
+    auto padded() noexcept -> View
+    { return View{data(), stride_, cols_, Eigen::OuterStride<>{stride_}}; }
+
+    auto padded() const noexcept -> ConstView
+    { return ConstView{data(), stride_, cols_, Eigen::OuterStride<>{stride_}}; }
+
+    operator VectorsRef() noexcept
+    { return VectorsRef{view()}; }
+
+    operator VectorsCRef() const noexcept
+    { return VectorsCRef{view()}; }
+
+
+private:
+    struct Deleter
+    {
+        void operator()(double* ptr) const noexcept
+        { ::operator delete[](ptr, std::align_val_t{StorageAlignment}); }
+    };
+
+    static auto allocate(Index size) -> std::unique_ptr<double[], Deleter>
+    {
+        const auto bytes = sizeof(double) * static_cast<std::size_t>(size);
+        return std::unique_ptr<double[], Deleter>{static_cast<double*>(
+            ::operator new[](bytes, std::align_val_t{StorageAlignment}))};
+    }
+
+
+private:
+    Index rows_{0};
+    Index cols_{0};
+    Index stride_{0};
+    std::unique_ptr<double[], Deleter> data_{};
+};
+
+} // namespace mfptlib
+
+#endif
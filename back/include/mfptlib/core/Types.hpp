@@ -28,21 +28,43 @@ using Scalars = Eigen::ArrayXd;
 using ScalarsRef = Eigen::Ref<Scalars>;
 using ScalarsCRef = Eigen::Ref<const Scalars>;
 using Indices = Eigen::ArrayX<Index>;
+using IndicesRef = Eigen::Ref<Indices>;
 using Booleans = Eigen::ArrayX<bool>;
 
+// Vectors with a number of columns known at compile time, which lets Eigen
+// unroll the loops over the columns. FixedVectors<Eigen::Dynamic> is Vectors.
+template<int Cols>
+using FixedVectors = Eigen::Array<double, Eigen::Dynamic, Cols>;
+template<int Cols>
+using FixedVectorsRef = Eigen::Ref<FixedVectors<Cols>>;
+template<int Cols>
+using FixedVectorsCRef = Eigen::Ref<const FixedVectors<Cols>>;
+
+// Number of columns of the positions or momenta of states with Cols columns.
+template<int Cols>
+constexpr int HalfCols = Cols == Eigen::Dynamic ? Eigen::Dynamic : Cols / 2;
+
 
 template<typename Array>
 auto positions(Array&& states) noexcept -> decltype(auto)
 {
+    constexpr int cols = HalfCols<std::decay_t<Array>::ColsAtCompileTime>;
     assert(states.cols() % 2 == 0);
-    return std::forward<Array>(states).leftCols(states.cols() / 2);
+    if constexpr(cols != Eigen::Dynamic)
+        return std::forward<Array>(states).template leftCols<cols>();
+    else
+        return std::forward<Array>(states).leftCols(states.cols() / 2);
 }
 
 template<typename Array>
 auto momenta(Array&& states) noexcept -> decltype(auto)
 {
+    constexpr int cols = HalfCols<std::decay_t<Array>::ColsAtCompileTime>;
     assert(states.cols() % 2 == 0);
-    return std::forward<Array>(states).rightCols(states.cols() / 2);
+    if constexpr(cols != Eigen::Dynamic)
+        return std::forward<Array>(states).template rightCols<cols>();
+    else
+        return std::forward<Array>(states).rightCols(states.cols() / 2);
 }
 
 
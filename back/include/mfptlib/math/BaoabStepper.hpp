@@ -7,6 +7,7 @@
 
 #include <utility>
 
+#include <mfptlib/core/Cache.hpp>
 #include <mfptlib/core/Errors.hpp>
 #include <mfptlib/core/Types.hpp>
 #include <mfptlib/math/Bath.hpp>
@@ -24,11 +25,143 @@ class BaoabStepper
 
     void step(Bath& bath, const System& system, VectorsRef states, double& t);
 
+    // Statically dispatched version for concrete baths and systems.
+    // States with a fixed number of columns unroll the loops over the DoFs.
+    template<typename BathT, typename SystemT, int Cols>
+    void step(
+        BathT& bath,
+        const SystemT& system,
+        FixedVectorsRef<Cols> states,
+        double& t
+    );
+
+    // Forces from (B2) are only reused between these calls, i.e., within a
+    // single propagation, but never by manual calls to step().
+    void begin_propagation() noexcept
+    {
+        reuse_armed_ = true;
+        force_system_ = nullptr;
+    }
+
+    void end_propagation() noexcept
+    {
+        reuse_armed_ = false;
+        force_system_ = nullptr;
+    }
+
+    void filter_states(const Booleans&) noexcept
+    { force_system_ = nullptr; }
+
+    void reset() noexcept
+    { force_system_ = nullptr; }
+
+    [[nodiscard]]
+    auto split_states(Index) -> BaoabStepper
+    {
+        force_system_ = nullptr;
+        BaoabStepper split{dt_};
+        split.reuse_armed_ = reuse_armed_;
+        return split;
+    }
+
+
+private:
+    // Whether force_ holds the forces of system from the previous step.
+    auto has_force(const void* system, Index rows) const noexcept -> bool
+    {
+        return reuse_armed_
+            and system == force_system_
+            and force_step_ == steps_
+            and force_.rows() == rows;
+    }
+
 
 private:
     double dt_;
+    // Buffers reused between steps to avoid allocations.
+    Cache<Vectors> force_;
+    Cache<Vectors> masses_;
+    // Number of started steps. Only the step after the one that computed
+    // the forces of (B2) may reuse them, which also excludes steps that
+    // were interrupted by an exception.
+    Index steps_{0};
+    Index force_step_{-1};
+    // System of the forces from the last (B2), if reusable.
+    const void* force_system_{nullptr};
+    bool reuse_armed_{false};
 };
 
+
+/**
+ * Langevin BAOAB integrator:
+ *
+ * ζ = √[k_B T (1 - e^{-2γh})]
+ * R_n is standard normally-distributed random variable (μ = 0, σ = 1)
+ * p_{n + 1/4} = p_n + h/2 * F(q_n)                                         (B1)
+ * q_{n + 1/2} = q_n + h/2 M^{-1} p_{n + 1/4}                               (A1)
+ * p_{n + 3/4} = e^{-hγ} p_{n + 1/4} + ζ M^{1/2} R_n                        (O)
+ * q_{n + 1} = q_{n + 1/2} + h/2 M^{-1} p_{n + 3/4}                         (A2)
+ * p_{n + 1} = p_{n + 3/4} + h/2 F(q_{n + 1})                               (B2)
+ *
+ * Within a propagation, the forces from (B2) are reused in (B1) of the next
+ * step if the system declares velocity- and time-independent forces. The
+ * reuse ends with the propagation and whenever the states are filtered,
+ * split or reset. Manual calls to step() always evaluate both forces.
+ * Masses are evaluated once per step if they are constant.
+ *
+ * References:
+ * - Leimkuhler et al., Molecular Dynamics (2015):
+ *   https://doi.org/10.1007/978-3-319-16375-8
+ * - Fass et al., Entropy 20(5), 318 (2018):
+ *   https://doi.org/10.3390/e20050318
+ */
+template<typename BathT, typename SystemT, int Cols>
+void BaoabStepper::step(
+    BathT& bath,
+    const SystemT& system,
+    FixedVectorsRef<Cols> states,
+    double& t
+)
+{
+    using DofVectorsRef = FixedVectorsRef<HalfCols<Cols>>;
+    const double half_dt = 0.5 * dt_;
+    const SystemTraits traits = system_traits(system);
+    DofVectorsRef q = positions(states);
+    DofVectorsRef p = momenta(states);
+    masses_.resize(p.rows(), p.cols());
+
+    const bool reuse_force = traits.velocity_independent_forces
+        and traits.time_independent_potential;
+    if(!reuse_force or !has_force(&system, q.rows()))
+    {
+        force_.resize(p.rows(), p.cols());
+        force_into(system, states, t, *force_);
+    }
+    ++steps_;
+    DofVectorsRef force = *force_;
+    DofVectorsRef mass = *masses_;
+
+    p += half_dt * force;                                                // (B1)
+    masses_into(system, states, mass);
+    q += half_dt * p / mass;                                             // (A1)
+    if(!traits.constant_masses)
+        masses_into(system, states, mass);
+    bath.apply_forces(p, mass, dt_);                                     // (O)
+    if(!traits.constant_masses)
+        masses_into(system, states, mass);
+    q += half_dt * p / mass;                                             // (A2)
+    force_into(system, states, t, force);
+    p += half_dt * force;                                                // (B2)
+
+    if(reuse_force)
+    {
+        force_step_ = steps_;
+        force_system_ = &system;
+    }
+
+    t += dt_;
+}
+
 } // namespace mfptlib
 
 #endif
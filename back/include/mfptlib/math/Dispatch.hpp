@@ -0,0 +1,45 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef MFPTLIB_MATH_DISPATCH_HPP
+#define MFPTLIB_MATH_DISPATCH_HPP
+
+#include <optional>
+
+#include <mfptlib/core/Types.hpp>
+#include <mfptlib/math/Bath.hpp>
+#include <mfptlib/math/Observer.hpp>
+#include <mfptlib/math/Predicate.hpp>
+#include <mfptlib/math/Stepper.hpp>
+#include <mfptlib/sys/System.hpp>
+
+
+namespace mfptlib {
+
+// Registry of precompiled kernels from Kernel.hpp for all combinations of
+// the built-in steppers, baths, and systems.
+
+// Whether the wrapped implementations form a precompiled combination.
+auto has_static_kernel(
+    const Stepper& stepper, const Bath& bath, const System& system
+) noexcept -> bool;
+
+// Run the precompiled kernel if there is one, or return std::nullopt.
+auto dispatch_propagate_to(
+    Stepper& stepper, Bath& bath, const System& system,
+    VectorsRef states, double t, double t_end,
+    const Observer& observe
+) -> std::optional<double>;
+
+// The states are the first state_cols columns of data, followed by
+// auxiliary columns, of which column order_col holds the original indices.
+auto dispatch_propagate_while(
+    Stepper& stepper, Bath& bath, const System& system,
+    VectorsRef data, Index state_cols, Index order_col, double t,
+    const Predicate& predicate, const Observer& observe
+) -> std::optional<Scalars>;
+
+} // namespace mfptlib
+
+#endif
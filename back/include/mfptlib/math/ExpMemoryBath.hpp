@@ -6,12 +6,13 @@
 #define MFPTLIB_MATH_EXPMEMORYBATH_HPP
 
 #include <cmath>
-
-#include <pcg_random.hpp>
+#include <utility>
 
 #include <mfptlib/core/Cache.hpp>
 #include <mfptlib/core/Errors.hpp>
+#include <mfptlib/core/StateParameters.hpp>
 #include <mfptlib/core/Types.hpp>
+#include <mfptlib/math/NoiseSource.hpp>
 
 
 namespace mfptlib {
@@ -19,32 +20,102 @@ namespace mfptlib {
 class ExpMemoryBath
 {
 public:
-    explicit ExpMemoryBath(double kb_t, double friction, double memory, Seed seed)
+    explicit ExpMemoryBath(
+        double kb_t,
+        double friction,
+        double memory,
+        Seed seed,
+        NoiseGenerator generator = NoiseGenerator::Vectorized
+    )
+        : ExpMemoryBath{kb_t, friction, memory, NoiseSource{seed, generator}}
+    {}
+
+    explicit ExpMemoryBath(
+        double kb_t, double friction, double memory, NoiseSource noise
+    )
         : noise_{std::sqrt(2 * kb_t * friction)}
         , friction_{friction}
         , memory_{memory}
-        , rng_{seed}
+        , noise_source_{std::move(noise)}
     {
         expect(kb_t >= 0.0, "The temperature kb_t must be >= 0.");
         expect(friction >= 0.0, "The friction must be >= 0.");
         expect(memory >= 0.0, "The memory parameter must be >= 0.");
     }
 
+    // Temperature, friction, and memory parameter per state, which have to
+    // match the ensemble and are compacted with it.
+    explicit ExpMemoryBath(
+        Scalars kb_t, Scalars friction, Scalars memory, NoiseSource noise);
+
     void apply_forces(VectorsRef momenta, const VectorsCRef& masses, double dt);
 
     void filter_states(const Booleans& predicate)
-    { force_.filter_rows(predicate); }
+    {
+        force_.filter_rows(predicate);
+        parameters_.filter_rows(predicate);
+        noise_source_.filter_states(predicate);
+    }
+
+    void reset()
+    {
+        force_.reset();
+        parameters_.reset();
+        noise_source_.reset();
+    }
+
+    [[nodiscard]]
+    auto split_states(Index first) -> ExpMemoryBath
+    {
+        ExpMemoryBath split{*this};
+        split.noise_source_ = noise_source_.split_states(first);
+        split.force_ = force_.split_rows(first);
+        split.parameters_ = parameters_.split_rows(first);
+        return split;
+    }
 
-    void reset() noexcept
-    { force_.reset(); }
+    void join_states(ExpMemoryBath&& tail)
+    {
+        noise_source_.join_states(std::move(tail.noise_source_));
+        force_.join_rows(std::move(tail.force_));
+        parameters_.join_rows(std::move(tail.parameters_));
+    }
+
+    // The auxiliary force can be stored in an Ensemble.
+    auto state_columns(Index dofs) const noexcept -> Index
+    { return dofs; }
+
+    void bind_columns(VectorsRef columns)
+    { force_.bind(std::move(columns)); }
+
+    void unbind_columns()
+    { force_.unbind(); }
+
+    [[nodiscard]]
+    auto fork() -> ExpMemoryBath
+    {
+        ExpMemoryBath forked{*this};
+        forked.noise_source_ = noise_source_.fork();
+        forked.reset();
+        return forked;
+    }
+
+
+private:
+    void apply_state_forces(
+        VectorsRef momenta, const VectorsCRef& masses, double dt);
 
 
 private:
     double noise_;
     double friction_;
     double memory_;
-    pcg64_oneseq rng_;
+    // Columns √(2 kb_t friction), friction, and memory if given per state.
+    StateParameters parameters_{};
+    NoiseSource noise_source_;
     Cache<Vectors> force_{};
+    Cache<Vectors> random_{};
+    Cache<Vectors> scales_{};
 };
 
 } // namespace mfptlib
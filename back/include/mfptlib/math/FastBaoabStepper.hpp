@@ -26,18 +26,119 @@ class FastBaoabStepper
 
     void step(Bath& bath, const System& system, VectorsRef states, double& t);
 
+    // Statically dispatched version for concrete baths and systems.
+    // States with a fixed number of columns unroll the loops over the DoFs.
+    template<typename BathT, typename SystemT, int Cols>
+    void step(
+        BathT& bath,
+        const SystemT& system,
+        FixedVectorsRef<Cols> states,
+        double& t
+    );
+
     void filter_states(const Booleans& predicate)
     { force_.filter_rows(predicate); }
 
     void reset() noexcept
     { force_.reset(); }
 
+    [[nodiscard]]
+    auto split_states(Index first) -> FastBaoabStepper
+    {
+        FastBaoabStepper split{dt_};
+        split.force_ = force_.split_rows(first);
+        return split;
+    }
+
+    void join_states(FastBaoabStepper&& tail)
+    { force_.join_rows(std::move(tail.force_)); }
+
+    // The cached forces can be stored in an Ensemble.
+    auto state_columns(Index dofs) const noexcept -> Index
+    { return dofs; }
+
+    void bind_columns(VectorsRef columns)
+    { force_.bind(std::move(columns)); }
+
+    void unbind_columns()
+    { force_.unbind(); }
+
 
 private:
     double dt_;
     Cache<Vectors> force_;
+    // Buffer reused between steps to avoid allocations.
+    Cache<Vectors> masses_;
 };
 
+
+/**
+ * Langevin BAOAB integrator:
+ *
+ * ζ = √[k_B T (1 - e^{-2γh})]
+ * R_n is standard normally-distributed random variable (μ = 0, σ = 1)
+ * p_{n + 1/4} = p_n + h/2 * F(q_n)                                         (B1)
+ * q_{n + 1/2} = q_n + h/2 M^{-1} p_{n + 1/4}                               (A1)
+ * p_{n + 3/4} = e^{-hγ} p_{n + 1/4} + ζ M^{1/2} R_n                        (O)
+ * q_{n + 1} = q_{n + 1/2} + h/2 M^{-1} p_{n + 3/4}                         (A2)
+ * p_{n + 1} = p_{n + 3/4} + h/2 F(q_{n + 1})                               (B2)
+ *
+ * This version caches the forces evaluated in (B2) for use in (B1).
+ *
+ * References:
+ * - Leimkuhler et al., Molecular Dynamics (2015):
+ *   https://doi.org/10.1007/978-3-319-16375-8
+ * - Fass et al., Entropy 20(5), 318 (2018):
+ *   https://doi.org/10.3390/e20050318
+ */
+template<typename BathT, typename SystemT, int Cols>
+void FastBaoabStepper::step(
+    BathT& bath,
+    const SystemT& system,
+    FixedVectorsRef<Cols> states,
+    double& t
+)
+{
+    using DofVectorsRef = FixedVectorsRef<HalfCols<Cols>>;
+    const double half_dt = 0.5 * dt_;
+    const SystemTraits traits = system_traits(system);
+    DofVectorsRef q = positions(states);
+    DofVectorsRef p = momenta(states);
+    masses_.resize(p.rows(), p.cols());
+
+    if(force_.rows() == 0)
+    {
+        force_.resize(p.rows(), p.cols());
+        force_into(system, states, t, *force_);
+        *force_ *= half_dt;
+    }
+    else
+    {
+        expect(
+            force_.rows() == p.rows() and force_.cols() == p.cols(),
+            "Size of the passed states is incompatible with the cached forces. "
+            "Did you forget to call Stepper.reset() or Stepper.filter_states()?"
+        );
+    }
+    DofVectorsRef force = *force_;
+    DofVectorsRef mass = *masses_;
+
+    p += force;                                                          // (B1)
+    masses_into(system, states, mass);
+    q += half_dt * p / mass;                                             // (A1)
+    if(!traits.constant_masses)
+        masses_into(system, states, mass);
+    bath.apply_forces(p, mass, dt_);                                     // (O)
+    if(!traits.constant_masses)
+        masses_into(system, states, mass);
+    q += half_dt * p / mass;                                             // (A2)
+    force_into(system, states, t, force);
+    force *= half_dt;
+    p += force;                                                          // (B2)
+
+    t += dt_;
+}
+
 } // namespace mfptlib
 
 #endif
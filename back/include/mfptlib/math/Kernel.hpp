@@ -0,0 +1,159 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef MFPTLIB_MATH_KERNEL_HPP
+#define MFPTLIB_MATH_KERNEL_HPP
+
+#include <concepts>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include <mfptlib/core/Errors.hpp>
+#include <mfptlib/core/Types.hpp>
+#include <mfptlib/math/Observer.hpp>
+#include <mfptlib/math/Predicate.hpp>
+#include <mfptlib/math/Propagate.hpp>
+#include <mfptlib/sys/System.hpp>
+
+
+namespace mfptlib {
+
+namespace detail {
+
+template<typename Impl>
+void filter_impl_states(Impl& impl, const Booleans& predicate)
+{
+    if constexpr(requires{ impl.filter_states(predicate); })
+        impl.filter_states(predicate);
+}
+
+
+// Systems with parameters per state are immutable, so the filtered system
+// is kept in filtered and system points to it afterwards.
+template<typename SystemImpl>
+void filter_system_states(
+    const SystemImpl*& system, std::optional<SystemImpl>& filtered,
+    const Booleans& predicate
+)
+{
+    if constexpr(requires{
+        { filter_states(*system, predicate) } -> std::same_as<SystemImpl>; })
+    {
+        filtered.emplace(filter_states(*system, predicate));
+        system = &*filtered;
+    }
+}
+
+
+// Call func with std::integral_constant<int, Cols>, where Cols is the
+// number of state columns if the DoFs of system are listed in
+// UnrolledDegreesOfFreedom and Eigen::Dynamic otherwise.
+template<typename SystemImpl, typename Func>
+void visit_state_cols(const SystemImpl& system, Func&& func)
+{
+    const Index dofs = degrees_of_freedom(system);
+    const bool fixed = [&]<int... Dofs>(std::integer_sequence<int, Dofs...>)
+    {
+        return (... or (dofs == Dofs
+            and (func(std::integral_constant<int, 2 * Dofs>{}), true)));
+    }(UnrolledDegreesOfFreedom<SystemImpl>);
+
+    if(!fixed)
+        func(std::integral_constant<int, Eigen::Dynamic>{});
+}
+
+} // namespace detail
+
+
+// Statically dispatched, single-threaded counterparts of propagate_to() and
+// propagate_while() for concrete stepper, bath, and system implementations.
+// The sizes are validated once before the loop and the stepper calls the
+// bath and the system directly, so that they can be inlined. Systems with
+// few DoFs are stepped with states of a fixed number of columns.
+
+template<typename StepperImpl, typename BathImpl, typename SystemImpl>
+auto propagate_to(
+    StepperImpl& stepper, BathImpl& bath, const SystemImpl& system,
+    VectorsRef states, double t, double t_end,
+    const Observer& observe
+) -> double
+{
+    expect(t <= t_end, "Final time t_end must not precede initial time t.");
+    validate_size(system, states, StateType::Full);
+
+    detail::visit_state_cols(system, [&](auto cols)
+    {
+        using StatesRef = FixedVectorsRef<decltype(cols)::value>;
+        const StatesRef fixed_states = states;
+
+        observe(states, t);
+        while(t < t_end)
+        {
+            stepper.step(bath, system, fixed_states, t);
+            observe(states, t);
+        }
+    });
+
+    return t;
+}
+
+
+// The states are the first state_cols columns of data, and column order_col
+// records their original indices. All columns are moved along with the
+// states, as for propagate_while() with an Ensemble.
+template<typename StepperImpl, typename BathImpl, typename SystemImpl>
+auto propagate_while(
+    StepperImpl& stepper, BathImpl& bath, const SystemImpl& system,
+    VectorsRef data, Index state_cols, Index order_col, double t,
+    const Predicate& predicate, const Observer& observe
+) -> Scalars
+{
+    auto states = data.leftCols(state_cols);
+    validate_size(system, states, StateType::Full);
+
+    Scalars t_end{data.rows()};
+    Index rows = data.rows();
+    const SystemImpl* active_system = &system;
+    std::optional<SystemImpl> filtered_system{};
+
+    detail::visit_state_cols(system, [&](auto cols)
+    {
+        using StatesRef = FixedVectorsRef<decltype(cols)::value>;
+
+        observe(states, t);
+        while(rows > 0)
+        {
+            const Booleans keep_running = predicate(states.topRows(rows), t);
+            for(Index i = 0; i < rows; ++i)
+                if(!keep_running[i])
+                    t_end[static_cast<Index>(data(i, order_col))] = t;
+
+            const Index stop = detail::partition_record(
+                data.topRows(rows), keep_running);
+            if(stop == 0)
+                break;
+            else if(stop != rows)
+            {
+                detail::filter_impl_states(stepper, keep_running);
+                detail::filter_impl_states(bath, keep_running);
+                detail::filter_system_states(
+                    active_system, filtered_system, keep_running);
+                rows = stop;
+            }
+
+            const StatesRef active = states.topRows(rows);
+            stepper.step(bath, *active_system, active, t);
+            observe(states.topRows(rows), t);
+        }
+    });
+
+    detail::restore_order(data, order_col);
+
+    return t_end;
+}
+
+} // namespace mfptlib
+
+#endif
@@ -6,11 +6,13 @@
 #define MFPTLIB_MATH_LANGEVINBATH_HPP
 
 #include <cmath>
+#include <utility>
 
-#include <pcg_random.hpp>
-
+#include <mfptlib/core/Cache.hpp>
 #include <mfptlib/core/Errors.hpp>
+#include <mfptlib/core/StateParameters.hpp>
 #include <mfptlib/core/Types.hpp>
+#include <mfptlib/math/NoiseSource.hpp>
 
 
 namespace mfptlib {
@@ -18,24 +20,82 @@ namespace mfptlib {
 class LangevinBath
 {
 public:
-    explicit LangevinBath(double kb_t, double friction, Seed seed)
+    explicit LangevinBath(
+        double kb_t,
+        double friction,
+        Seed seed,
+        NoiseGenerator generator = NoiseGenerator::Vectorized
+    )
+        : LangevinBath{kb_t, friction, NoiseSource{seed, generator}}
+    {}
+
+    explicit LangevinBath(double kb_t, double friction, NoiseSource noise)
         : sqrt_kb_t_{std::sqrt(kb_t)}
         , friction_{friction}
-        , rng_{seed}
+        , noise_source_{std::move(noise)}
     {
         expect(kb_t >= 0.0, "The temperature kb_t must be >= 0.");
         expect(friction >= 0.0, "The friction must be >= 0.");
     }
 
-    void apply_forces(
-        VectorsRef momenta, const VectorsCRef& masses, double dt
-    ) noexcept;
+    // Temperature and friction per state, which have to match the ensemble
+    // and are compacted with it. Call reset() before reusing the bath.
+    explicit LangevinBath(Scalars kb_t, Scalars friction, NoiseSource noise);
+
+    void apply_forces(VectorsRef momenta, const VectorsCRef& masses, double dt);
+
+    // Only per-state parameters and counter-based
+    // or replayed noise depend on the states.
+    void filter_states(const Booleans& predicate)
+    {
+        parameters_.filter_rows(predicate);
+        noise_source_.filter_states(predicate);
+    }
+
+    void reset()
+    {
+        parameters_.reset();
+        noise_source_.reset();
+    }
+
+    [[nodiscard]]
+    auto split_states(Index first) -> LangevinBath
+    {
+        LangevinBath split{*this};
+        split.parameters_ = parameters_.split_rows(first);
+        split.noise_source_ = noise_source_.split_states(first);
+        return split;
+    }
+
+    void join_states(LangevinBath&& tail)
+    {
+        parameters_.join_rows(std::move(tail.parameters_));
+        noise_source_.join_states(std::move(tail.noise_source_));
+    }
+
+    [[nodiscard]]
+    auto fork() -> LangevinBath
+    {
+        LangevinBath forked{*this};
+        forked.parameters_.reset();
+        forked.noise_source_ = noise_source_.fork();
+        return forked;
+    }
+
+
+private:
+    void apply_state_forces(
+        VectorsRef momenta, const VectorsCRef& masses, double dt);
 
 
 private:
     double sqrt_kb_t_;
     double friction_;
-    pcg64_oneseq rng_;
+    // Columns √kb_t and friction if they are given per state.
+    StateParameters parameters_{};
+    NoiseSource noise_source_;
+    Cache<Vectors> noise_{};
+    Cache<Vectors> scales_{};
 };
 
 } // namespace mfptlib
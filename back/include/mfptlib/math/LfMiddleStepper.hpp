@@ -7,6 +7,7 @@
 
 #include <utility>
 
+#include <mfptlib/core/Cache.hpp>
 #include <mfptlib/core/Errors.hpp>
 #include <mfptlib/core/Types.hpp>
 #include <mfptlib/math/Bath.hpp>
@@ -24,11 +25,71 @@ class LfMiddleStepper
 
     void step(Bath& bath, const System& system, VectorsRef states, double& t);
 
+    // Statically dispatched version for concrete baths and systems.
+    // States with a fixed number of columns unroll the loops over the DoFs.
+    template<typename BathT, typename SystemT, int Cols>
+    void step(
+        BathT& bath,
+        const SystemT& system,
+        FixedVectorsRef<Cols> states,
+        double& t
+    );
+
 
 private:
     double dt_;
+    // Buffers reused between steps to avoid allocations.
+    Cache<Vectors> force_;
+    Cache<Vectors> masses_;
 };
 
+
+/**
+ * Langevin LF-Middle integrator:
+ *
+ * ζ = √[k_B T (1 - e^{-2γh})]
+ * R_n is standard normally-distributed random variable (μ = 0, σ = 1)
+ * p'_{n + 1/2} = p_{n - 1/2} + h * F(q_n)                                  (p)
+ * q_{n + 1/2} = q_n + h/2 M^{-1} p'_{n + 1/2}                              (x1)
+ * p_{n + 1/2} = e^{-hγ} p'_{n + 1/2} + ζ M^{1/2} R_n                       (T)
+ * q_{n + 1} = q_{n + 1/2} + h/2 M^{-1} p_{n + 1/2}                         (x2)
+ *
+ * References:
+ * - Zhang et al., J. Phys. Chem. A 123, 6056-6079 (2019):
+ *   https://doi.org/10.1021/acs.jpca.9b02771
+ */
+template<typename BathT, typename SystemT, int Cols>
+void LfMiddleStepper::step(
+    BathT& bath,
+    const SystemT& system,
+    FixedVectorsRef<Cols> states,
+    double& t
+)
+{
+    using DofVectorsRef = FixedVectorsRef<HalfCols<Cols>>;
+    const double half_dt = 0.5 * dt_;
+    const SystemTraits traits = system_traits(system);
+    DofVectorsRef q = positions(states);
+    DofVectorsRef p = momenta(states);
+    force_.resize(p.rows(), p.cols());
+    masses_.resize(p.rows(), p.cols());
+    DofVectorsRef force = *force_;
+    DofVectorsRef mass = *masses_;
+
+    force_into(system, states, t, force);
+    p += dt_ * force;                                                    // (p)
+    masses_into(system, states, mass);
+    q += half_dt * p / mass;                                             // (x1)
+    if(!traits.constant_masses)
+        masses_into(system, states, mass);
+    bath.apply_forces(p, mass, dt_);                                     // (T)
+    if(!traits.constant_masses)
+        masses_into(system, states, mass);
+    q += half_dt * p / mass;                                             // (x2)
+
+    t += dt_;
+}
+
 } // namespace mfptlib
 
 #endif
@@ -0,0 +1,189 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef MFPTLIB_MATH_NOISESOURCE_HPP
+#define MFPTLIB_MATH_NOISESOURCE_HPP
+
+#include <array>
+#include <cstdint>
+#include <memory>
+
+#include <pcg_random.hpp>
+
+#include <mfptlib/core/Types.hpp>
+
+
+namespace mfptlib {
+
+enum class NoiseGenerator
+{
+    // Interleaved xoshiro256+ streams and a vectorized Box-Muller transform.
+    Vectorized,
+    // pcg64 and std::normal_distribution drawing one value at a time,
+    // which reproduces the noise of earlier versions bitwise.
+    Scalar,
+    // Philox4x32-10 keyed by seed, trajectory, and step, so that the noise
+    // does not depend on how the ensemble is distributed or compacted.
+    Counter,
+    // Noise read from a buffer, see NoiseSource(Vectors).
+    Replay,
+};
+
+
+// Whether a background thread generates vectorized noise ahead of time.
+enum class Prefetch : bool
+{
+    Off = false,
+    On = true,
+};
+
+
+namespace detail {
+
+using PhiloxCounter = std::array<std::uint32_t, 4>;
+using PhiloxKey = std::array<std::uint32_t, 2>;
+
+// Philox4x32-10 counter-based generator, see Salmon et al. (2011).
+[[nodiscard]]
+constexpr auto philox4x32(PhiloxCounter ctr, PhiloxKey key) noexcept
+    -> PhiloxCounter
+{
+    constexpr std::uint64_t mul0 = 0xd2511f53, mul1 = 0xcd9e8d57;
+    for(int round = 0; round < 10; ++round)
+    {
+        const std::uint64_t p0 = mul0 * ctr[0];
+        const std::uint64_t p1 = mul1 * ctr[2];
+        ctr = {
+            static_cast<std::uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0],
+            static_cast<std::uint32_t>(p1),
+            static_cast<std::uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1],
+            static_cast<std::uint32_t>(p0),
+        };
+        key[0] += 0x9e3779b9;
+        key[1] += 0xbb67ae85;
+    }
+    return ctr;
+}
+
+} // namespace detail
+
+
+/**
+ * Source of normally-distributed noise filling whole arrays at once.
+ *
+ * The vectorized generator advances Lanes independent xoshiro256+ streams
+ * in lockstep, which the compiler maps to SIMD instructions, and converts
+ * blocks of uniform values with the Box-Muller transform. Values that are
+ * not consumed by one call are used by the next, so the noise does not
+ * depend on how the arrays are split between calls.
+ *
+ * The counter-based and replayed noise instead depends on the original
+ * index of each row (its trajectory) and the number of previous calls
+ * (its step). Rows are tracked through filter_states(), split_states(),
+ * and join_states() like the per-state data of baths, so results are
+ * reproducible for any number of threads, tile size, or compaction policy.
+ *
+ * With Prefetch::On, a producer thread fills a ring of slots with the
+ * vectorized stream ahead of time, so that fill() only scales and copies.
+ * The slots hold a few calls' worth of noise and shrink with the ensemble.
+ * The noise is the same as without prefetching. Copies share the producer,
+ * but forks and splits do not prefetch, so that threaded or tiled
+ * propagation does not start a producer thread per shard or tile.
+ * Prefetching hence only applies to single-threaded, untiled propagation.
+ *
+ * References:
+ * - Blackman and Vigna, ACM Trans. Math. Softw. 47, 36 (2021):
+ *   https://doi.org/10.1145/3460772
+ * - Box and Muller, Ann. Math. Statist. 29(2), 610-611 (1958):
+ *   https://doi.org/10.1214/aoms/1177706645
+ * - Salmon et al., Proc. SC '11, 16 (2011):
+ *   https://doi.org/10.1145/2063384.2063405
+ */
+class NoiseSource
+{
+public:
+    static constexpr int Lanes = 16;
+    static constexpr int BlockSize = 16 * Lanes;
+
+    explicit NoiseSource(
+        Seed seed,
+        NoiseGenerator generator = NoiseGenerator::Vectorized,
+        Prefetch prefetch = Prefetch::Off
+    );
+
+    // Replay standard normal noise from a buffer with one row per trajectory
+    // and the values of step s in columns [s n, (s + 1) n) for n DoFs.
+    explicit NoiseSource(Vectors replay);
+
+    // Fill out column by column with values distributed as N(0, stddev²).
+    void fill(VectorsRef out, double stddev);
+
+    // The following functions only affect counter-based and replayed noise.
+    void filter_states(const Booleans& predicate);
+
+    // Start over with trajectories 0, 1, ... but continue with the steps.
+    void reset() noexcept;
+
+    // Source for rows [first, n), which are dropped from this one.
+    // Generators with a stream of noise return a fork instead.
+    [[nodiscard]]
+    auto split_states(Index first) -> NoiseSource;
+
+    // Append the rows of a source split off this one or a fork of it, which
+    // has taken the same number of steps. Generators with a stream of noise
+    // continue with their own stream.
+    void join_states(NoiseSource&& tail);
+
+    // Independent source using the same generator, seeded from this one.
+    // Counter-based forks produce the noise that this source would have
+    // produced for trajectories 0, 1, ..., while this source moves on.
+    [[nodiscard]]
+    auto fork() -> NoiseSource;
+
+    auto generator() const noexcept -> NoiseGenerator
+    { return generator_; }
+
+    auto prefetch() const noexcept -> Prefetch
+    { return prefetcher_ ? Prefetch::On : Prefetch::Off; }
+
+
+private:
+    using Lane = std::array<std::uint64_t, Lanes>;
+    class Prefetcher;
+
+    void refill() noexcept;
+    void box_muller(int count) noexcept;
+    void fill_counter(VectorsRef out, double stddev);
+    void fill_replay(VectorsRef out, double stddev);
+    void fill_prefetched(VectorsRef out, double stddev);
+
+    // Original indices of the rows of an ensemble of the given size.
+    auto trajectories(Index rows) -> const Indices&;
+
+
+private:
+    NoiseGenerator generator_;
+    // Scalar generator, also used to seed forks.
+    pcg64_oneseq rng_;
+    // State of the xoshiro256+ lanes.
+    std::array<Lane, 4> lanes_{};
+    // Standard normal values not consumed yet start at position_.
+    alignas(64) std::array<double, BlockSize> block_{};
+    Index position_{BlockSize};
+
+    // Counter-based and replayed noise only.
+    // Until rows are filtered, row i is trajectory first_trajectory_ + i.
+    Seed key_{};
+    std::uint32_t epoch_{0};
+    std::uint64_t step_{0};
+    Index first_trajectory_{0};
+    Indices trajectories_{};
+    std::shared_ptr<const Vectors> replay_{};
+
+    std::shared_ptr<Prefetcher> prefetcher_{};
+};
+
+} // namespace mfptlib
+
+#endif
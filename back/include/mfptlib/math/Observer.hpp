@@ -31,6 +31,10 @@ class Observer
             func_(states, t);
     }
 
+    // Whether calling the observer has any effect.
+    explicit operator bool() const noexcept
+    { return bool{func_}; }
+
 
 private:
     Function func_;
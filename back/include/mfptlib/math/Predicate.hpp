@@ -10,6 +10,7 @@
 
 #include <mfptlib/core/Errors.hpp>
 #include <mfptlib/core/Types.hpp>
+#include <mfptlib/sys/System.hpp>
 
 
 namespace mfptlib {
@@ -41,6 +42,44 @@ class Predicate
     Function func_;
 };
 
+
+// Logical combinations of predicates, evaluated element-wise.
+// Both operands are always evaluated, there is no short-circuiting.
+[[nodiscard]] auto operator&&(Predicate lhs, Predicate rhs) -> Predicate;
+[[nodiscard]] auto operator||(Predicate lhs, Predicate rhs) -> Predicate;
+[[nodiscard]] auto operator!(Predicate pred) -> Predicate;
+
+
+// Native predicates that do not call back into user code.
+// All intervals are half-open, i.e., they include the lower bound only.
+
+// lower <= states[column] < upper for a column of the full states.
+[[nodiscard]] auto coordinate_interval(
+    Index column, double lower, double upper) -> Predicate;
+
+// lower <= q < upper for all positions q.
+[[nodiscard]] auto coordinate_box(Vector lower, Vector upper) -> Predicate;
+
+// normal · q < offset for the positions q.
+[[nodiscard]] auto half_space(Vector normal, double offset) -> Predicate;
+
+// lower <= |q - center| < upper for the positions q.
+[[nodiscard]] auto radial_distance(
+    Vector center, double lower, double upper) -> Predicate;
+
+// |q - center| < half_width for a periodic angle q = positions[column],
+// where the difference is wrapped into [-π, π].
+[[nodiscard]] auto angle_window(
+    Index column, double center, double half_width) -> Predicate;
+
+// lower <= V(q, t) < upper.
+[[nodiscard]] auto potential_interval(
+    System system, double lower, double upper) -> Predicate;
+
+// lower <= T(p) + V(q, t) < upper.
+[[nodiscard]] auto total_energy_interval(
+    System system, double lower, double upper) -> Predicate;
+
 } // namespace mfptlib
 
 #endif
@@ -0,0 +1,100 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef MFPTLIB_MATH_PRONYMEMORYBATH_HPP
+#define MFPTLIB_MATH_PRONYMEMORYBATH_HPP
+
+#include <utility>
+
+#include <mfptlib/core/Cache.hpp>
+#include <mfptlib/core/Types.hpp>
+#include <mfptlib/math/NoiseSource.hpp>
+
+
+namespace mfptlib {
+
+// Generalization of ExpMemoryBath to a memory kernel that is a sum of
+// exponentials, each with its own friction and memory parameter.
+class PronyMemoryBath
+{
+public:
+    explicit PronyMemoryBath(
+        double kb_t,
+        Scalars frictions,
+        Scalars memories,
+        Seed seed,
+        NoiseGenerator generator = NoiseGenerator::Vectorized
+    )
+        : PronyMemoryBath{kb_t, std::move(frictions), std::move(memories),
+            NoiseSource{seed, generator}}
+    {}
+
+    explicit PronyMemoryBath(
+        double kb_t, Scalars frictions, Scalars memories, NoiseSource noise);
+
+    void apply_forces(VectorsRef momenta, const VectorsCRef& masses, double dt);
+
+    void filter_states(const Booleans& predicate)
+    {
+        forces_.filter_rows(predicate);
+        noise_source_.filter_states(predicate);
+    }
+
+    void reset() noexcept
+    {
+        forces_.reset();
+        noise_source_.reset();
+    }
+
+    [[nodiscard]]
+    auto split_states(Index first) -> PronyMemoryBath
+    {
+        PronyMemoryBath split{*this};
+        split.noise_source_ = noise_source_.split_states(first);
+        split.forces_ = forces_.split_rows(first);
+        return split;
+    }
+
+    void join_states(PronyMemoryBath&& tail)
+    {
+        noise_source_.join_states(std::move(tail.noise_source_));
+        forces_.join_rows(std::move(tail.forces_));
+    }
+
+    // The auxiliary forces of all terms can be stored in an Ensemble.
+    auto state_columns(Index dofs) const noexcept -> Index
+    { return num_terms() * dofs; }
+
+    void bind_columns(VectorsRef columns)
+    { forces_.bind(std::move(columns)); }
+
+    void unbind_columns()
+    { forces_.unbind(); }
+
+    [[nodiscard]]
+    auto fork() -> PronyMemoryBath
+    {
+        PronyMemoryBath forked{*this};
+        forked.noise_source_ = noise_source_.fork();
+        forked.reset();
+        return forked;
+    }
+
+    auto num_terms() const noexcept -> Index
+    { return frictions_.size(); }
+
+
+private:
+    Scalars noise_;
+    Scalars frictions_;
+    Scalars memories_;
+    NoiseSource noise_source_;
+    // The auxiliary forces of term k are in columns [k n, (k + 1) n).
+    Cache<Vectors> forces_{};
+    Cache<Vectors> random_{};
+};
+
+} // namespace mfptlib
+
+#endif
@@ -5,6 +5,7 @@
 #ifndef MFPTLIB_MATH_PROPAGATE_HPP
 #define MFPTLIB_MATH_PROPAGATE_HPP
 
+#include <mfptlib/core/Ensemble.hpp>
 #include <mfptlib/core/Types.hpp>
 #include <mfptlib/math/Observer.hpp>
 #include <mfptlib/math/Predicate.hpp>
@@ -16,25 +17,84 @@ namespace mfptlib {
 
 namespace detail {
 
-auto partition_record(
-    Indices& order, VectorsRef states, const Booleans& predicate
-) noexcept -> Index;
+// Stable partition of the rows of data such that all rows for which the
+// predicate holds come first. One of the columns records the original
+// index of every row and is moved along with the others.
+auto partition_record(VectorsRef data, const Booleans& predicate) -> Index;
 
-void restore_order(Indices& order, VectorsRef states) noexcept;
+// Move all rows back to the original indices recorded in column order_col.
+void restore_order(VectorsRef data, Index order_col);
 
 } // namespace detail
 
 
+enum class Schedule
+{
+    // Every thread propagates a fixed, contiguous block of states.
+    Static,
+    // Idle threads take over half of the active states of busy threads.
+    WorkStealing,
+};
+
+
+struct PropagateOptions
+{
+    // Number of threads sharing the ensemble in propagate_while().
+    // Every thread works on its own contiguous block of states
+    // using forked copies of the stepper and bath.
+    Index num_threads{1};
+
+    // How the states are distributed among the threads.
+    Schedule schedule{Schedule::Static};
+
+    // Blocks with fewer than twice this number of active states
+    // are never split when using Schedule::WorkStealing.
+    Index min_split_rows{16};
+
+    // Stopped states are only removed from the propagated block once the
+    // fraction of active states drops below this threshold. Until then,
+    // they are masked out and their final states are restored later.
+    // The default of 1 removes stopped states after every step.
+    double compaction_threshold{1.0};
+
+    // Number of rows per tile for cache-blocked propagation, 0 disables it.
+    // The ensemble is cut into tiles with their own forked stepper and bath,
+    // which take turns advancing tile_steps steps, so that the working set
+    // of a tile stays in cache. Tiles are shared by num_threads threads.
+    Index tile_rows{0};
+
+    // Number of steps a tile is advanced before moving to the next one.
+    Index tile_steps{64};
+};
+
+
+// Without threads or tiling, the passed stepper and bath are used directly.
+// Otherwise, forked copies are propagated as in propagate_while(), and their
+// per-state data is joined back into the passed stepper and bath, so that
+// consecutive calls continue like on a single thread, including the noise.
 auto propagate_to(
     Stepper& stepper, Bath& bath, const System& system,
     VectorsRef states, double t, double t_end,
-    const Observer& observe
+    const Observer& observe, const PropagateOptions& options = {}
 ) -> double;
 
+// The states are propagated as an Ensemble without auxiliary columns.
 auto propagate_while(
     Stepper& stepper, Bath& bath, const System& system,
     VectorsRef states, double t, const Predicate& predicate,
-    const Observer& observe
+    const Observer& observe, const PropagateOptions& options = {}
+) -> Scalars;
+
+// The ensemble temporarily holds the original indices of the states and
+// the per-state data that the stepper and the bath bind to it, so that
+// compacting the ensemble partitions all of them in a single pass.
+// Per-state data that is not bound is compacted via filter_states().
+// Like the states, the auxiliary columns are returned in their original
+// order.
+auto propagate_while(
+    Stepper& stepper, Bath& bath, const System& system,
+    Ensemble& ensemble, double t, const Predicate& predicate,
+    const Observer& observe, const PropagateOptions& options = {}
 ) -> Scalars;
 
 } // namespace mfptlib
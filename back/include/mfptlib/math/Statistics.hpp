@@ -0,0 +1,191 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef MFPTLIB_MATH_STATISTICS_HPP
+#define MFPTLIB_MATH_STATISTICS_HPP
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <mfptlib/core/Cache.hpp>
+#include <mfptlib/core/Types.hpp>
+#include <mfptlib/math/Observer.hpp>
+#include <mfptlib/sys/System.hpp>
+
+
+namespace mfptlib {
+
+// Per-state values accumulated by the native observers below.
+class Quantity
+{
+public:
+    enum class Kind
+    {
+        Coordinates, Coordinate, KineticEnergy, Potential, TotalEnergy,
+    };
+
+    // Storage for computed values, reused between calls to visit().
+    struct Buffers
+    {
+        Cache<Vectors> values;
+        Cache<Vectors> masses;
+    };
+
+
+public:
+    // All columns of the states.
+    static auto coordinates() -> Quantity;
+
+    // A single column of the states.
+    static auto coordinate(Index column) -> Quantity;
+
+    static auto kinetic_energy(System system) -> Quantity;
+    static auto potential(System system) -> Quantity;
+    static auto total_energy(System system) -> Quantity;
+
+    auto kind() const noexcept -> Kind
+    { return kind_; }
+
+    // Number of values per state, or -1 if it depends on the states.
+    auto width() const noexcept -> Index
+    { return kind_ == Kind::Coordinates ? -1 : 1; }
+
+    // Call func with the values of the quantity for the states at time t.
+    // Coordinates are passed as views of the states without copying,
+    // computed values as views of buffers.
+    template<typename Func>
+    void visit(
+        const VectorsCRef& states, double t, Buffers& buffers, Func&& func
+    ) const;
+
+
+private:
+    Quantity(Kind kind, Index column, std::optional<System> system) noexcept;
+
+
+private:
+    Kind kind_;
+    Index column_;
+    std::optional<System> system_;
+};
+
+
+template<typename Func>
+void Quantity::visit(
+    const VectorsCRef& states, double t, Buffers& buffers, Func&& func
+) const
+{
+    switch(kind_)
+    {
+    case Kind::Coordinates:
+        return func(states);
+    case Kind::Coordinate:
+        expect(column_ < states.cols(),
+            "The column index exceeds the size of the passed states.");
+        return func(states.col(column_));
+    case Kind::KineticEnergy:
+    case Kind::Potential:
+    case Kind::TotalEnergy:
+        break;
+    }
+
+    buffers.values.resize(states.rows(), 1);
+    auto values = (*buffers.values).col(0);
+    if(kind_ == Kind::KineticEnergy)
+        values.setZero();
+    else
+        potential_into(*system_, states, t, values);
+
+    if(kind_ != Kind::Potential)
+    {
+        const auto p = momenta(states);
+        buffers.masses.resize(p.rows(), p.cols());
+        masses_into(*system_, states, *buffers.masses);
+        values += 0.5 * (p.square() / *buffers.masses).rowwise().sum();
+    }
+
+    func(*buffers.values);
+}
+
+
+// Running mean and variance of a quantity over all observed states and times.
+// Converts to an Observer that shares the accumulated results,
+// which may be called from multiple threads at the same time.
+class MomentsObserver
+{
+public:
+    explicit MomentsObserver(Quantity quantity = Quantity::coordinates());
+
+    operator Observer() const;
+
+    // Number of accumulated values per column.
+    auto count() const -> Index;
+    auto mean() const -> Vector;
+    // Unbiased sample variance.
+    auto variance() const -> Vector;
+
+    void reset();
+
+
+private:
+    struct State;
+    std::shared_ptr<State> state_;
+};
+
+
+// Histogram of a scalar quantity with equally sized bins in [lower, upper)
+// over all observed states and times.
+// Values outside of the range are counted separately, NaNs are ignored.
+class HistogramObserver
+{
+public:
+    HistogramObserver(
+        Quantity quantity, double lower, double upper, Index bins);
+
+    operator Observer() const;
+
+    auto edges() const -> Scalars;
+    auto counts() const -> Indices;
+    auto underflow() const -> Index;
+    auto overflow() const -> Index;
+
+    void reset();
+
+
+private:
+    struct State;
+    std::shared_ptr<State> state_;
+};
+
+
+// Number of observed (i.e., active) states as a function of time.
+// Observations of different blocks at the same time are added up.
+class SurvivalObserver
+{
+public:
+    SurvivalObserver();
+
+    operator Observer() const;
+
+    // Distinct observation times in ascending order.
+    auto times() const -> Scalars;
+    auto counts() const -> Indices;
+
+    void reset();
+
+
+private:
+    struct State;
+    std::shared_ptr<State> state_;
+};
+
+
+// Observer that calls all passed observers in order.
+[[nodiscard]] auto combine_observers(std::vector<Observer> observers)
+    -> Observer;
+
+} // namespace mfptlib
+
+#endif
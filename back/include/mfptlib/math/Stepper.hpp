@@ -32,9 +32,61 @@ class Stepper
     void filter_states(const Booleans& predicate)
     { pimpl_->filter_states(predicate); }
 
+    // Called at the start and the end of every propagation. Steppers may
+    // keep data between the steps of a single propagation, which is only
+    // valid as long as nobody else modifies the states.
+    void begin_propagation()
+    { pimpl_->begin_propagation(); }
+
+    void end_propagation()
+    { pimpl_->end_propagation(); }
+
     void reset()
     { pimpl_->reset(); }
 
+    [[nodiscard]]
+    auto split_states(Index first) -> Stepper
+    { return Stepper{pimpl_->split_states(first)}; }
+
+    // Append the per-state data of a stepper split off this one or a fork
+    // of it, which has taken the same number of steps, e.g., to gather the
+    // shards of a propagation.
+    void join_states(Stepper&& tail)
+    { pimpl_->join_states(*tail.pimpl_); }
+
+    [[nodiscard]]
+    auto fork() const -> Stepper
+    { return Stepper{pimpl_->fork()}; }
+
+    // Number of columns of per-state data for states with the given number
+    // of DoFs, which bind_columns() can store outside of the stepper.
+    auto state_columns(Index dofs) const -> Index
+    { return pimpl_->state_columns(dofs); }
+
+    // Keep the per-state data in columns owned by someone else, e.g., an
+    // Ensemble, which moves them along with the states until unbind_columns()
+    // copies them back.
+    void bind_columns(VectorsRef columns)
+    { pimpl_->bind_columns(std::move(columns)); }
+
+    void unbind_columns()
+    { pimpl_->unbind_columns(); }
+
+    // Pointer to the underlying implementation if it is of type Impl.
+    template<typename Impl>
+    auto target() noexcept -> Impl*
+    {
+        auto* wrapper = dynamic_cast<Wrapper<Impl>*>(pimpl_.get());
+        return wrapper ? &wrapper->impl() : nullptr;
+    }
+
+    template<typename Impl>
+    auto target() const noexcept -> const Impl*
+    {
+        auto* wrapper = dynamic_cast<const Wrapper<Impl>*>(pimpl_.get());
+        return wrapper ? &wrapper->impl() : nullptr;
+    }
+
 
 private:
     struct Interface
@@ -45,7 +97,16 @@ class Stepper
             Bath& bath, const System& system, VectorsRef states, double& t
         ) = 0;
         virtual void filter_states(const Booleans& predicate) = 0;
+        virtual void begin_propagation() = 0;
+        virtual void end_propagation() = 0;
         virtual void reset() = 0;
+        virtual auto split_states(
+            Index first) -> std::unique_ptr<Interface> = 0;
+        virtual void join_states(Interface& tail) = 0;
+        virtual auto fork() const -> std::unique_ptr<Interface> = 0;
+        virtual auto state_columns(Index dofs) const -> Index = 0;
+        virtual void bind_columns(VectorsRef columns) = 0;
+        virtual void unbind_columns() = 0;
     };
 
     template<typename Impl>
@@ -71,17 +132,99 @@ class Stepper
                 impl_.filter_states(predicate);
         }
 
+        void begin_propagation() override
+        {
+            if constexpr(requires{ impl_.begin_propagation(); })
+                impl_.begin_propagation();
+        }
+
+        void end_propagation() override
+        {
+            if constexpr(requires{ impl_.end_propagation(); })
+                impl_.end_propagation();
+        }
+
         void reset() override
         {
             if constexpr(requires{ impl_.reset(); })
                 impl_.reset();
         }
 
+        auto split_states(Index first) -> std::unique_ptr<Interface> override
+        {
+            if constexpr(requires{ impl_.split_states(first); })
+                return std::make_unique<Wrapper>(impl_.split_states(first));
+            else
+            {
+                // Without knowledge of the per-state data,
+                // both halves have to start from scratch.
+                reset();
+                return fork();
+            }
+        }
+
+        void join_states(Interface& tail) override
+        {
+            if constexpr(requires{ impl_.join_states(std::move(impl_)); })
+            {
+                if(auto* other = dynamic_cast<Wrapper*>(&tail))
+                    return impl_.join_states(std::move(other->impl_));
+            }
+
+            // Without knowledge of the per-state data,
+            // the joined stepper has to start from scratch.
+            reset();
+        }
+
+        auto fork() const -> std::unique_ptr<Interface> override
+        {
+            if constexpr(requires{ impl_.fork(); })
+                return std::make_unique<Wrapper>(impl_.fork());
+            else
+            {
+                auto forked = std::make_unique<Wrapper>(impl_);
+                forked->reset();
+                return forked;
+            }
+        }
+
+        auto state_columns(Index dofs) const -> Index override
+        {
+            if constexpr(requires{ impl_.state_columns(dofs); })
+                return impl_.state_columns(dofs);
+            else
+                return 0;
+        }
+
+        void bind_columns(VectorsRef columns) override
+        {
+            if constexpr(requires{ impl_.bind_columns(columns); })
+                impl_.bind_columns(std::move(columns));
+        }
+
+        void unbind_columns() override
+        {
+            if constexpr(requires{ impl_.unbind_columns(); })
+                impl_.unbind_columns();
+        }
+
+        auto impl() noexcept -> Impl&
+        { return impl_; }
+
+        auto impl() const noexcept -> const Impl&
+        { return impl_; }
+
     private:
         Impl impl_;
     };
 
 
+private:
+    explicit Stepper(std::unique_ptr<Interface> pimpl) noexcept
+        : pimpl_{std::move(pimpl)}
+    {}
+
+
 private:
     std::unique_ptr<Interface> pimpl_;
 };
@@ -0,0 +1,121 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef MFPTLIB_MATH_TABULATEDMEMORYBATH_HPP
+#define MFPTLIB_MATH_TABULATEDMEMORYBATH_HPP
+
+#include <memory>
+#include <utility>
+
+#include <mfptlib/core/Cache.hpp>
+#include <mfptlib/core/Errors.hpp>
+#include <mfptlib/core/Types.hpp>
+#include <mfptlib/math/NoiseSource.hpp>
+
+
+namespace mfptlib {
+
+// GLE bath with an arbitrary memory kernel tabulated at multiples of the
+// time step. The memory integral and the colored noise are convolutions
+// with the past momenta and white noise, which are kept per state.
+class TabulatedMemoryBath
+{
+public:
+    explicit TabulatedMemoryBath(
+        double kb_t,
+        Scalars kernel,
+        double dt,
+        Seed seed,
+        NoiseGenerator generator = NoiseGenerator::Vectorized
+    )
+        : TabulatedMemoryBath{
+            kb_t, std::move(kernel), dt, NoiseSource{seed, generator}}
+    {}
+
+    explicit TabulatedMemoryBath(
+        double kb_t, Scalars kernel, double dt, NoiseSource noise);
+
+    void apply_forces(VectorsRef momenta, const VectorsCRef& masses, double dt);
+
+    void filter_states(const Booleans& predicate)
+    {
+        momenta_.filter_rows(predicate);
+        white_.filter_rows(predicate);
+        memory_.filter_rows(predicate);
+        colored_.filter_rows(predicate);
+        noise_source_.filter_states(predicate);
+    }
+
+    void reset() noexcept
+    {
+        step_ = 0;
+        momenta_.reset();
+        white_.reset();
+        memory_.reset();
+        colored_.reset();
+        noise_source_.reset();
+    }
+
+    [[nodiscard]]
+    auto split_states(Index first) -> TabulatedMemoryBath
+    {
+        TabulatedMemoryBath split{*this};
+        split.noise_source_ = noise_source_.split_states(first);
+        split.momenta_ = momenta_.split_rows(first);
+        split.white_ = white_.split_rows(first);
+        split.memory_ = memory_.split_rows(first);
+        split.colored_ = colored_.split_rows(first);
+        return split;
+    }
+
+    void join_states(TabulatedMemoryBath&& tail)
+    {
+        expect(step_ == tail.step_,
+            "Only baths that have taken the same steps can be joined.");
+        noise_source_.join_states(std::move(tail.noise_source_));
+        momenta_.join_rows(std::move(tail.momenta_));
+        white_.join_rows(std::move(tail.white_));
+        memory_.join_rows(std::move(tail.memory_));
+        colored_.join_rows(std::move(tail.colored_));
+    }
+
+    [[nodiscard]]
+    auto fork() -> TabulatedMemoryBath
+    {
+        TabulatedMemoryBath forked{*this};
+        forked.noise_source_ = noise_source_.fork();
+        forked.reset();
+        return forked;
+    }
+
+    // Number of steps whose convolutions are evaluated together.
+    auto block_size() const noexcept -> Index;
+
+
+private:
+    struct Spectra;
+
+    void draw_past_noise(Index cols);
+    void start_block(Index cols);
+
+
+private:
+    std::shared_ptr<const Spectra> spectra_;
+    double dt_;
+    NoiseSource noise_source_;
+    // Steps since the last reset.
+    Index step_{0};
+    // Ring buffers with one column per step and DoF.
+    Cache<Vectors> momenta_{};
+    Cache<Vectors> white_{};
+    // Memory force due to the momenta before the current block
+    // and colored noise, each with one column per step and DoF.
+    Cache<Vectors> memory_{};
+    Cache<Vectors> colored_{};
+    Cache<Vectors> friction_{};
+};
+
+} // namespace mfptlib
+
+#endif
@@ -8,6 +8,7 @@
 #include <cassert>
 
 #include <mfptlib/core/Types.hpp>
+#include <mfptlib/sys/System.hpp>
 
 
 namespace mfptlib {
@@ -24,26 +25,105 @@ inline auto degrees_of_freedom(const EmptyPlane& model) noexcept -> Index
 
 
 [[nodiscard]]
-inline auto potential(
+constexpr auto traits(const EmptyPlane&) noexcept -> SystemTraits
+{
+    return {
+        .velocity_independent_forces = true,
+        .constant_masses = true,
+        .time_independent_potential = true,
+    };
+}
+
+
+inline void potential_into(
+    [[maybe_unused]] const EmptyPlane& model,
+    [[maybe_unused]] const VectorsCRef& states,
+    [[maybe_unused]] double t,
+    ScalarsRef out
+) noexcept
+{
+    assert(states.cols() == 2 * degrees_of_freedom(model));
+    out.setZero();
+}
+
+
+inline void force_into(
     [[maybe_unused]] const EmptyPlane& model,
+    [[maybe_unused]] const VectorsCRef& states,
+    [[maybe_unused]] double t,
+    VectorsRef out
+) noexcept
+{
+    assert(states.cols() == 2 * degrees_of_freedom(model));
+    out.setZero();
+}
+
+
+inline void masses_into(
+    const EmptyPlane& model,
+    [[maybe_unused]] const VectorsCRef& states,
+    VectorsRef out
+) noexcept
+{
+    assert(states.cols() == 2 * degrees_of_freedom(model));
+    out.rowwise() = model.masses;
+}
+
+
+template<>
+inline constexpr auto UnrolledDegreesOfFreedom<EmptyPlane> =
+    std::integer_sequence<int, 1, 2, 3>{};
+
+
+// Overloads for a fixed number of DoFs, which let Eigen unroll the loops.
+template<int Dofs> requires(Dofs != Eigen::Dynamic)
+inline void force_into(
+    [[maybe_unused]] const EmptyPlane& model,
+    [[maybe_unused]] const FixedVectorsCRef<2 * Dofs>& states,
+    [[maybe_unused]] double t,
+    FixedVectorsRef<Dofs> out
+) noexcept
+{
+    assert(degrees_of_freedom(model) == Dofs);
+    out.setZero();
+}
+
+template<int Dofs> requires(Dofs != Eigen::Dynamic)
+inline void masses_into(
+    const EmptyPlane& model,
+    [[maybe_unused]] const FixedVectorsCRef<2 * Dofs>& states,
+    FixedVectorsRef<Dofs> out
+) noexcept
+{
+    assert(degrees_of_freedom(model) == Dofs);
+    out.rowwise() = Eigen::Map<const Eigen::Array<double, 1, Dofs>>{
+        model.masses.data()};
+}
+
+
+[[nodiscard]]
+inline auto potential(
+    const EmptyPlane& model,
     const VectorsCRef& states,
-    [[maybe_unused]] double t
+    double t
 ) noexcept -> Scalars
 {
-    assert(states.cols() == 2 * degrees_of_freedom(model));
-    return Scalars::Zero(states.rows());
+    Scalars res{states.rows()};
+    potential_into(model, states, t, res);
+    return res;
 }
 
 
 [[nodiscard]]
 inline auto force(
-    [[maybe_unused]] const EmptyPlane& model,
+    const EmptyPlane& model,
     const VectorsCRef& states,
-    [[maybe_unused]] double t
+    double t
 ) noexcept -> Vectors
 {
-    assert(states.cols() == 2 * degrees_of_freedom(model));
-    return Vectors::Zero(states.rows(), model.masses.size());
+    Vectors res{states.rows(), degrees_of_freedom(model)};
+    force_into(model, states, t, res);
+    return res;
 }
 
 
@@ -53,8 +133,9 @@ inline auto masses(
     const VectorsCRef& states
 ) noexcept -> Vectors
 {
-    assert(states.cols() == 2 * degrees_of_freedom(model));
-    return model.masses.replicate(states.rows(), 1);
+    Vectors res{states.rows(), degrees_of_freedom(model)};
+    masses_into(model, states, res);
+    return res;
 }
 
 } // namespace mfptlib
@@ -0,0 +1,110 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef MFPTLIB_SYS_EXPRESSIONSYSTEM_HPP
+#define MFPTLIB_SYS_EXPRESSIONSYSTEM_HPP
+
+#include <cassert>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <mfptlib/core/Types.hpp>
+#include <mfptlib/sys/System.hpp>
+
+
+namespace mfptlib {
+
+/**
+ * System with a potential given by a mathematical expression.
+ *
+ * The expression may use the positions q0, q1, …, the time t, the constants
+ * pi and e, named parameters, numbers, the operators + - * / and ^ or **
+ * for powers, and the functions sin, cos, tan, sinh, cosh, tanh, atan, exp,
+ * log, sqrt, abs, and pow(x, y). Example: "0.5 * k * q0^2 + a * cos(q1)".
+ *
+ * The expression is parsed once into a sequence of instructions with
+ * constant subexpressions folded. Instructions are evaluated for chunks of
+ * states at once, operating on whole columns. The forces are obtained from
+ * reverse-mode automatic differentiation of the same instructions.
+ */
+class ExpressionSystem
+{
+public:
+    using Parameters = std::map<std::string, double, std::less<>>;
+
+    explicit ExpressionSystem(
+        std::string expression, Vector masses, const Parameters& parameters = {}
+    );
+
+
+    auto expression() const noexcept -> const std::string&
+    { return expression_; }
+
+    auto masses() const noexcept -> const Vector&
+    { return masses_; }
+
+    // Opaque compiled expression used by the free functions below.
+    struct Program;
+
+    auto program() const noexcept -> const Program&
+    { return *program_; }
+
+
+private:
+    std::string expression_;
+    Vector masses_;
+    std::shared_ptr<const Program> program_;
+};
+
+
+[[nodiscard]]
+inline auto degrees_of_freedom(const ExpressionSystem& model) noexcept
+    -> Index
+{ return model.masses().size(); }
+
+// The potential is time-independent unless the expression uses t.
+[[nodiscard]]
+auto traits(const ExpressionSystem& model) noexcept -> SystemTraits;
+
+
+void potential_into(
+    const ExpressionSystem& model,
+    const VectorsCRef& states,
+    double t,
+    ScalarsRef out
+) noexcept;
+
+void force_into(
+    const ExpressionSystem& model,
+    const VectorsCRef& states,
+    double t,
+    VectorsRef out
+) noexcept;
+
+void energy_and_force_into(
+    const ExpressionSystem& model,
+    const VectorsCRef& states,
+    double t,
+    ScalarsRef potential_out,
+    VectorsRef force_out
+) noexcept;
+
+
+inline void masses_into(
+    const ExpressionSystem& model,
+    [[maybe_unused]] const VectorsCRef& states,
+    VectorsRef out
+) noexcept
+{
+    assert(states.cols() == 2 * degrees_of_freedom(model));
+    out.rowwise() = model.masses();
+}
+
+} // namespace mfptlib
+
+
+#endif
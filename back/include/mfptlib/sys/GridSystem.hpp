@@ -0,0 +1,151 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef MFPTLIB_SYS_GRIDSYSTEM_HPP
+#define MFPTLIB_SYS_GRIDSYSTEM_HPP
+
+#include <cassert>
+#include <memory>
+
+#include <mfptlib/core/Types.hpp>
+#include <mfptlib/sys/System.hpp>
+
+
+namespace mfptlib {
+
+/**
+ * System with a potential interpolated from values on a regular grid.
+ *
+ * The potential is given at shape[d] equidistant points along every axis d
+ * in row-major order, i.e., the last axis is contiguous. For non-periodic
+ * axes, the first and last point lie on lower[d] and upper[d]. For periodic
+ * axes, upper[d] is identified with lower[d] and therefore not part of the
+ * grid.
+ *
+ * Potential and forces are evaluated by tensor-product Catmull-Rom
+ * interpolation, which is continuously differentiable and exact for
+ * quadratic polynomials away from non-periodic boundaries. The forces are
+ * the exact negative gradient of the interpolated potential. Beyond
+ * non-periodic boundaries, the potential is continued as a constant, so
+ * states leaving the grid do not experience any force along that axis.
+ *
+ * The values are shared instead of copied, so copies of the system and
+ * external owners, e.g., NumPy arrays, use the same buffer. It must not be
+ * modified while the system is in use.
+ */
+class GridSystem
+{
+public:
+    // Every evaluation visits 4^N grid points, limiting the dimension.
+    static constexpr Index MaxDimensions = 8;
+
+    explicit GridSystem(
+        std::shared_ptr<const double[]> values,
+        Indices shape,
+        Vector lower,
+        Vector upper,
+        Vector masses,
+        Booleans periodic = {}
+    );
+
+    // Copies values into a buffer owned by the system.
+    explicit GridSystem(
+        const Scalars& values,
+        Indices shape,
+        Vector lower,
+        Vector upper,
+        Vector masses,
+        Booleans periodic = {}
+    );
+
+
+    auto values() const noexcept -> const double*
+    { return values_.get(); }
+
+    auto shape() const noexcept -> const Indices&
+    { return shape_; }
+
+    auto strides() const noexcept -> const Indices&
+    { return strides_; }
+
+    auto lower() const noexcept -> const Vector&
+    { return lower_; }
+
+    auto upper() const noexcept -> const Vector&
+    { return upper_; }
+
+    auto spacing() const noexcept -> const Vector&
+    { return spacing_; }
+
+    auto masses() const noexcept -> const Vector&
+    { return masses_; }
+
+    auto periodic() const noexcept -> const Booleans&
+    { return periodic_; }
+
+
+private:
+    std::shared_ptr<const double[]> values_;
+    Indices shape_;
+    Indices strides_;
+    Vector lower_;
+    Vector upper_;
+    Vector spacing_;
+    Vector masses_;
+    Booleans periodic_;
+};
+
+
+[[nodiscard]]
+inline auto degrees_of_freedom(const GridSystem& model) noexcept -> Index
+{ return model.shape().size(); }
+
+[[nodiscard]]
+constexpr auto traits(const GridSystem&) noexcept -> SystemTraits
+{
+    return {
+        .velocity_independent_forces = true,
+        .constant_masses = true,
+        .time_independent_potential = true,
+    };
+}
+
+
+void potential_into(
+    const GridSystem& model,
+    const VectorsCRef& states,
+    double t,
+    ScalarsRef out
+) noexcept;
+
+void force_into(
+    const GridSystem& model,
+    const VectorsCRef& states,
+    double t,
+    VectorsRef out
+) noexcept;
+
+void energy_and_force_into(
+    const GridSystem& model,
+    const VectorsCRef& states,
+    double t,
+    ScalarsRef potential_out,
+    VectorsRef force_out
+) noexcept;
+
+
+inline void masses_into(
+    const GridSystem& model,
+    [[maybe_unused]] const VectorsCRef& states,
+    VectorsRef out
+) noexcept
+{
+    assert(states.cols() == 2 * degrees_of_freedom(model));
+    out.rowwise() = model.masses();
+}
+
+} // namespace mfptlib
+
+
+#endif
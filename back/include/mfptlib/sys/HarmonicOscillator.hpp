@@ -10,7 +10,9 @@
 #include <utility>
 
 #include <mfptlib/core/Errors.hpp>
+#include <mfptlib/core/StateParameters.hpp>
 #include <mfptlib/core/Types.hpp>
+#include <mfptlib/sys/System.hpp>
 
 
 namespace mfptlib {
@@ -18,25 +20,63 @@ namespace mfptlib {
 class HarmonicOscillator
 {
 public:
-    explicit HarmonicOscillator(Vector masses, Vector strengths) noexcept
+    explicit HarmonicOscillator(Vector masses, Vector strengths)
         : masses_{std::move(masses)}
         , strengths_{std::move(strengths)}
     {
-        expect(masses.size() == strengths.size(),
+        expect(masses_.size() == strengths_.size(),
             "The number of masses must match the number of strengths.");
     }
 
+    // Strengths per state with one row per state of the ensemble,
+    // which are compacted with the states during propagation.
+    [[nodiscard]]
+    static auto per_state(
+        Vector masses, Vectors strengths
+    ) -> HarmonicOscillator
+    {
+        expect(masses.size() == strengths.cols(),
+            "The number of masses must match the number of strengths.");
+        return HarmonicOscillator{PerState{},
+            std::move(masses), StateParameters{std::move(strengths)}};
+    }
+
 
     auto masses() const noexcept -> const Vector&
     { return masses_; }
 
+    // Empty if the strengths are given per state.
     auto strengths() const noexcept -> const Vector&
     { return strengths_; }
 
+    auto state_strengths() const noexcept -> const StateParameters&
+    { return state_strengths_; }
+
+
+private:
+    // Distinguishes the per-state constructor in brace initialization.
+    struct PerState {};
+
+    explicit HarmonicOscillator(
+        PerState, Vector masses, StateParameters strengths
+    ) noexcept
+        : masses_{std::move(masses)}
+        , state_strengths_{std::move(strengths)}
+    {}
+
+    friend auto filter_states(
+        const HarmonicOscillator& model, const Booleans& predicate
+    ) -> HarmonicOscillator;
+
+    friend auto split_states(
+        const HarmonicOscillator& model, Index first
+    ) -> std::pair<HarmonicOscillator, HarmonicOscillator>;
+
 
 private:
     Vector masses_;
-    Vector strengths_;
+    Vector strengths_{};
+    StateParameters state_strengths_{};
 };
 
 
@@ -47,17 +87,150 @@ inline auto degrees_of_freedom(
 { return model.masses().size(); }
 
 
+// Number of states with their own strengths, or 0 if they share them.
+[[nodiscard]]
+inline auto num_states(const HarmonicOscillator& model) noexcept -> Index
+{ return model.state_strengths().rows(); }
+
+
+[[nodiscard]]
+inline auto filter_states(
+    const HarmonicOscillator& model, const Booleans& predicate
+) -> HarmonicOscillator
+{
+    if(model.state_strengths().empty())
+        return model;
+
+    StateParameters strengths = model.state_strengths();
+    strengths.filter_rows(predicate);
+    return HarmonicOscillator{
+        HarmonicOscillator::PerState{}, model.masses(), std::move(strengths)};
+}
+
+
+[[nodiscard]]
+inline auto split_states(
+    const HarmonicOscillator& model, Index first
+) -> std::pair<HarmonicOscillator, HarmonicOscillator>
+{
+    if(model.state_strengths().empty())
+        return {model, model};
+
+    StateParameters head = model.state_strengths();
+    StateParameters tail = head.split_rows(first);
+    using PerState = HarmonicOscillator::PerState;
+    return {
+        HarmonicOscillator{PerState{}, model.masses(), std::move(head)},
+        HarmonicOscillator{PerState{}, model.masses(), std::move(tail)},
+    };
+}
+
+
+[[nodiscard]]
+constexpr auto traits(const HarmonicOscillator&) noexcept -> SystemTraits
+{
+    return {
+        .velocity_independent_forces = true,
+        .constant_masses = true,
+        .time_independent_potential = true,
+    };
+}
+
+
+inline void potential_into(
+    const HarmonicOscillator& model,
+    const VectorsCRef& states,
+    [[maybe_unused]] double t,
+    ScalarsRef out
+) noexcept
+{
+    assert(states.cols() == 2 * degrees_of_freedom(model));
+    if(model.state_strengths().empty())
+        out = 0.5 * (
+            positions(states).square().rowwise() * model.strengths()
+        ).rowwise().sum();
+    else
+        out = 0.5 * (
+            positions(states).square() * *model.state_strengths()
+        ).rowwise().sum();
+}
+
+
+inline void force_into(
+    const HarmonicOscillator& model,
+    const VectorsCRef& states,
+    [[maybe_unused]] double t,
+    VectorsRef out
+) noexcept
+{
+    assert(states.cols() == 2 * degrees_of_freedom(model));
+    if(model.state_strengths().empty())
+        out = positions(states).rowwise() * -model.strengths();
+    else
+        out = -positions(states) * *model.state_strengths();
+}
+
+
+inline void masses_into(
+    const HarmonicOscillator& model,
+    [[maybe_unused]] const VectorsCRef& states,
+    VectorsRef out
+) noexcept
+{
+    assert(states.cols() == 2 * degrees_of_freedom(model));
+    out.rowwise() = model.masses();
+}
+
+
+template<>
+inline constexpr auto UnrolledDegreesOfFreedom<HarmonicOscillator> =
+    std::integer_sequence<int, 1, 2, 3>{};
+
+
+// Overloads for a fixed number of DoFs, which let Eigen unroll the loops.
+template<int Dofs> requires(Dofs != Eigen::Dynamic)
+inline void force_into(
+    const HarmonicOscillator& model,
+    const FixedVectorsCRef<2 * Dofs>& states,
+    [[maybe_unused]] double t,
+    FixedVectorsRef<Dofs> out
+) noexcept
+{
+    assert(degrees_of_freedom(model) == Dofs);
+    if(!model.state_strengths().empty())
+    {
+        out = -positions(states) * *model.state_strengths();
+        return;
+    }
+
+    const Eigen::Map<const Eigen::Array<double, 1, Dofs>> strengths{
+        model.strengths().data()};
+    out = positions(states).rowwise() * -strengths;
+}
+
+template<int Dofs> requires(Dofs != Eigen::Dynamic)
+inline void masses_into(
+    const HarmonicOscillator& model,
+    [[maybe_unused]] const FixedVectorsCRef<2 * Dofs>& states,
+    FixedVectorsRef<Dofs> out
+) noexcept
+{
+    assert(degrees_of_freedom(model) == Dofs);
+    out.rowwise() = Eigen::Map<const Eigen::Array<double, 1, Dofs>>{
+        model.masses().data()};
+}
+
+
 [[nodiscard]]
 inline auto potential(
     const HarmonicOscillator& model,
     const VectorsCRef& states,
-    [[maybe_unused]] double t
+    double t
 ) noexcept -> Scalars
 {
-    assert(states.cols() == 2 * degrees_of_freedom(model));
-    return 0.5 * (
-        positions(states).square().rowwise() * model.strengths()
-    ).rowwise().sum();
+    Scalars res{states.rows()};
+    potential_into(model, states, t, res);
+    return res;
 }
 
 
@@ -65,11 +238,12 @@ inline auto potential(
 inline auto force(
     const HarmonicOscillator& model,
     const VectorsCRef& states,
-    [[maybe_unused]] double t
+    double t
 ) noexcept -> Vectors
 {
-    assert(states.cols() == 2 * degrees_of_freedom(model));
-    return positions(states).rowwise() * -model.strengths();
+    Vectors res{states.rows(), degrees_of_freedom(model)};
+    force_into(model, states, t, res);
+    return res;
 }
 
 
@@ -79,8 +253,9 @@ inline auto masses(
     const VectorsCRef& states
 ) noexcept -> Vectors
 {
-    assert(states.cols() == 2 * degrees_of_freedom(model));
-    return model.masses().replicate(states.rows(), 1);
+    Vectors res{states.rows(), degrees_of_freedom(model)};
+    masses_into(model, states, res);
+    return res;
 }
 
 } // namespace mfptlib
@@ -6,6 +6,7 @@
 #define MFPTLIB_SYS_LITHIUMCYANIDE_HPP
 
 #include <mfptlib/core/Types.hpp>
+#include <mfptlib/sys/System.hpp>
 
 
 namespace mfptlib {
@@ -18,6 +19,46 @@ constexpr auto degrees_of_freedom(const LithiumCyanide&) noexcept -> Index
 { return 2; }
 
 
+[[nodiscard]]
+constexpr auto traits(const LithiumCyanide&) noexcept -> SystemTraits
+{
+    // The centrifugal term of the R-force depends on p_θ.
+    return {.time_independent_potential = true};
+}
+
+
+template<>
+inline constexpr auto UnrolledDegreesOfFreedom<LithiumCyanide> =
+    std::integer_sequence<int, 2>{};
+
+
+void potential_into(
+    const LithiumCyanide& model,
+    const VectorsCRef& states,
+    double t,
+    ScalarsRef out
+) noexcept;
+
+void force_into(
+    const LithiumCyanide& model,
+    const VectorsCRef& states,
+    double t,
+    VectorsRef out
+) noexcept;
+
+// Evaluate potential and forces at once, sharing all intermediate results.
+void energy_and_force_into(
+    const LithiumCyanide& model,
+    const VectorsCRef& states,
+    double t,
+    ScalarsRef potential_out,
+    VectorsRef force_out
+) noexcept;
+
+void masses_into(
+    const LithiumCyanide& model, const VectorsCRef& states, VectorsRef out
+) noexcept;
+
 [[nodiscard]]
 auto potential(
     const LithiumCyanide& model, const VectorsCRef& states, double t
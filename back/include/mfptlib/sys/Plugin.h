@@ -0,0 +1,120 @@
+/*
+ * Copyright 2022 Johannes Reiff
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Stable C ABI for systems compiled outside of mfptlib.
+ *
+ * A plugin is a shared library exporting mfptlib_plugin_init, which fills in
+ * an mfptlib_plugin. Alternatively, the functions can be passed directly,
+ * e.g., as numba cfuncs or ctypes function pointers.
+ *
+ * All arrays are column-major. States have 2n columns, positions followed
+ * by momenta, for n degrees of freedom. Consecutive columns of states and
+ * forces are *_stride elements apart. The functions must be thread-safe and
+ * must not call into Python as they run without holding the GIL.
+ */
+
+#pragma once
+#ifndef MFPTLIB_SYS_PLUGIN_H
+#define MFPTLIB_SYS_PLUGIN_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MFPTLIB_PLUGIN_ABI_VERSION 1
+
+
+/* Write the potential of every state to out. */
+typedef void mfptlib_potential_fn(
+    const void* context,
+    int64_t rows,
+    const double* states,
+    int64_t states_stride,
+    double t,
+    double* out
+);
+
+/* Write the forces of every state to out. */
+typedef void mfptlib_force_fn(
+    const void* context,
+    int64_t rows,
+    const double* states,
+    int64_t states_stride,
+    double t,
+    double* out,
+    int64_t out_stride
+);
+
+/* Evaluate potential and forces at once. */
+typedef void mfptlib_energy_and_force_fn(
+    const void* context,
+    int64_t rows,
+    const double* states,
+    int64_t states_stride,
+    double t,
+    double* potential_out,
+    double* force_out,
+    int64_t force_stride
+);
+
+/* Write the masses of every state to out. */
+typedef void mfptlib_masses_fn(
+    const void* context,
+    int64_t rows,
+    const double* states,
+    int64_t states_stride,
+    double* out,
+    int64_t out_stride
+);
+
+/* Release the context once the system is no longer used. */
+typedef void mfptlib_release_fn(void* context);
+
+
+typedef struct mfptlib_plugin
+{
+    /* Must be MFPTLIB_PLUGIN_ABI_VERSION. */
+    uint32_t abi_version;
+
+    /* Passed to all functions, may be null. */
+    void* context;
+
+    int64_t degrees_of_freedom;
+
+    /* Required. */
+    mfptlib_potential_fn* potential;
+    mfptlib_force_fn* force;
+
+    /* Optional, defaults to potential followed by force. */
+    mfptlib_energy_and_force_fn* energy_and_force;
+
+    /* Either state-dependent masses or n constant masses are required.
+     * The constant masses are copied when loading the plugin. */
+    mfptlib_masses_fn* masses;
+    const double* constant_masses;
+
+    /* Optional. */
+    mfptlib_release_fn* release;
+} mfptlib_plugin;
+
+
+/*
+ * Entry point exported by plugin libraries under the name
+ * mfptlib_plugin_init. The options string is passed through from the user.
+ * Return 0 on success and anything else on failure, in which case the
+ * release function is not called.
+ */
+typedef int mfptlib_plugin_init_fn(
+    mfptlib_plugin* plugin, const char* options);
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
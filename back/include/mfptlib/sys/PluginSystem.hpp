@@ -0,0 +1,106 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef MFPTLIB_SYS_PLUGINSYSTEM_HPP
+#define MFPTLIB_SYS_PLUGINSYSTEM_HPP
+
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include <mfptlib/core/Types.hpp>
+#include <mfptlib/sys/Plugin.h>
+#include <mfptlib/sys/System.hpp>
+
+
+namespace mfptlib {
+
+/**
+ * System implemented by an external plugin using the C ABI of Plugin.h.
+ *
+ * Every evaluation is a single call through a function pointer on the whole
+ * ensemble. Copies share the plugin, which is released together with the
+ * last copy.
+ */
+class PluginSystem
+{
+public:
+    // Wrap the functions of plugin and take ownership of its context.
+    // The owner is kept alive until the plugin has been released,
+    // e.g., to keep the code of the functions loaded.
+    explicit PluginSystem(
+        const mfptlib_plugin& plugin, std::shared_ptr<const void> owner = {});
+
+    // Load a plugin from a shared library exporting mfptlib_plugin_init.
+    [[nodiscard]]
+    static auto load(
+        const std::filesystem::path& library, const std::string& options = {}
+    ) -> PluginSystem;
+
+
+    auto plugin() const noexcept -> const mfptlib_plugin&
+    { return state_->plugin; }
+
+    // Empty if the plugin has state-dependent masses.
+    auto constant_masses() const noexcept -> const Vector&
+    { return state_->constant_masses; }
+
+
+private:
+    // Releases the plugin when destroyed.
+    struct State
+    {
+        ~State();
+
+        mfptlib_plugin plugin;
+        Vector constant_masses;
+        std::shared_ptr<const void> owner;
+    };
+
+    std::shared_ptr<const State> state_;
+};
+
+
+[[nodiscard]]
+inline auto degrees_of_freedom(const PluginSystem& model) noexcept -> Index
+{ return model.plugin().degrees_of_freedom; }
+
+// Nothing is known about plugins except whether their masses are constant.
+[[nodiscard]]
+inline auto traits(const PluginSystem& model) noexcept -> SystemTraits
+{ return {.constant_masses = model.constant_masses().size() != 0}; }
+
+
+void potential_into(
+    const PluginSystem& model,
+    const VectorsCRef& states,
+    double t,
+    ScalarsRef out
+) noexcept;
+
+void force_into(
+    const PluginSystem& model,
+    const VectorsCRef& states,
+    double t,
+    VectorsRef out
+) noexcept;
+
+void energy_and_force_into(
+    const PluginSystem& model,
+    const VectorsCRef& states,
+    double t,
+    ScalarsRef potential_out,
+    VectorsRef force_out
+) noexcept;
+
+void masses_into(
+    const PluginSystem& model,
+    const VectorsCRef& states,
+    VectorsRef out
+) noexcept;
+
+} // namespace mfptlib
+
+
+#endif
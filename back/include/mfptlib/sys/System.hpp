@@ -5,6 +5,7 @@
 #ifndef MFPTLIB_SYS_SYSTEM_HPP
 #define MFPTLIB_SYS_SYSTEM_HPP
 
+#include <concepts>
 #include <memory>
 #include <type_traits>
 #include <utility>
@@ -22,6 +23,50 @@ enum class StateType
 };
 
 
+// Properties that allow steppers to skip redundant evaluations.
+// Systems declare them via traits(model), the defaults assume nothing.
+struct SystemTraits
+{
+    // The forces do not depend on the momenta.
+    bool velocity_independent_forces{false};
+    // The masses depend on neither positions nor momenta.
+    bool constant_masses{false};
+    // The potential and the forces do not depend on the time.
+    bool time_independent_potential{false};
+};
+
+
+// Traits of sys, which can be evaluated at compile time for most systems.
+template<typename System>
+constexpr auto system_traits(const System& sys) noexcept -> SystemTraits
+{
+    if constexpr(requires{ { traits(sys) } -> std::same_as<SystemTraits>; })
+        return traits(sys);
+    else
+        return {};
+}
+
+
+// Numbers of DoFs for which statically dispatched kernels are instantiated
+// with states of a fixed number of columns, see FixedVectors.
+template<typename System>
+inline constexpr auto UnrolledDegreesOfFreedom = std::integer_sequence<int>{};
+
+
+// Systems with parameters per state report their number via
+// num_states(sys), which is 0 if all states share the parameters.
+// They also provide filter_states(sys, predicate) and
+// split_states(sys, first), which return systems for the remaining states.
+template<typename System>
+auto system_num_states(const System& sys) -> Index
+{
+    if constexpr(requires{ { num_states(sys) } -> std::same_as<Index>; })
+        return num_states(sys);
+    else
+        return 0;
+}
+
+
 template<typename System>
 void validate_size(
     const System& sys, const VectorsCRef& states, StateType type
@@ -30,15 +75,33 @@ void validate_size(
     Index multiplier = (type == StateType::Full) ? 2 : 1;
     expect(states.cols() == multiplier * degrees_of_freedom(sys),
         "Size of the passed states is incompatible with the system.");
+
+    const Index rows = system_num_states(sys);
+    expect(rows == 0 or states.rows() == rows,
+        "Number of passed states is incompatible with the parameters "
+        "of the system.");
+}
+
+
+template<typename System, typename Output>
+void validate_output(
+    const System& sys, const VectorsCRef& states, const Output& out
+)
+{
+    const Index cols =
+        Output::ColsAtCompileTime == 1 ? 1 : degrees_of_freedom(sys);
+    expect(out.rows() == states.rows() and out.cols() == cols,
+        "Size of the passed output is incompatible with the system.");
 }
 
 
+// Systems are immutable, so copies share the underlying implementation.
 class System
 {
 public:
     template<typename Impl, ProtectSpecial<Impl, System> = true>
     explicit System(Impl&& impl)
-        : pimpl_{std::make_unique<Wrapper<std::decay_t<Impl>>>(
+        : pimpl_{std::make_shared<const Wrapper<std::decay_t<Impl>>>(
             std::forward<Impl>(impl))}
     {}
 
@@ -60,9 +123,88 @@ class System
     ) -> Vectors
     { return sys.pimpl_->do_masses(states); }
 
+    // The *_into() versions write to caller-provided storage of the correct
+    // size, which allows steppers to reuse their buffers between steps.
+    friend void potential_into(
+        const System& sys, const VectorsCRef& states, double t, ScalarsRef out
+    )
+    { sys.pimpl_->do_potential_into(states, t, std::move(out)); }
+
+    friend void force_into(
+        const System& sys, const VectorsCRef& states, double t, VectorsRef out
+    )
+    { sys.pimpl_->do_force_into(states, t, std::move(out)); }
+
+    friend void masses_into(
+        const System& sys, const VectorsCRef& states, VectorsRef out
+    )
+    { sys.pimpl_->do_masses_into(states, std::move(out)); }
+
+    // Potential energy and forces at once, which is cheaper for systems
+    // that share intermediate results between both.
+    [[nodiscard]]
+    friend auto energy_and_force(
+        const System& sys, const VectorsCRef& states, double t
+    ) -> std::pair<Scalars, Vectors>
+    {
+        std::pair<Scalars, Vectors> res{
+            Scalars{states.rows()},
+            Vectors{states.rows(), degrees_of_freedom(sys)},
+        };
+        energy_and_force_into(sys, states, t, res.first, res.second);
+        return res;
+    }
+
+    friend void energy_and_force_into(
+        const System& sys,
+        const VectorsCRef& states,
+        double t,
+        ScalarsRef potential_out,
+        VectorsRef force_out
+    )
+    {
+        sys.pimpl_->do_energy_and_force_into(
+            states, t, std::move(potential_out), std::move(force_out));
+    }
+
     friend auto degrees_of_freedom(const System& sys) -> Index
     { return sys.pimpl_->do_degrees_of_freedom(); }
 
+    friend auto traits(const System& sys) noexcept -> SystemTraits
+    { return sys.pimpl_->do_traits(); }
+
+    friend auto num_states(const System& sys) -> Index
+    { return sys.pimpl_->do_num_states(); }
+
+    // Systems without parameters per state are returned unchanged.
+    [[nodiscard]]
+    friend auto filter_states(
+        const System& sys, const Booleans& predicate
+    ) -> System
+    {
+        auto filtered = sys.pimpl_->do_filter_states(predicate);
+        return filtered ? System{std::move(filtered)} : sys;
+    }
+
+    [[nodiscard]]
+    friend auto split_states(
+        const System& sys, Index first
+    ) -> std::pair<System, System>
+    {
+        auto [head, tail] = sys.pimpl_->do_split_states(first);
+        if(!head)
+            return {sys, sys};
+        return {System{std::move(head)}, System{std::move(tail)}};
+    }
+
+    // Pointer to the underlying implementation if it is of type Impl.
+    template<typename Impl>
+    auto target() const noexcept -> const Impl*
+    {
+        auto* wrapper = dynamic_cast<const Wrapper<Impl>*>(pimpl_.get());
+        return wrapper ? &wrapper->impl() : nullptr;
+    }
+
 
 private:
     struct Interface
@@ -75,7 +217,27 @@ class System
             const VectorsCRef& states, double t) const -> Vectors = 0;
         virtual auto do_masses(
             const VectorsCRef& states) const -> Vectors = 0;
+        virtual void do_potential_into(
+            const VectorsCRef& states, double t, ScalarsRef out) const = 0;
+        virtual void do_force_into(
+            const VectorsCRef& states, double t, VectorsRef out) const = 0;
+        virtual void do_masses_into(
+            const VectorsCRef& states, VectorsRef out) const = 0;
+        virtual void do_energy_and_force_into(
+            const VectorsCRef& states,
+            double t,
+            ScalarsRef potential_out,
+            VectorsRef force_out
+        ) const = 0;
         virtual auto do_degrees_of_freedom() const -> Index = 0;
+        virtual auto do_traits() const noexcept -> SystemTraits = 0;
+        virtual auto do_num_states() const -> Index = 0;
+        // Null if the system does not have parameters per state.
+        virtual auto do_filter_states(const Booleans& predicate) const
+            -> std::shared_ptr<const Interface> = 0;
+        virtual auto do_split_states(Index first) const -> std::pair<
+            std::shared_ptr<const Interface>,
+            std::shared_ptr<const Interface>> = 0;
     };
 
     template<typename Impl>
@@ -92,7 +254,14 @@ class System
         ) const -> Scalars override
         {
             validate_size(impl_, states, StateType::Full);
-            return potential(impl_, states, t);
+            if constexpr(requires{ potential(impl_, states, t); })
+                return potential(impl_, states, t);
+            else
+            {
+                Scalars res{states.rows()};
+                potential_into(impl_, states, t, res);
+                return res;
+            }
         }
 
         auto do_force(
@@ -100,7 +269,14 @@ class System
         ) const -> Vectors override
         {
             validate_size(impl_, states, StateType::Full);
-            return force(impl_, states, t);
+            if constexpr(requires{ force(impl_, states, t); })
+                return force(impl_, states, t);
+            else
+            {
+                Vectors res{states.rows(), degrees_of_freedom(impl_)};
+                force_into(impl_, states, t, res);
+                return res;
+            }
         }
 
         auto do_masses(
@@ -108,19 +284,129 @@ class System
         ) const -> Vectors override
         {
             validate_size(impl_, states, StateType::Full);
-            return masses(impl_, states);
+            if constexpr(requires{ masses(impl_, states); })
+                return masses(impl_, states);
+            else
+            {
+                Vectors res{states.rows(), degrees_of_freedom(impl_)};
+                masses_into(impl_, states, res);
+                return res;
+            }
+        }
+
+        // Systems without *_into() functions write their return values.
+        void do_potential_into(
+            const VectorsCRef& states, double t, ScalarsRef out
+        ) const override
+        {
+            validate_size(impl_, states, StateType::Full);
+            validate_output(impl_, states, out);
+            if constexpr(requires{ potential_into(impl_, states, t, out); })
+                potential_into(impl_, states, t, std::move(out));
+            else
+                out = potential(impl_, states, t);
+        }
+
+        void do_force_into(
+            const VectorsCRef& states, double t, VectorsRef out
+        ) const override
+        {
+            validate_size(impl_, states, StateType::Full);
+            validate_output(impl_, states, out);
+            if constexpr(requires{ force_into(impl_, states, t, out); })
+                force_into(impl_, states, t, std::move(out));
+            else
+                out = force(impl_, states, t);
+        }
+
+        void do_masses_into(
+            const VectorsCRef& states, VectorsRef out
+        ) const override
+        {
+            validate_size(impl_, states, StateType::Full);
+            validate_output(impl_, states, out);
+            if constexpr(requires{ masses_into(impl_, states, out); })
+                masses_into(impl_, states, std::move(out));
+            else
+                out = masses(impl_, states);
+        }
+
+        void do_energy_and_force_into(
+            const VectorsCRef& states,
+            double t,
+            ScalarsRef potential_out,
+            VectorsRef force_out
+        ) const override
+        {
+            if constexpr(requires{ energy_and_force_into(
+                impl_, states, t, potential_out, force_out); })
+            {
+                validate_size(impl_, states, StateType::Full);
+                validate_output(impl_, states, potential_out);
+                validate_output(impl_, states, force_out);
+                energy_and_force_into(impl_, states, t,
+                    std::move(potential_out), std::move(force_out));
+            }
+            else
+            {
+                do_potential_into(states, t, std::move(potential_out));
+                do_force_into(states, t, std::move(force_out));
+            }
         }
 
         auto do_degrees_of_freedom() const -> Index override
         { return degrees_of_freedom(impl_); }
 
+        auto do_traits() const noexcept -> SystemTraits override
+        { return system_traits(impl_); }
+
+        auto do_num_states() const -> Index override
+        { return system_num_states(impl_); }
+
+        auto do_filter_states(const Booleans& predicate) const
+            -> std::shared_ptr<const Interface> override
+        {
+            if constexpr(requires{
+                { filter_states(impl_, predicate) } -> std::same_as<Impl>; })
+                return std::make_shared<const Wrapper>(
+                    filter_states(impl_, predicate));
+            else
+                return nullptr;
+        }
+
+        auto do_split_states(Index first) const -> std::pair<
+            std::shared_ptr<const Interface>,
+            std::shared_ptr<const Interface>> override
+        {
+            if constexpr(requires{ { split_states(impl_, first) }
+                -> std::same_as<std::pair<Impl, Impl>>; })
+            {
+                auto [head, tail] = split_states(impl_, first);
+                return {
+                    std::make_shared<const Wrapper>(std::move(head)),
+                    std::make_shared<const Wrapper>(std::move(tail)),
+                };
+            }
+            else
+                return {nullptr, nullptr};
+        }
+
+        auto impl() const noexcept -> const Impl&
+        { return impl_; }
+
     private:
         Impl impl_;
     };
 
 
 private:
-    std::unique_ptr<Interface> pimpl_;
+    explicit System(std::shared_ptr<const Interface> pimpl) noexcept
+        : pimpl_{std::move(pimpl)}
+    {}
+
+
+private:
+    std::shared_ptr<const Interface> pimpl_;
 };
 
 
@@ -141,6 +427,16 @@ inline auto total_energy(
     return potential(sys, states, t) + kinetic_energy(sys, states);
 }
 
+
+// Predicates and observers keep the system they were created with, which
+// is not compacted along with the states during propagation.
+inline void expect_shared_parameters(const System& sys)
+{
+    expect(num_states(sys) == 0,
+        "Systems with parameters per state cannot be used by predicates or "
+        "observers, since their parameters are compacted during propagation.");
+}
+
 } // namespace mfptlib
 
 #endif
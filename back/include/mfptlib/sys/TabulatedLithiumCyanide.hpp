@@ -0,0 +1,124 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef MFPTLIB_SYS_TABULATEDLITHIUMCYANIDE_HPP
+#define MFPTLIB_SYS_TABULATEDLITHIUMCYANIDE_HPP
+
+#include <filesystem>
+#include <memory>
+
+#include <mfptlib/core/Types.hpp>
+#include <mfptlib/sys/System.hpp>
+
+
+namespace mfptlib {
+
+struct TabulationOptions
+{
+    // Number of grid points for θ in [0, π].
+    Index theta_points{256};
+
+    // Range and number of grid points for R.
+    // States outside of the range are evaluated analytically.
+    double r_min{3.0};
+    double r_max{8.0};
+    Index r_points{256};
+
+    // Directory of the on-disk table cache, an empty path disables it.
+    // Defaults to $XDG_CACHE_HOME/mfptlib or ~/.cache/mfptlib.
+    std::filesystem::path cache_dir{default_cache_dir()};
+
+    static auto default_cache_dir() -> std::filesystem::path;
+};
+
+
+/**
+ * LithiumCyanide with the potential interpolated from a precomputed table.
+ *
+ * V, ∂V/∂θ, ∂V/∂R, and ∂²V/∂θ∂R are evaluated on a regular grid and turned
+ * into the coefficients of a bicubic Hermite polynomial for every grid cell.
+ * The interpolated potential and forces are thus continuous with errors of
+ * order h⁴ and h³ for grid spacing h. The maximum errors against the
+ * analytic LithiumCyanide are measured at the points of every cell where
+ * the 1D interpolation errors peak when building the table, see
+ * max_potential_error() and max_force_error(). For the default options,
+ * they are about 2e-8 and 3e-6 in atomic units, respectively.
+ *
+ * Tables are cached on disk and memory-mapped when they are used again.
+ * Copies share the same table.
+ */
+class TabulatedLithiumCyanide
+{
+public:
+    explicit TabulatedLithiumCyanide(const TabulationOptions& options = {});
+
+    auto max_potential_error() const noexcept -> double;
+    auto max_force_error() const noexcept -> double;
+
+    // Whether the table was loaded from the on-disk cache.
+    auto is_cached() const noexcept -> bool;
+
+    // Opaque table used by the free functions below.
+    struct Table;
+
+    auto table() const noexcept -> const Table&
+    { return *table_; }
+
+
+private:
+    std::shared_ptr<const Table> table_;
+};
+
+
+[[nodiscard]]
+constexpr auto degrees_of_freedom(const TabulatedLithiumCyanide&) noexcept
+    -> Index
+{ return 2; }
+
+
+[[nodiscard]]
+constexpr auto traits(const TabulatedLithiumCyanide&) noexcept -> SystemTraits
+{
+    // The centrifugal term of the R-force depends on p_θ.
+    return {.time_independent_potential = true};
+}
+
+
+template<>
+inline constexpr auto UnrolledDegreesOfFreedom<TabulatedLithiumCyanide> =
+    std::integer_sequence<int, 2>{};
+
+
+void potential_into(
+    const TabulatedLithiumCyanide& model,
+    const VectorsCRef& states,
+    double t,
+    ScalarsRef out
+) noexcept;
+
+void force_into(
+    const TabulatedLithiumCyanide& model,
+    const VectorsCRef& states,
+    double t,
+    VectorsRef out
+) noexcept;
+
+void energy_and_force_into(
+    const TabulatedLithiumCyanide& model,
+    const VectorsCRef& states,
+    double t,
+    ScalarsRef potential_out,
+    VectorsRef force_out
+) noexcept;
+
+void masses_into(
+    const TabulatedLithiumCyanide& model,
+    const VectorsCRef& states,
+    VectorsRef out
+) noexcept;
+
+} // namespace mfptlib
+
+
+#endif
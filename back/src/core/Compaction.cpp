@@ -0,0 +1,232 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include <mfptlib/core/Compaction.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include <mfptlib/core/Errors.hpp>
+
+
+namespace mfptlib {
+
+namespace {
+
+using Word = RowMask::Word;
+
+
+auto mask_bits(
+    const Word* words, bool invert, Index first, Index count
+) noexcept -> unsigned
+{
+    assert(first % RowMask::WordBits + count <= RowMask::WordBits);
+    const Word word = words[first / RowMask::WordBits] ^ (invert ? ~Word{0} : 0);
+    const Word valid = (Word{1} << count) - 1;
+    return static_cast<unsigned>((word >> (first % RowMask::WordBits)) & valid);
+}
+
+
+#if defined(__AVX512F__)
+
+// Compress-store eight 64-bit lanes at a time.
+// The remainder is handled with a masked load, so no scalar loop is needed.
+template<typename T>
+auto compress(
+    const Word* words, bool invert, Index size, const T* src, T* dst
+) noexcept -> Index
+{
+    static_assert(sizeof(T) == 8);
+    constexpr Index Lanes = 8;
+
+    Index written = 0;
+    for(Index i = 0; i < size; i += Lanes)
+    {
+        const Index lanes = std::min(Lanes, size - i);
+        const auto valid = static_cast<__mmask8>((1u << lanes) - 1);
+        const auto bits = static_cast<__mmask8>(
+            mask_bits(words, invert, i, lanes));
+        const __m512i values = _mm512_maskz_loadu_epi64(valid, src + i);
+        _mm512_mask_compressstoreu_epi64(dst + written, bits, values);
+        written += std::popcount(static_cast<unsigned>(bits));
+    }
+
+    return written;
+}
+
+#elif defined(__AVX2__)
+
+// Permutation of 32-bit lanes that packs the selected 64-bit lanes.
+constexpr auto make_permutations() noexcept
+{
+    std::array<std::array<std::int32_t, 8>, 16> table{};
+    for(unsigned bits = 0; bits < 16; ++bits)
+    {
+        std::size_t out = 0;
+        for(std::int32_t lane = 0; lane < 4; ++lane)
+            if(bits & (1u << lane))
+            {
+                table[bits][out++] = 2 * lane;
+                table[bits][out++] = 2 * lane + 1;
+            }
+    }
+    return table;
+}
+
+constexpr auto Permutations = make_permutations();
+
+
+// Lane masks for _mm256_maskload/maskstore with the first n lanes enabled.
+auto first_lanes(Index n) noexcept -> __m256i
+{
+    const __m256i lane = _mm256_setr_epi64x(0, 1, 2, 3);
+    return _mm256_cmpgt_epi64(_mm256_set1_epi64x(n), lane);
+}
+
+
+// Permute four 64-bit lanes at a time and store the selected ones
+// with a masked store, which also covers the remainder.
+template<typename T>
+auto compress(
+    const Word* words, bool invert, Index size, const T* src, T* dst
+) noexcept -> Index
+{
+    static_assert(sizeof(T) == 8);
+    constexpr Index Lanes = 4;
+
+    Index written = 0;
+    for(Index i = 0; i < size; i += Lanes)
+    {
+        const Index lanes = std::min(Lanes, size - i);
+        const unsigned bits = mask_bits(words, invert, i, lanes);
+        const Index selected = std::popcount(bits);
+
+        const __m256i values = _mm256_maskload_epi64(
+            reinterpret_cast<const long long*>(src + i), first_lanes(lanes));
+        const __m256i permutation = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(Permutations[bits].data()));
+        _mm256_maskstore_epi64(
+            reinterpret_cast<long long*>(dst + written),
+            first_lanes(selected),
+            _mm256_permutevar8x32_epi32(values, permutation));
+        written += selected;
+    }
+
+    return written;
+}
+
+#else
+
+template<typename T>
+auto compress(
+    const Word* words, bool invert, Index size, const T* src, T* dst
+) noexcept -> Index
+{
+    // Only selected elements may be written, since dst may be sized
+    // exactly for them (or even be null if none are selected).
+    Index written = 0;
+    for(Index i = 0; i < size; ++i)
+        if(mask_bits(words, invert, i, 1))
+            dst[written++] = src[i];
+
+    return written;
+}
+
+#endif
+
+
+template<typename T>
+void partition(
+    const RowMask& mask, T* data, std::vector<T>& scratch
+) noexcept
+{
+    // The rejected elements have to be saved before compressing in place.
+    [[maybe_unused]] const Index rejected =
+        compress(mask.words(), true, mask.size(), data, scratch.data());
+    [[maybe_unused]] const Index selected =
+        compress(mask.words(), false, mask.size(), data, data);
+    assert(rejected == mask.size() - mask.count());
+    assert(selected == mask.count());
+
+    std::copy(scratch.begin(), scratch.end(), data + mask.count());
+}
+
+} // namespace
+
+
+RowMask::RowMask(const Booleans& predicate)
+    : words_((std::size_t(predicate.size()) + WordBits - 1) / WordBits, 0)
+    , size_{predicate.size()}
+    , count_{0}
+{
+    for(Index i = 0; i < size_; ++i)
+        words_[std::size_t(i / WordBits)] |= Word{predicate[i]} << (i % WordBits);
+
+    for(const Word word : words_)
+        count_ += std::popcount(word);
+}
+
+
+auto compress_rows(VectorsRef array, const RowMask& mask) -> Index
+{
+    expect(array.rows() == mask.size(),
+        "The mask size must match the number of rows.");
+
+    for(Index col = 0; col < array.cols(); ++col)
+    {
+        double* data = array.col(col).data();
+        compress(mask.words(), false, mask.size(), data, data);
+    }
+
+    return mask.count();
+}
+
+
+auto partition_rows(VectorsRef array, const RowMask& mask) -> Index
+{
+    expect(array.rows() == mask.size(),
+        "The mask size must match the number of rows.");
+
+    std::vector<double> scratch(std::size_t(mask.size() - mask.count()));
+    for(Index col = 0; col < array.cols(); ++col)
+        partition(mask, array.col(col).data(), scratch);
+
+    return mask.count();
+}
+
+
+auto partition_rows(IndicesRef array, const RowMask& mask) -> Index
+{
+    expect(array.size() == mask.size(),
+        "The mask size must match the number of rows.");
+
+    std::vector<Index> scratch(std::size_t(mask.size() - mask.count()));
+    partition(mask, array.data(), scratch);
+
+    return mask.count();
+}
+
+
+void scatter_rows(VectorsRef array, const Indices& order)
+{
+    expect(array.rows() == order.size(),
+        "The order size must match the number of rows.");
+
+    Scalars buffer{array.rows()};
+    for(Index col = 0; col < array.cols(); ++col)
+    {
+        buffer(order) = array.col(col);
+        array.col(col) = buffer;
+    }
+}
+
+} // namespace mfptlib
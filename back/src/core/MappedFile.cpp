@@ -0,0 +1,47 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include <mfptlib/core/MappedFile.hpp>
+
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <mfptlib/core/Errors.hpp>
+
+
+namespace mfptlib {
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    expect<std::runtime_error>(fd >= 0,
+        "Cannot open file '" + path.string() + "'.");
+
+    // The mapping stays valid after closing the file descriptor.
+    struct ::stat status{};
+    const bool has_status = ::fstat(fd, &status) == 0;
+    size_ = has_status ? static_cast<std::size_t>(status.st_size) : 0u;
+    void* addr = (has_status and size_ != 0u)
+        ? ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0)
+        : nullptr;
+    ::close(fd);
+
+    expect<std::runtime_error>(has_status and addr != MAP_FAILED,
+        "Cannot map file '" + path.string() + "'.");
+
+    if(addr != nullptr)
+    {
+        bytes_ = std::shared_ptr<const std::byte>{
+            static_cast<const std::byte*>(addr),
+            [size = size_](const std::byte* ptr) noexcept
+                { ::munmap(const_cast<std::byte*>(ptr), size); }
+        };
+    }
+}
+
+} // namespace mfptlib
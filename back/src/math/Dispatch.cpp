@@ -0,0 +1,122 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include <mfptlib/math/Dispatch.hpp>
+
+#include <mfptlib/math/BaoabStepper.hpp>
+#include <mfptlib/math/ExpMemoryBath.hpp>
+#include <mfptlib/math/FastBaoabStepper.hpp>
+#include <mfptlib/math/Kernel.hpp>
+#include <mfptlib/math/LangevinBath.hpp>
+#include <mfptlib/math/LfMiddleStepper.hpp>
+#include <mfptlib/math/PronyMemoryBath.hpp>
+#include <mfptlib/math/TabulatedMemoryBath.hpp>
+#include <mfptlib/sys/EmptyPlane.hpp>
+#include <mfptlib/sys/ExpressionSystem.hpp>
+#include <mfptlib/sys/GridSystem.hpp>
+#include <mfptlib/sys/HarmonicOscillator.hpp>
+#include <mfptlib/sys/LithiumCyanide.hpp>
+#include <mfptlib/sys/PluginSystem.hpp>
+#include <mfptlib/sys/TabulatedLithiumCyanide.hpp>
+
+
+namespace mfptlib {
+
+namespace {
+
+template<typename... Types>
+struct TypeList {};
+
+using Steppers = TypeList<BaoabStepper, FastBaoabStepper, LfMiddleStepper>;
+using Baths = TypeList<
+    LangevinBath,
+    ExpMemoryBath,
+    PronyMemoryBath,
+    TabulatedMemoryBath
+>;
+using Systems = TypeList<
+    LithiumCyanide,
+    TabulatedLithiumCyanide,
+    GridSystem,
+    ExpressionSystem,
+    PluginSystem,
+    HarmonicOscillator,
+    EmptyPlane
+>;
+
+
+// Call func with the implementation wrapped by erased
+// if it is one of the listed types and return its result.
+template<typename Erased, typename Func, typename... Types>
+auto find_target(Erased& erased, TypeList<Types...>, Func&& func) -> bool
+{
+    const auto try_type = [&]<typename Type>(TypeList<Type>)
+    {
+        auto* impl = erased.template target<Type>();
+        return impl != nullptr and func(*impl);
+    };
+    return (... or try_type(TypeList<Types>{}));
+}
+
+
+template<typename StepperT, typename BathT, typename Func>
+auto visit_static(
+    StepperT& stepper, BathT& bath, const System& system, Func&& func
+) -> bool
+{
+    return find_target(stepper, Steppers{}, [&](auto& stepper_impl)
+    {
+        return find_target(bath, Baths{}, [&](auto& bath_impl)
+        {
+            return find_target(system, Systems{}, [&](auto& system_impl)
+            {
+                func(stepper_impl, bath_impl, system_impl);
+                return true;
+            });
+        });
+    });
+}
+
+} // namespace
+
+
+auto has_static_kernel(
+    const Stepper& stepper, const Bath& bath, const System& system
+) noexcept -> bool
+{ return visit_static(stepper, bath, system, [](auto&, auto&, auto&) {}); }
+
+
+auto dispatch_propagate_to(
+    Stepper& stepper, Bath& bath, const System& system,
+    VectorsRef states, double t, double t_end,
+    const Observer& observe
+) -> std::optional<double>
+{
+    std::optional<double> result{};
+    visit_static(stepper, bath, system, [&](auto& impl, auto& bath_impl,
+        auto& system_impl)
+    {
+        result = propagate_to(
+            impl, bath_impl, system_impl, states, t, t_end, observe);
+    });
+    return result;
+}
+
+
+auto dispatch_propagate_while(
+    Stepper& stepper, Bath& bath, const System& system,
+    VectorsRef data, Index state_cols, Index order_col, double t,
+    const Predicate& predicate, const Observer& observe
+) -> std::optional<Scalars>
+{
+    std::optional<Scalars> result{};
+    visit_static(stepper, bath, system, [&](auto& impl, auto& bath_impl,
+        auto& system_impl)
+    {
+        result = propagate_while(impl, bath_impl, system_impl,
+            data, state_cols, order_col, t, predicate, observe);
+    });
+    return result;
+}
+
+} // namespace mfptlib
@@ -3,11 +3,38 @@
 
 #include <mfptlib/math/ExpMemoryBath.hpp>
 
-#include <random>
+#include <cmath>
+#include <utility>
+
+#include <mfptlib/core/Errors.hpp>
 
 
 namespace mfptlib {
 
+ExpMemoryBath::ExpMemoryBath(
+    Scalars kb_t, Scalars friction, Scalars memory, NoiseSource noise
+)
+    : noise_{0.0}
+    , friction_{0.0}
+    , memory_{0.0}
+    , noise_source_{std::move(noise)}
+{
+    expect(kb_t.size() == friction.size() and kb_t.size() == memory.size(),
+        "The numbers of temperatures, frictions, and memory parameters "
+        "must match.");
+    expect((kb_t >= 0.0).all(), "The temperatures kb_t must be >= 0.");
+    expect((friction >= 0.0).all(), "The frictions must be >= 0.");
+    expect((memory >= 0.0).all(), "The memory parameters must be >= 0.");
+
+    Vectors parameters{kb_t.size(), 3};
+    parameters.col(0) = (2 * kb_t * friction).unaryExpr(
+        [](double x){ return std::sqrt(x); });
+    parameters.col(1) = friction;
+    parameters.col(2) = memory;
+    parameters_ = StateParameters{std::move(parameters)};
+}
+
+
 /**
  * GLE bath with a simple Prony-type (🦄) memory kernel.
  * Based on the multistage splitting by Baczewski and Bond with ξ = 1.
@@ -26,6 +53,9 @@ void ExpMemoryBath::apply_forces(
     VectorsRef momenta, const VectorsCRef& masses, double dt
 )
 {
+    if(!parameters_.empty())
+        return apply_state_forces(std::move(momenta), masses, dt);
+
     if(force_.rows() == 0)
         force_ = Vectors::Zero(momenta.rows(), momenta.cols());
     else
@@ -41,13 +71,61 @@ void ExpMemoryBath::apply_forces(
     const double noise_scale = std::sqrt(
         (1 - memory_scale) * (1 - memory_scale) / dt);
 
-    std::normal_distribution normal{0.0, noise_ * noise_scale};
+    random_.resize(masses.rows(), masses.cols());
+    noise_source_.fill(*random_, noise_ * noise_scale);
 
     momenta += h * *force_;
     *force_ *= memory_scale;
     *force_ -= (1 - memory_scale) * friction_ * momenta;
-    *force_ += masses.sqrt() * Vectors::NullaryExpr(
-        masses.rows(), masses.cols(), [&](){ return normal(rng_); });
+    // Unlike Eigen's vectorized sqrt, std::sqrt does not depend on alignment.
+    *force_ += masses.unaryExpr([](double m){ return std::sqrt(m); })
+        * *random_;
+    momenta += h * *force_;
+}
+
+
+// Same splitting as above with a memory time scale per state.
+void ExpMemoryBath::apply_state_forces(
+    VectorsRef momenta, const VectorsCRef& masses, double dt
+)
+{
+    const Index rows = momenta.rows();
+    expect(parameters_.rows() == rows,
+        "Size of the passed momenta is incompatible with the parameters. "
+        "Did you forget to call Bath.reset() or Bath.filter_states()?");
+
+    if(force_.rows() == 0)
+        force_ = Vectors::Zero(rows, momenta.cols());
+    else
+        expect(
+            force_.rows() == rows and force_.cols() == momenta.cols(),
+            "Size of the passed momenta is incompatible with the cached forces. "
+            "Did you forget to call Bath.reset() or Bath.filter_states()?"
+        );
+
+    // Memory, friction, and noise scale per state.
+    const auto parameters = *parameters_;
+    scales_.resize(rows, 3);
+    auto scales = *scales_;
+    for(Index i = 0; i < rows; ++i)
+    {
+        const double tau = parameters(i, 1) * parameters(i, 2);
+        const double memory_scale = std::exp(-dt / tau);
+        scales(i, 0) = memory_scale;
+        scales(i, 1) = (1 - memory_scale) * parameters(i, 1);
+        scales(i, 2) = parameters(i, 0) * std::sqrt(
+            (1 - memory_scale) * (1 - memory_scale) / dt);
+    }
+
+    random_.resize(masses.rows(), masses.cols());
+    noise_source_.fill(*random_, 1.0);
+
+    const double h = 0.5 * dt;
+    momenta += h * *force_;
+    (*force_).colwise() *= scales.col(0);
+    *force_ -= momenta.colwise() * scales.col(1);
+    *force_ += (masses.unaryExpr([](double m){ return std::sqrt(m); })
+        * *random_).colwise() * scales.col(2);
     momenta += h * *force_;
 }
 
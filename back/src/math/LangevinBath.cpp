@@ -3,22 +3,78 @@
 
 #include <mfptlib/math/LangevinBath.hpp>
 
-#include <random>
+#include <cmath>
+#include <utility>
+
+#include <mfptlib/core/Errors.hpp>
 
 
 namespace mfptlib {
 
+LangevinBath::LangevinBath(Scalars kb_t, Scalars friction, NoiseSource noise)
+    : sqrt_kb_t_{0.0}
+    , friction_{0.0}
+    , noise_source_{std::move(noise)}
+{
+    expect(kb_t.size() == friction.size(),
+        "The numbers of temperatures and frictions must match.");
+    expect((kb_t >= 0.0).all(), "The temperatures kb_t must be >= 0.");
+    expect((friction >= 0.0).all(), "The frictions must be >= 0.");
+
+    Vectors parameters{kb_t.size(), 2};
+    parameters.col(0) = kb_t.unaryExpr([](double x){ return std::sqrt(x); });
+    parameters.col(1) = friction;
+    parameters_ = StateParameters{std::move(parameters)};
+}
+
+
 void LangevinBath::apply_forces(
     VectorsRef momenta, const VectorsCRef& masses, double dt
-) noexcept
+)
 {
+    if(!parameters_.empty())
+        return apply_state_forces(std::move(momenta), masses, dt);
+
     const double friction_scale = std::exp(-friction_ * dt);
     const double noise_scale = std::sqrt(1 - friction_scale * friction_scale);
-    std::normal_distribution normal{0.0, sqrt_kb_t_ * noise_scale};
 
+    noise_.resize(masses.rows(), masses.cols());
+    noise_source_.fill(*noise_, sqrt_kb_t_ * noise_scale);
+
+    // Eigen's vectorized sqrt is not correctly rounded with AVX-512, which
+    // would make the results depend on the alignment of the rows.
     momenta *= friction_scale;
-    momenta += masses.sqrt() * Vectors::NullaryExpr(
-        masses.rows(), masses.cols(), [&](){ return normal(rng_); });
+    momenta += masses.unaryExpr([](double m){ return std::sqrt(m); })
+        * *noise_;
+}
+
+
+void LangevinBath::apply_state_forces(
+    VectorsRef momenta, const VectorsCRef& masses, double dt
+)
+{
+    expect(parameters_.rows() == momenta.rows(),
+        "Size of the passed momenta is incompatible with the parameters. "
+        "Did you forget to call Bath.reset() or Bath.filter_states()?");
+
+    // Friction and noise scale per state.
+    const auto parameters = *parameters_;
+    scales_.resize(momenta.rows(), 2);
+    auto scales = *scales_;
+    for(Index i = 0; i < momenta.rows(); ++i)
+    {
+        const double friction_scale = std::exp(-parameters(i, 1) * dt);
+        scales(i, 0) = friction_scale;
+        scales(i, 1) = parameters(i, 0)
+            * std::sqrt(1 - friction_scale * friction_scale);
+    }
+
+    noise_.resize(masses.rows(), masses.cols());
+    noise_source_.fill(*noise_, 1.0);
+
+    momenta.colwise() *= scales.col(0);
+    momenta += (masses.unaryExpr([](double m){ return std::sqrt(m); })
+        * *noise_).colwise() * scales.col(1);
 }
 
 } // namespace mfptlib
@@ -0,0 +1,490 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include <mfptlib/math/NoiseSource.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include <mfptlib/core/Compaction.hpp>
+#include <mfptlib/core/Errors.hpp>
+
+
+namespace mfptlib {
+
+namespace {
+
+constexpr int HalfBlock = NoiseSource::BlockSize / 2;
+
+
+auto splitmix64(std::uint64_t& state) noexcept -> std::uint64_t
+{
+    std::uint64_t z = (state += 0x9e3779b97f4a7c15);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+}
+
+
+// Uniform value in (0, 1] from the upper 52 bits of x.
+// Avoids integer to floating-point conversions, which AVX2 lacks.
+auto to_unit(std::uint64_t x) noexcept -> double
+{ return 2.0 - std::bit_cast<double>((x >> 12) | 0x3ff0000000000000); }
+
+
+// Natural logarithm of u in (0, 1] without branches. Unlike Eigen's
+// vectorized log, this does not trip GCC's uninitialized warnings for
+// AVX-512. The mantissa is reduced to [√½, √2) and log(m) = 2 atanh(f) with
+// f = (m - 1) / (m + 1) is evaluated to about 1e-16 by its series.
+auto log_unit(double u) noexcept -> double
+{
+    const auto bits = std::bit_cast<std::uint64_t>(u);
+    const auto mantissa = std::bit_cast<double>(
+        (bits & 0x000fffffffffffff) | 0x3ff0000000000000);
+    // Exponent to double via the 2⁵² trick, which also avoids conversions.
+    double exponent = std::bit_cast<double>((bits >> 52) | 0x4330000000000000)
+        - (0x1p52 + 1023.0);
+
+    const bool high = mantissa > std::numbers::sqrt2;
+    const double m = high ? 0.5 * mantissa : mantissa;
+    exponent += high ? 1.0 : 0.0;
+
+    const double f = (m - 1.0) / (m + 1.0);
+    const double f2 = f * f;
+    const double series = 1.0 + f2 * (1.0 / 3 + f2 * (1.0 / 5 + f2 * (1.0 / 7
+        + f2 * (1.0 / 9 + f2 * (1.0 / 11 + f2 * (1.0 / 13 + f2 * (1.0 / 15
+        + f2 * (1.0 / 17 + f2 * (1.0 / 19 + f2 * (1.0 / 21))))))))));
+
+    return exponent * std::numbers::ln2 + 2.0 * f * series;
+}
+
+
+// sin and cos of 2πu for u in [0, 1] without branches, so that loops
+// calling it can be vectorized. The argument is reduced to an octant and
+// the Taylor series are accurate to about 1e-16 there.
+void sincos_2pi(double u, double& sin_out, double& cos_out) noexcept
+{
+    const auto quadrant = static_cast<std::int32_t>(4.0 * u + 0.5);
+    const double x = 2.0 * std::numbers::pi
+        * (u - 0.25 * static_cast<double>(quadrant));
+    const double x2 = x * x;
+
+    const double s = x * (1.0 + x2 * (-1.0 / 6 + x2 * (1.0 / 120
+        + x2 * (-1.0 / 5040 + x2 * (1.0 / 362880 + x2 * (-1.0 / 39916800
+        + x2 * (1.0 / 6227020800 + x2 * (-1.0 / 1307674368000))))))));
+    const double c = 1.0 + x2 * (-1.0 / 2 + x2 * (1.0 / 24
+        + x2 * (-1.0 / 720 + x2 * (1.0 / 40320 + x2 * (-1.0 / 3628800
+        + x2 * (1.0 / 479001600 + x2 * (-1.0 / 87178291200
+        + x2 * (1.0 / 20922789888000))))))));
+
+    // Rotate by the quadrant: (c, s), (-s, c), (-c, -s), (s, -c).
+    const std::int32_t q = quadrant & 3;
+    const double sin_base = (q & 1) ? c : s;
+    const double cos_base = (q & 1) ? s : c;
+    sin_out = (q & 2) ? -sin_base : sin_base;
+    cos_out = ((q + 1) & 2) ? -cos_base : cos_base;
+}
+
+} // namespace
+
+
+// Lock-free ring of slots with a single producer and a single consumer.
+// The counts of produced and consumed slots publish the slots to the
+// other side, which waits on them while the ring is full or empty.
+class NoiseSource::Prefetcher
+{
+public:
+    static constexpr std::uint64_t Slots = 2;
+    // Every slot holds the noise of this many calls to fill().
+    static constexpr Index CallsPerSlot = 4;
+
+    explicit Prefetcher(Seed seed)
+        : producer_{[this, source = NoiseSource{seed}]() mutable
+            { produce(source); }}
+    {}
+
+    Prefetcher(const Prefetcher&) = delete;
+    auto operator=(const Prefetcher&) -> Prefetcher& = delete;
+
+    ~Prefetcher() noexcept
+    {
+        stop_.store(true);
+        consumed_.fetch_add(1, std::memory_order_release);
+        consumed_.notify_one();
+    }
+
+    // Size of the slots that the producer starts to fill from now on.
+    void resize(Index size) noexcept
+    { slot_size_.store(std::max(size, Index{BlockSize})); }
+
+    auto slot_size() const noexcept -> Index
+    { return slot_size_.load(); }
+
+    // Fill out with the next values, scaled by stddev.
+    void read(ScalarsRef out, double stddev)
+    {
+        for(Index row = 0; row < out.size();)
+        {
+            const Scalars& slot = current();
+            const Index count = std::min(
+                out.size() - row, slot.size() - position_);
+            out.segment(row, count) = stddev * slot.segment(position_, count);
+            row += count;
+            position_ += count;
+
+            if(position_ == slot.size())
+            {
+                position_ = 0;
+                consumed_.store(++next_, std::memory_order_release);
+                consumed_.notify_one();
+            }
+        }
+    }
+
+
+private:
+    auto current() noexcept -> const Scalars&
+    {
+        auto produced = produced_.load(std::memory_order_acquire);
+        while(produced == next_)
+        {
+            produced_.wait(produced, std::memory_order_acquire);
+            produced = produced_.load(std::memory_order_acquire);
+        }
+        return slots_[next_ % Slots];
+    }
+
+    void produce(NoiseSource& source)
+    {
+        for(std::uint64_t produced = 0;; ++produced)
+        {
+            auto consumed = consumed_.load(std::memory_order_acquire);
+            while(produced - consumed >= Slots and not stop_.load())
+            {
+                consumed_.wait(consumed, std::memory_order_acquire);
+                consumed = consumed_.load(std::memory_order_acquire);
+            }
+            if(stop_.load())
+                return;
+
+            Scalars& slot = slots_[produced % Slots];
+            slot.resize(slot_size_.load());
+            source.fill(slot, 1.0);
+            produced_.store(produced + 1, std::memory_order_release);
+            produced_.notify_one();
+        }
+    }
+
+
+private:
+    std::array<Scalars, Slots> slots_{};
+    std::atomic<Index> slot_size_{BlockSize};
+    std::atomic<std::uint64_t> produced_{0};
+    std::atomic<std::uint64_t> consumed_{0};
+    std::atomic<bool> stop_{false};
+    // Consumer only.
+    std::uint64_t next_{0};
+    Index position_{0};
+    // Declared last, so that it starts after and is joined before the rest.
+    std::jthread producer_;
+};
+
+
+NoiseSource::NoiseSource(
+    Seed seed, NoiseGenerator generator, Prefetch prefetch
+)
+    : generator_{generator}
+    , rng_{seed}
+    , key_{seed}
+{
+    expect(generator != NoiseGenerator::Replay,
+        "Replayed noise requires a buffer.");
+    expect(prefetch == Prefetch::Off
+            or generator == NoiseGenerator::Vectorized,
+        "Only vectorized noise can be prefetched.");
+
+    std::uint64_t state = seed;
+    for(Lane& word : lanes_)
+        for(std::uint64_t& value : word)
+            value = splitmix64(state);
+
+    if(prefetch == Prefetch::On)
+        prefetcher_ = std::make_shared<Prefetcher>(seed);
+}
+
+
+NoiseSource::NoiseSource(Vectors replay)
+    : generator_{NoiseGenerator::Replay}
+    , rng_{0}
+    , replay_{std::make_shared<const Vectors>(std::move(replay))}
+{}
+
+
+void NoiseSource::fill(VectorsRef out, double stddev)
+{
+    switch(generator_)
+    {
+    case NoiseGenerator::Scalar:
+    {
+        std::normal_distribution normal{0.0, stddev};
+        out = Vectors::NullaryExpr(
+            out.rows(), out.cols(), [&](){ return normal(rng_); });
+        return;
+    }
+    case NoiseGenerator::Counter:
+        return fill_counter(out, stddev);
+    case NoiseGenerator::Replay:
+        return fill_replay(out, stddev);
+    case NoiseGenerator::Vectorized:
+        if(prefetcher_)
+            return fill_prefetched(out, stddev);
+        break;
+    }
+
+    for(Index col = 0; col < out.cols(); ++col)
+    {
+        for(Index row = 0; row < out.rows();)
+        {
+            if(position_ == BlockSize)
+                refill();
+
+            const Index count = std::min(
+                out.rows() - row, Index{BlockSize} - position_);
+            out.col(col).segment(row, count) = stddev
+                * Eigen::Map<const Scalars>{block_.data() + position_, count};
+            row += count;
+            position_ += count;
+        }
+    }
+}
+
+
+void NoiseSource::filter_states(const Booleans& predicate)
+{
+    if(prefetcher_ and predicate.size() > 0)
+        prefetcher_->resize(prefetcher_->slot_size()
+            * predicate.count() / predicate.size());
+
+    if(generator_ != NoiseGenerator::Counter
+        and generator_ != NoiseGenerator::Replay)
+        return;
+
+    trajectories(predicate.size());
+    const Index rows = partition_rows(trajectories_, RowMask{predicate});
+    trajectories_.conservativeResize(rows);
+}
+
+
+void NoiseSource::reset() noexcept
+{
+    first_trajectory_ = 0;
+    trajectories_.resize(0);
+}
+
+
+auto NoiseSource::split_states(Index first) -> NoiseSource
+{
+    if(generator_ != NoiseGenerator::Counter
+        and generator_ != NoiseGenerator::Replay)
+        return fork();
+
+    NoiseSource split{*this};
+    if(trajectories_.size() == 0)
+        split.first_trajectory_ += first;
+    else
+    {
+        expect(0 <= first and first <= trajectories_.size(),
+            "The split point must not exceed the number of rows.");
+        split.trajectories_ = trajectories_.tail(trajectories_.size() - first);
+        trajectories_.conservativeResize(first);
+    }
+    return split;
+}
+
+
+void NoiseSource::join_states(NoiseSource&& tail)
+{
+    if(generator_ != NoiseGenerator::Counter
+        and generator_ != NoiseGenerator::Replay)
+        return;
+
+    expect(tail.generator_ == generator_ and tail.key_ == key_
+        and tail.epoch_ == epoch_ and tail.step_ == step_,
+        "Only sources of the same epoch and step can be joined.");
+
+    // Sources that were split but never used still number the rows
+    // consecutively from their first trajectory.
+    if(trajectories_.size() == 0 and tail.trajectories_.size() == 0)
+        return;
+
+    expect(trajectories_.size() != 0 and tail.trajectories_.size() != 0,
+        "Only sources used for the same steps can be joined.");
+    const Index rows = trajectories_.size();
+    trajectories_.conservativeResize(rows + tail.trajectories_.size());
+    trajectories_.tail(tail.trajectories_.size()) = tail.trajectories_;
+}
+
+
+auto NoiseSource::fork() -> NoiseSource
+{
+    if(generator_ == NoiseGenerator::Counter
+        or generator_ == NoiseGenerator::Replay)
+    {
+        NoiseSource forked{*this};
+        forked.reset();
+        ++epoch_;
+        return forked;
+    }
+
+    // Forks never prefetch, since propagation forks a bath for every shard
+    // and tile, which would otherwise start a producer thread each.
+    return NoiseSource{rng_(), generator_};
+}
+
+
+auto NoiseSource::trajectories(Index rows) -> const Indices&
+{
+    if(trajectories_.size() == 0)
+    {
+        expect(first_trajectory_ + rows <= Index{1} << 32,
+            "Counter-based noise supports up to 2^32 trajectories.");
+        trajectories_ = Indices::LinSpaced(
+            rows, first_trajectory_, first_trajectory_ + rows - 1);
+    }
+    else
+        expect(trajectories_.size() == rows,
+            "Size of the passed array is incompatible with the noise source. "
+            "Did you forget to call Bath.reset() or Bath.filter_states()?");
+
+    return trajectories_;
+}
+
+
+// Each Philox block yields the pair of DoFs (2 k, 2 k + 1) of one trajectory
+// at one step. The 128-bit counter holds k (16 bits), the step (48 bits),
+// the fork epoch (32 bits), and the trajectory (32 bits).
+void NoiseSource::fill_counter(VectorsRef out, double stddev)
+{
+    const Indices& ids = trajectories(out.rows());
+    const Index pairs = (out.cols() + 1) / 2;
+    expect(pairs <= Index{1} << 16,
+        "Counter-based noise supports up to 2^17 DoFs.");
+
+    const detail::PhiloxKey key{
+        static_cast<std::uint32_t>(key_),
+        static_cast<std::uint32_t>(key_ >> 32),
+    };
+    const auto step_low = static_cast<std::uint32_t>(step_);
+    const auto step_high = static_cast<std::uint32_t>(step_ >> 32) << 16;
+
+    for(Index pair = 0; pair < pairs; ++pair)
+    {
+        const auto pair_step = static_cast<std::uint32_t>(pair) | step_high;
+        for(Index begin = 0; begin < out.rows(); begin += HalfBlock)
+        {
+            const auto count = static_cast<int>(
+                std::min(out.rows() - begin, Index{HalfBlock}));
+            for(int i = 0; i < count; ++i)
+            {
+                const detail::PhiloxCounter bits = detail::philox4x32({
+                    pair_step, step_low, epoch_,
+                    static_cast<std::uint32_t>(ids[begin + i]),
+                }, key);
+                block_[i] = to_unit(bits[0] | std::uint64_t{bits[1]} << 32);
+                block_[HalfBlock + i] = to_unit(
+                    bits[2] | std::uint64_t{bits[3]} << 32);
+            }
+            box_muller(count);
+
+            using Map = Eigen::Map<const Scalars>;
+            out.col(2 * pair).segment(begin, count) =
+                stddev * Map{block_.data(), count};
+            if(2 * pair + 1 < out.cols())
+                out.col(2 * pair + 1).segment(begin, count) =
+                    stddev * Map{block_.data() + HalfBlock, count};
+        }
+    }
+
+    ++step_;
+}
+
+
+void NoiseSource::fill_replay(VectorsRef out, double stddev)
+{
+    const Indices& ids = trajectories(out.rows());
+    const Vectors& replay = *replay_;
+    const Index first_col = static_cast<Index>(step_) * out.cols();
+    expect<std::runtime_error>(first_col + out.cols() <= replay.cols()
+        and (ids.size() == 0 or ids.maxCoeff() < replay.rows()),
+        "The replayed noise is exhausted.");
+
+    for(Index col = 0; col < out.cols(); ++col)
+        for(Index row = 0; row < out.rows(); ++row)
+            out(row, col) = stddev * replay(ids[row], first_col + col);
+
+    ++step_;
+}
+
+
+void NoiseSource::fill_prefetched(VectorsRef out, double stddev)
+{
+    prefetcher_->resize(out.size() * Prefetcher::CallsPerSlot);
+    for(Index col = 0; col < out.cols(); ++col)
+        prefetcher_->read(out.col(col), stddev);
+}
+
+
+void NoiseSource::refill() noexcept
+{
+    // Local copies avoid possible aliasing with block_.
+    auto [s0, s1, s2, s3] = lanes_;
+    for(int i = 0; i < BlockSize; i += Lanes)
+    {
+        for(int lane = 0; lane < Lanes; ++lane)
+        {
+            block_[i + lane] = to_unit(s0[lane] + s3[lane]);
+
+            const std::uint64_t t = s1[lane] << 17;
+            s2[lane] ^= s0[lane];
+            s3[lane] ^= s1[lane];
+            s1[lane] ^= s2[lane];
+            s0[lane] ^= s3[lane];
+            s2[lane] ^= t;
+            s3[lane] = std::rotl(s3[lane], 45);
+        }
+    }
+    lanes_ = {s0, s1, s2, s3};
+
+    box_muller(HalfBlock);
+    position_ = 0;
+}
+
+
+// Transform uniform values in (0, 1] into standard normal values in place.
+// The first half of block_ holds the radii, the second half the angles.
+void NoiseSource::box_muller(int count) noexcept
+{
+    // std::sqrt gets its own loop, which is not vectorized because of errno.
+    for(int i = 0; i < count; ++i)
+        block_[i] = -2.0 * log_unit(block_[i]);
+    for(int i = 0; i < count; ++i)
+        block_[i] = std::sqrt(block_[i]);
+    for(int i = 0; i < count; ++i)
+    {
+        double sin_value, cos_value;
+        sincos_2pi(block_[HalfBlock + i], sin_value, cos_value);
+        const double r = block_[i];
+        block_[i] = r * cos_value;
+        block_[HalfBlock + i] = r * sin_value;
+    }
+}
+
+} // namespace mfptlib
@@ -0,0 +1,166 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include <mfptlib/math/Predicate.hpp>
+
+#include <cmath>
+#include <numbers>
+#include <utility>
+
+#include <mfptlib/core/Errors.hpp>
+
+
+namespace mfptlib {
+
+namespace {
+
+void validate_interval(double lower, double upper)
+{
+    expect(!(upper < lower),
+        "The upper bound must not be smaller than the lower bound.");
+}
+
+
+void validate_dimension(const VectorsCRef& states, Index dofs)
+{
+    expect(states.cols() == 2 * dofs,
+        "Size of the passed states is incompatible with the predicate.");
+}
+
+
+template<typename Array>
+auto within(const Array& values, double lower, double upper) -> Booleans
+{
+    return lower <= values && values < upper;
+}
+
+} // namespace
+
+
+auto operator&&(Predicate lhs, Predicate rhs) -> Predicate
+{
+    return Predicate{[lhs = std::move(lhs), rhs = std::move(rhs)](
+        const VectorsCRef& states, double t) -> Booleans
+    { return lhs(states, t) && rhs(states, t); }};
+}
+
+
+auto operator||(Predicate lhs, Predicate rhs) -> Predicate
+{
+    return Predicate{[lhs = std::move(lhs), rhs = std::move(rhs)](
+        const VectorsCRef& states, double t) -> Booleans
+    { return lhs(states, t) || rhs(states, t); }};
+}
+
+
+auto operator!(Predicate pred) -> Predicate
+{
+    return Predicate{[pred = std::move(pred)](
+        const VectorsCRef& states, double t) -> Booleans
+    { return !pred(states, t); }};
+}
+
+
+auto coordinate_interval(Index column, double lower, double upper) -> Predicate
+{
+    expect(column >= 0, "The column index must not be negative.");
+    validate_interval(lower, upper);
+
+    return Predicate{[=](const VectorsCRef& states, double) -> Booleans
+    {
+        expect(column < states.cols(),
+            "The column index exceeds the size of the passed states.");
+        return within(states.col(column), lower, upper);
+    }};
+}
+
+
+auto coordinate_box(Vector lower, Vector upper) -> Predicate
+{
+    expect(lower.size() == upper.size(),
+        "The lower and upper corners must have the same size.");
+    expect((lower <= upper).all(),
+        "The upper corner must not be smaller than the lower corner.");
+
+    return Predicate{[lower = std::move(lower), upper = std::move(upper)](
+        const VectorsCRef& states, double) -> Booleans
+    {
+        validate_dimension(states, lower.size());
+        const auto q = positions(states);
+        const Index rows = states.rows();
+        return (q >= lower.replicate(rows, 1) && q < upper.replicate(rows, 1))
+            .rowwise().all();
+    }};
+}
+
+
+auto half_space(Vector normal, double offset) -> Predicate
+{
+    return Predicate{[normal = std::move(normal), offset](
+        const VectorsCRef& states, double) -> Booleans
+    {
+        validate_dimension(states, normal.size());
+        return (positions(states).rowwise() * normal).rowwise().sum() < offset;
+    }};
+}
+
+
+auto radial_distance(Vector center, double lower, double upper) -> Predicate
+{
+    validate_interval(lower, upper);
+
+    // Compare squared distances to avoid the square root.
+    const double lower_sq = lower < 0.0 ? -1.0 : lower * lower;
+    const double upper_sq = upper < 0.0 ? -1.0 : upper * upper;
+
+    return Predicate{[center = std::move(center), lower_sq, upper_sq](
+        const VectorsCRef& states, double) -> Booleans
+    {
+        validate_dimension(states, center.size());
+        const Scalars dist_sq =
+            (positions(states).rowwise() - center).square().rowwise().sum();
+        return within(dist_sq, lower_sq, upper_sq);
+    }};
+}
+
+
+auto angle_window(Index column, double center, double half_width) -> Predicate
+{
+    expect(column >= 0, "The column index must not be negative.");
+
+    return Predicate{[=](const VectorsCRef& states, double) -> Booleans
+    {
+        expect(column < states.cols() / 2,
+            "The column index exceeds the number of positions.");
+        const auto wrap = [](double angle)
+            { return std::remainder(angle, 2.0 * std::numbers::pi); };
+        return positions(states).col(column).unaryExpr(
+            [=](double q) { return wrap(q - center); }).abs() < half_width;
+    }};
+}
+
+
+auto potential_interval(System system, double lower, double upper) -> Predicate
+{
+    expect_shared_parameters(system);
+    validate_interval(lower, upper);
+
+    return Predicate{[system = std::move(system), lower, upper](
+        const VectorsCRef& states, double t) -> Booleans
+    { return within(potential(system, states, t), lower, upper); }};
+}
+
+
+auto total_energy_interval(
+    System system, double lower, double upper
+) -> Predicate
+{
+    expect_shared_parameters(system);
+    validate_interval(lower, upper);
+
+    return Predicate{[system = std::move(system), lower, upper](
+        const VectorsCRef& states, double t) -> Booleans
+    { return within(total_energy(system, states, t), lower, upper); }};
+}
+
+} // namespace mfptlib
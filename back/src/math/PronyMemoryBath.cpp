@@ -0,0 +1,121 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include <mfptlib/math/PronyMemoryBath.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#include <mfptlib/core/Errors.hpp>
+
+
+namespace mfptlib {
+
+namespace {
+
+// Rows updated together, so that all auxiliary forces stay in L1 cache.
+constexpr Index Chunk = 64;
+using ChunkScalars = Eigen::Array<double, Eigen::Dynamic, 1, 0, Chunk, 1>;
+
+} // namespace
+
+
+PronyMemoryBath::PronyMemoryBath(
+    double kb_t, Scalars frictions, Scalars memories, NoiseSource noise
+)
+    : noise_{(2 * kb_t * frictions).unaryExpr(
+        [](double x){ return std::sqrt(x); })}
+    , frictions_{std::move(frictions)}
+    , memories_{std::move(memories)}
+    , noise_source_{std::move(noise)}
+{
+    expect(kb_t >= 0.0, "The temperature kb_t must be >= 0.");
+    expect(frictions_.size() > 0, "At least one memory term is required.");
+    expect(frictions_.size() == memories_.size(),
+        "The number of frictions and memory parameters must match.");
+    expect((frictions_ >= 0.0).all(), "The frictions must be >= 0.");
+    expect((memories_ >= 0.0).all(), "The memory parameters must be >= 0.");
+}
+
+
+/**
+ * GLE bath whose memory kernel is a Prony series, i.e., a sum of K
+ * exponentials. Every term has an auxiliary force that is updated like the
+ * one of ExpMemoryBath with independent noise. The costs are O(K) per step.
+ * All auxiliary forces of a chunk of rows are updated in one pass.
+ *
+ * References:
+ * - Baczewski and Bond, J. Chem. Phys. 139, 044107 (2013):
+ *   https://doi.org/10.1063/1.4815917
+ */
+void PronyMemoryBath::apply_forces(
+    VectorsRef momenta, const VectorsCRef& masses, double dt
+)
+{
+    const Index rows = momenta.rows();
+    const Index cols = momenta.cols();
+    const Index terms = num_terms();
+
+    if(forces_.rows() == 0)
+        forces_ = Vectors::Zero(rows, terms * cols);
+    else
+        expect(forces_.rows() == rows and forces_.cols() == terms * cols,
+            "Size of the passed momenta is incompatible with the cached forces. "
+            "Did you forget to call Bath.reset() or Bath.filter_states()?"
+        );
+
+    const double h = 0.5 * dt;
+    Scalars memory_scales{terms};
+    Scalars couplings{terms};
+
+    random_.resize(rows, terms * cols);
+    for(Index term = 0; term < terms; ++term)
+    {
+        const double tau = frictions_[term] * memories_[term];
+        const double memory_scale = std::exp(-dt / tau);
+        const double noise_scale = std::sqrt(
+            (1 - memory_scale) * (1 - memory_scale) / dt);
+
+        memory_scales[term] = memory_scale;
+        couplings[term] = (1 - memory_scale) * frictions_[term];
+        noise_source_.fill((*random_).middleCols(term * cols, cols),
+            noise_[term] * noise_scale);
+    }
+
+    auto forces = *forces_;
+    const auto random = *random_;
+    for(Index col = 0; col < cols; ++col)
+    {
+        for(Index begin = 0; begin < rows; begin += Chunk)
+        {
+            const Index count = std::min(rows - begin, Chunk);
+            const auto chunk = [&](auto&& array, Index term)
+                { return array.col(term * cols + col).segment(begin, count); };
+
+            auto p = momenta.col(col).segment(begin, count);
+            // Unlike Eigen's vectorized sqrt, std::sqrt is correctly rounded.
+            const ChunkScalars sqrt_masses = masses.col(col)
+                .segment(begin, count)
+                .unaryExpr([](double m){ return std::sqrt(m); });
+
+            ChunkScalars total = chunk(forces, 0);
+            for(Index term = 1; term < terms; ++term)
+                total += chunk(forces, term);
+            p += h * total;
+
+            for(Index term = 0; term < terms; ++term)
+            {
+                auto force = chunk(forces, term);
+                force = memory_scales[term] * force - couplings[term] * p
+                    + sqrt_masses * chunk(random, term);
+                if(term == 0)
+                    total = force;
+                else
+                    total += force;
+            }
+            p += h * total;
+        }
+    }
+}
+
+} // namespace mfptlib
@@ -3,76 +3,628 @@
 
 #include <mfptlib/math/Propagate.hpp>
 
-#include <type_traits>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <thread>
+#include <utility>
+#include <vector>
 
+#include <mfptlib/core/Compaction.hpp>
 #include <mfptlib/core/Errors.hpp>
+#include <mfptlib/math/Dispatch.hpp>
 
 
 namespace mfptlib {
 
 namespace detail {
 
-auto partition_record(
-    Indices& order, VectorsRef states, const Booleans& predicate
-) noexcept -> Index
+auto partition_record(VectorsRef data, const Booleans& predicate) -> Index
 {
-    assert(states.rows() <= order.size());
-    assert(states.rows() == predicate.size());
+    assert(data.rows() == predicate.size());
 
-    Index first = 0;
-    Index last = predicate.size();
+    return partition_rows(data, RowMask{predicate});
+}
+
+
+void restore_order(VectorsRef data, Index order_col)
+{
+    assert(0 <= order_col and order_col < data.cols());
+
+    const Indices order = data.col(order_col).cast<Index>();
+    scatter_rows(data, order);
+}
+
+} // namespace detail
+
+
+namespace {
+
+// Brackets a propagation with Stepper::begin_propagation() and
+// Stepper::end_propagation(), also if the propagation throws.
+class PropagationScope
+{
+public:
+    explicit PropagationScope(Stepper& stepper)
+        : stepper_{stepper}
+    { stepper_.begin_propagation(); }
 
-    for(;; ++first)
+    PropagationScope(const PropagationScope&) = delete;
+    auto operator=(const PropagationScope&) -> PropagationScope& = delete;
+
+    ~PropagationScope()
+    { stepper_.end_propagation(); }
+
+
+private:
+    Stepper& stepper_;
+};
+
+
+// Columns appended to the ensemble for the duration of a propagation:
+// the original index of every state, followed by the per-state data of the
+// stepper and the bath. Compacting the ensemble hence moves all of them in
+// a single pass. They are unbound and removed again, also on errors.
+class PropagationColumns
+{
+public:
+    explicit PropagationColumns(
+        Ensemble& ensemble, Stepper& stepper, Bath& bath
+    )
+        : ensemble_{ensemble}
+        , stepper_{stepper}
+        , bath_{bath}
+        , order_col_{ensemble.data().cols()}
     {
-        for(;; ++first)
+        const Index dofs = ensemble.state_cols() / 2;
+        const Index stepper_cols = stepper.state_columns(dofs);
+        const Index bath_cols = bath.state_columns(dofs);
+        ensemble.add_columns(1 + stepper_cols + bath_cols);
+
+        VectorsRef data = ensemble.data();
+        data.col(order_col_) = Scalars::LinSpaced(
+            data.rows(), 0.0, static_cast<double>(data.rows() - 1));
+
+        try
+        {
+            if(stepper_cols > 0)
+                stepper.bind_columns(
+                    data.middleCols(order_col_ + 1, stepper_cols));
+            if(bath_cols > 0)
+                bath.bind_columns(
+                    data.middleCols(order_col_ + 1 + stepper_cols, bath_cols));
+        }
+        catch(...)
         {
-            if(first == last)
-                return first;
-            if(!predicate[first])
-                break;
+            release();
+            throw;
         }
+    }
+
+    PropagationColumns(const PropagationColumns&) = delete;
+    auto operator=(const PropagationColumns&) -> PropagationColumns& = delete;
 
-        do
+    ~PropagationColumns()
+    { release(); }
+
+    auto order_col() const noexcept -> Index
+    { return order_col_; }
+
+
+private:
+    void release()
+    {
+        stepper_.unbind_columns();
+        bath_.unbind_columns();
+        ensemble_.remove_columns(order_col_);
+    }
+
+
+private:
+    Ensemble& ensemble_;
+    Stepper& stepper_;
+    Bath& bath_;
+    Index order_col_;
+};
+
+
+struct Shard
+{
+    Index begin;
+    Index rows;
+    double t;
+    Stepper stepper;
+    Bath bath;
+    // Systems with parameters per state are filtered along with the states.
+    System system;
+    bool evaluated;
+    bool started;
+
+    // Lazy compaction: finished states remain in the block until the next
+    // compaction. They are marked inactive and their final states are kept
+    // in frozen. An empty mask means that all states are active.
+    // The active states are gathered into observed for the predicate and
+    // the observer.
+    Booleans active{};
+    Vectors frozen{};
+    Vectors observed{};
+};
+
+
+struct ShardContext
+{
+    const Predicate& predicate;
+    const Observer& observe;
+    // States followed by the auxiliary columns of an Ensemble,
+    // including the original indices of the states in column order_col.
+    VectorsRef data;
+    Index state_cols;
+    Index order_col;
+    Scalars& t_end;
+    double compaction_threshold;
+    Index tile_steps;
+};
+
+
+// Distributes shards of the ensemble to the worker threads.
+// With work stealing enabled, a worker that runs out of shards signals
+// that it is idle, and busy workers split off half of their active states
+// at the next step boundary.
+// Finished shards are kept if their state is joined afterwards.
+class ShardQueue
+{
+public:
+    explicit ShardQueue(
+        bool stealing, Index min_split_rows, bool keep_finished
+    ) noexcept
+        : stealing_{stealing}
+        , min_split_rows_{min_split_rows}
+        , keep_finished_{keep_finished}
+    {}
+
+    void push(Shard&& shard)
+    {
         {
-            if(first == --last)
-                return first;
+            const std::lock_guard lock{mutex_};
+            shards_.push_back(std::move(shard));
+            ++pending_;
         }
-        while(!predicate[last]);
+        ready_.notify_one();
+    }
 
-        states.row(first).swap(states.row(last));
-        std::swap(order[first], order[last]);
+    auto pop() -> std::optional<Shard>
+    {
+        std::unique_lock lock{mutex_};
+        if(shards_.empty())
+        {
+            ++idle_;
+            ready_.wait(lock, [&]{ return !shards_.empty() or pending_ == 0; });
+            --idle_;
+        }
+
+        if(shards_.empty())
+            return std::nullopt;
+
+        Shard shard = std::move(shards_.front());
+        shards_.pop_front();
+        return shard;
+    }
+
+    void retire(Shard&& shard)
+    {
+        if(!keep_finished_)
+            return;
+
+        const std::lock_guard lock{mutex_};
+        finished_.push_back(std::move(shard));
+    }
+
+    auto take_finished() noexcept -> std::vector<Shard>
+    { return std::move(finished_); }
+
+    void finish() noexcept
+    {
+        bool done;
+        {
+            const std::lock_guard lock{mutex_};
+            done = (--pending_ == 0);
+        }
+        if(done)
+            ready_.notify_all();
     }
+
+    void fail(std::exception_ptr error) noexcept
+    {
+        const std::lock_guard lock{mutex_};
+        if(!error_)
+            error_ = std::move(error);
+        pending_ -= static_cast<Index>(shards_.size());
+        shards_.clear();
+        failed_ = true;
+    }
+
+    auto failed() const noexcept -> bool
+    { return failed_; }
+
+    auto should_split(Index rows) const noexcept -> bool
+    { return stealing_ and idle_ > 0 and rows >= 2 * min_split_rows_; }
+
+    void rethrow_if_failed() const
+    {
+        if(error_)
+            std::rethrow_exception(error_);
+    }
+
+
+private:
+    const bool stealing_;
+    const Index min_split_rows_;
+    const bool keep_finished_;
+    std::mutex mutex_{};
+    std::condition_variable ready_{};
+    std::deque<Shard> shards_{};
+    std::vector<Shard> finished_{};
+    Index pending_{0};
+    std::atomic<Index> idle_{0};
+    std::atomic<bool> failed_{false};
+    std::exception_ptr error_{};
+};
+
+
+void thaw_states(Shard& shard, VectorsRef states) noexcept
+{
+    for(Index i = 0; i < shard.active.size(); ++i)
+        if(!shard.active[i])
+            states.row(i) = shard.frozen.row(i);
+}
+
+
+// The active states of the shard. With lazy compaction, they are gathered
+// into the observed buffer of the shard, which is valid until the next call.
+auto active_states(ShardContext& context, Shard& shard) -> VectorsCRef
+{
+    const auto states = context.data.middleRows(shard.begin, shard.rows)
+        .leftCols(context.state_cols);
+    if(shard.active.size() == 0)
+        return states;
+
+    if(shard.observed.rows() != shard.rows)
+        shard.observed.resize(shard.rows, states.cols());
+
+    Index num_active = 0;
+    for(Index i = 0; i < shard.rows; ++i)
+        if(shard.active[i])
+            shard.observed.row(num_active++) = states.row(i);
+
+    return shard.observed.topRows(num_active);
 }
 
 
-void restore_order(Indices& order, VectorsRef states) noexcept
+// Evaluate the predicate for all active states of the shard at time t
+// and record the final times of states that stopped.
+// Returns false if no active states remain.
+auto evaluate_shard(
+    ShardQueue& queue, ShardContext& context, Shard& shard
+) -> bool
 {
-    static_assert(std::is_signed_v<Index>);
-    assert(states.rows() == order.size());
+    VectorsRef rows = context.data.middleRows(shard.begin, shard.rows);
+    VectorsRef states = rows.leftCols(context.state_cols);
+    const auto order = rows.col(context.order_col);
+
+    const bool masked = shard.active.size() != 0;
+    Booleans keep_running =
+        context.predicate(active_states(context, shard), shard.t);
+    if(masked)
+    {
+        // Expand the results for the active states to all rows.
+        Booleans expanded = Booleans::Constant(shard.rows, false);
+        for(Index i = 0, j = 0; i < shard.rows; ++i)
+            if(shard.active[i])
+                expanded[i] = keep_running[j++];
+        keep_running = std::move(expanded);
+    }
+
+    for(Index i = 0; i < shard.rows; ++i)
+        if(!keep_running[i] and (!masked or shard.active[i]))
+            context.t_end[static_cast<Index>(order[i])] = shard.t;
+
+    const Index num_active = keep_running.count();
+    const bool split = queue.should_split(num_active);
+    const bool compact = split or num_active == 0 or static_cast<double>(
+        num_active) < context.compaction_threshold * static_cast<double>(
+        shard.rows);
+
+    if(!compact)
+    {
+        if(num_active == shard.rows)
+            return true;
+
+        if(!masked)
+            shard.frozen.resize(shard.rows, states.cols());
+        for(Index i = 0; i < shard.rows; ++i)
+            if(!keep_running[i] and (!masked or shard.active[i]))
+                shard.frozen.row(i) = states.row(i);
+
+        shard.active = std::move(keep_running);
+        return true;
+    }
+
+    thaw_states(shard, states);
+    shard.active.resize(0);
+    shard.frozen.resize(0, 0);
+    shard.observed.resize(0, 0);
+
+    const Index stop = detail::partition_record(rows, keep_running);
+    if(stop == 0)
+        return false;
+    else if(stop != shard.rows)
+    {
+        shard.stepper.filter_states(keep_running);
+        shard.bath.filter_states(keep_running);
+        shard.system = filter_states(shard.system, keep_running);
+        shard.rows = stop;
+    }
 
-    for(Index cycle = 0; cycle < order.size(); ++cycle)
+    if(split)
     {
-        Index current = cycle;
-        while(order[current] != current)
+        const Index half = shard.rows / 2;
+        auto [head, tail] = split_states(shard.system, half);
+        queue.push(Shard{
+            shard.begin + half, shard.rows - half, shard.t,
+            shard.stepper.split_states(half),
+            shard.bath.split_states(half),
+            std::move(tail),
+            true, true,
+        });
+        shard.system = std::move(head);
+        shard.rows = half;
+    }
+
+    return true;
+}
+
+
+// Call the observer with the active states of the shard only.
+void observe_shard(ShardContext& context, Shard& shard)
+{
+    if(context.observe)
+        context.observe(active_states(context, shard), shard.t);
+}
+
+
+// Propagate the shard until all of its states have stopped.
+// With tiling enabled, the shard is put back into the queue after
+// tile_steps steps so that the other tiles can catch up.
+void run_shard(ShardQueue& queue, ShardContext& context, Shard& shard)
+{
+    const auto block = [&]
+    {
+        return context.data.middleRows(shard.begin, shard.rows)
+            .leftCols(context.state_cols);
+    };
+
+    if(!shard.started)
+    {
+        observe_shard(context, shard);
+        shard.started = true;
+    }
+
+    for(Index step = 1; !queue.failed(); ++step)
+    {
+        if(!shard.evaluated and !evaluate_shard(queue, context, shard))
+            return queue.retire(std::move(shard));
+
+        shard.stepper.step(shard.bath, shard.system, block(), shard.t);
+        observe_shard(context, shard);
+        shard.evaluated = false;
+
+        if(step == context.tile_steps)
+            return queue.push(std::move(shard));
+    }
+}
+
+
+void run_worker(ShardQueue& queue, ShardContext& context) noexcept
+{
+    while(std::optional<Shard> shard = queue.pop())
+    {
+        try
+        {
+            run_shard(queue, context, *shard);
+        }
+        catch(...)
         {
-            const Index target = order[current];
-            states.row(cycle).swap(states.row(target));
-            order[current] = current;
-            current = target;
+            queue.fail(std::current_exception());
         }
+        queue.finish();
     }
 }
 
-} // namespace detail
+
+void validate_options(const PropagateOptions& options)
+{
+    expect(options.num_threads >= 1, "The number of threads must be >= 1.");
+    expect(options.min_split_rows >= 1, "The minimum split size must be >= 1.");
+    expect(
+        0.0 <= options.compaction_threshold
+            and options.compaction_threshold <= 1.0,
+        "The compaction threshold must be within [0, 1].");
+    expect(options.tile_rows >= 0, "The tile size must be >= 0.");
+    expect(options.tile_steps >= 1, "The number of tile steps must be >= 1.");
+}
+
+
+// Gather the state of the finished shards into the passed stepper and bath,
+// so that later propagations continue where the shards stopped. This requires
+// that all shards stopped together, i.e., without compacting their states.
+void join_shards(std::vector<Shard> shards, Stepper& stepper, Bath& bath)
+{
+    if(shards.empty())
+        return;
+
+    std::vector<Shard*> sorted;
+    for(Shard& shard : shards)
+        sorted.push_back(&shard);
+    std::ranges::sort(sorted, {}, &Shard::begin);
+
+    Shard& head = *sorted.front();
+    for(Shard* shard : sorted | std::views::drop(1))
+    {
+        assert(shard->begin == head.begin + head.rows);
+        head.stepper.join_states(std::move(shard->stepper));
+        head.bath.join_states(std::move(shard->bath));
+        head.rows += shard->rows;
+    }
+
+    stepper = std::move(head.stepper);
+    bath = std::move(head.bath);
+}
+
+
+// With join set, the forks used for threads or tiles are joined back into
+// the passed stepper and bath, which requires all states to stop together.
+auto propagate_shards(
+    Stepper& stepper, Bath& bath, const System& system,
+    Ensemble& ensemble, double t, const Predicate& predicate,
+    const Observer& observe, const PropagateOptions& options, bool join
+) -> Scalars
+{
+    const PropagationColumns columns{ensemble, stepper, bath};
+    VectorsRef data = ensemble.data();
+    const Index state_cols = ensemble.state_cols();
+    const Index order_col = columns.order_col();
+    VectorsRef states = data.leftCols(state_cols);
+    const bool tiled = options.tile_rows > 0;
+    Scalars t_end{states.rows()};
+    ShardContext context{
+        predicate, observe, data, state_cols, order_col, t_end,
+        options.compaction_threshold, tiled ? options.tile_steps : 0,
+    };
+
+    const Index num_shards = tiled
+        ? (states.rows() + options.tile_rows - 1) / options.tile_rows
+        : std::min(options.num_threads, states.rows());
+    const Index num_threads = std::min(options.num_threads, num_shards);
+    const bool forked = tiled or num_shards > 1;
+    ShardQueue queue{
+        options.schedule == Schedule::WorkStealing, options.min_split_rows,
+        join and forked};
+
+    if(!forked and options.compaction_threshold == 1.0)
+    {
+        // Prefer a precompiled kernel for known implementations.
+        std::optional<Scalars> result = dispatch_propagate_while(
+            stepper, bath, system, data, state_cols, order_col, t,
+            predicate, observe);
+        if(result)
+            return std::move(*result);
+    }
+
+    if(!forked)
+    {
+        // Run on the calling thread using the passed stepper and bath.
+        Shard shard{0, states.rows(), t,
+            std::move(stepper), std::move(bath), system, false, false};
+        const auto give_back = [&]
+        {
+            stepper = std::move(shard.stepper);
+            bath = std::move(shard.bath);
+        };
+
+        try
+        {
+            run_shard(queue, context, shard);
+        }
+        catch(...)
+        {
+            give_back();
+            throw;
+        }
+        give_back();
+    }
+    else
+    {
+        // Forking happens sequentially so that the random streams of the
+        // shards only depend on the state of the bath and the number of shards.
+        // The shards are split off a single fork, so that baths with noise
+        // keyed by the original indices of the states see the same indices.
+        // Shards that are joined afterwards are split off the passed stepper
+        // and bath instead, so that they continue with their per-state data.
+        Stepper remaining_stepper =
+            join ? stepper.split_states(0) : stepper.fork();
+        Bath remaining = join ? bath.split_states(0) : bath.fork();
+        System remaining_system = system;
+        for(Index shard = 0; shard < num_shards; ++shard)
+        {
+            const Index begin = tiled
+                ? shard * options.tile_rows
+                : shard * states.rows() / num_shards;
+            const Index end = tiled
+                ? std::min(begin + options.tile_rows, states.rows())
+                : (shard + 1) * states.rows() / num_shards;
+            Stepper tail_stepper = remaining_stepper.split_states(end - begin);
+            Bath tail = remaining.split_states(end - begin);
+            auto [head_system, tail_system] =
+                split_states(remaining_system, end - begin);
+            queue.push(Shard{begin, end - begin, t,
+                std::move(remaining_stepper), std::move(remaining),
+                std::move(head_system), false, false});
+            remaining_stepper = std::move(tail_stepper);
+            remaining = std::move(tail);
+            remaining_system = std::move(tail_system);
+        }
+
+        if(num_threads <= 1)
+            run_worker(queue, context);
+        else
+        {
+            std::vector<std::jthread> workers;
+            for(Index thread = 0; thread < num_threads; ++thread)
+                workers.emplace_back([&]{ run_worker(queue, context); });
+        }
+        queue.rethrow_if_failed();
+
+        if(join)
+            join_shards(queue.take_finished(), stepper, bath);
+    }
+
+    detail::restore_order(data, order_col);
+
+    return t_end;
+}
+
+} // namespace
 
 
 auto propagate_to(
     Stepper& stepper, Bath& bath, const System& system,
     VectorsRef states, double t, double t_end,
-    const Observer& observe
+    const Observer& observe, const PropagateOptions& options
 ) -> double
 {
     expect(t <= t_end, "Final time t_end must not precede initial time t.");
+    validate_options(options);
+    const PropagationScope scope{stepper};
+
+    if(options.num_threads > 1 or options.tile_rows > 0)
+    {
+        const Predicate before_end{[t_end](const VectorsCRef& s, double t_s)
+            { return Booleans::Constant(s.rows(), t_s < t_end); }};
+        Ensemble ensemble{Vectors{states}};
+        const Scalars t_final = propagate_shards(stepper, bath, system,
+            ensemble, t, before_end, observe, options, true);
+        states = ensemble.states();
+        return t_final.size() > 0 ? t_final.maxCoeff() : t;
+    }
+
+    if(std::optional<double> t_final = dispatch_propagate_to(
+        stepper, bath, system, states, t, t_end, observe))
+        return *t_final;
 
     observe(states, t);
     while(t < t_end)
@@ -88,35 +640,27 @@ auto propagate_to(
 auto propagate_while(
     Stepper& stepper, Bath& bath, const System& system,
     VectorsRef states, double t, const Predicate& predicate,
-    const Observer& observe
+    const Observer& observe, const PropagateOptions& options
 ) -> Scalars
 {
-    VectorsRef all_states{states};
-    Indices order = Indices::LinSpaced(states.rows(), 0, states.rows() - 1);
-    Scalars t_end{states.rows()};
-
-    observe(states, t);
-    while(true)
-    {
-        const Booleans keep_running = predicate(states, t);
-        const Index stop = detail::partition_record(order, states, keep_running);
-        t_end(order.segment(stop, states.rows() - stop)) = t;
-
-        if(stop == 0)
-            break;
-        else if(stop != states.rows())
-        {
-            stepper.filter_states(keep_running);
-            bath.filter_states(keep_running);
-        }
+    Ensemble ensemble{Vectors{states}};
+    Scalars t_end = propagate_while(stepper, bath, system,
+        ensemble, t, predicate, observe, options);
+    states = ensemble.states();
+    return t_end;
+}
 
-        reconstruct(states, all_states.topRows(stop));
-        stepper.step(bath, system, states, t);
-        observe(states, t);
-    }
-    detail::restore_order(order, all_states);
 
-    return t_end;
+auto propagate_while(
+    Stepper& stepper, Bath& bath, const System& system,
+    Ensemble& ensemble, double t, const Predicate& predicate,
+    const Observer& observe, const PropagateOptions& options
+) -> Scalars
+{
+    validate_options(options);
+    const PropagationScope scope{stepper};
+    return propagate_shards(stepper, bath, system,
+        ensemble, t, predicate, observe, options, false);
 }
 
 } // namespace mfptlib
@@ -0,0 +1,382 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include <mfptlib/math/Statistics.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <mfptlib/core/Errors.hpp>
+
+
+namespace mfptlib {
+
+Quantity::Quantity(
+    Kind kind, Index column, std::optional<System> system
+) noexcept
+    : kind_{kind}
+    , column_{column}
+    , system_{std::move(system)}
+{}
+
+
+auto Quantity::coordinates() -> Quantity
+{ return Quantity{Kind::Coordinates, 0, std::nullopt}; }
+
+
+auto Quantity::coordinate(Index column) -> Quantity
+{
+    expect(column >= 0, "The column index must not be negative.");
+    return Quantity{Kind::Coordinate, column, std::nullopt};
+}
+
+
+auto Quantity::kinetic_energy(System system) -> Quantity
+{
+    expect_shared_parameters(system);
+    return Quantity{Kind::KineticEnergy, 0, std::move(system)};
+}
+
+
+auto Quantity::potential(System system) -> Quantity
+{
+    expect_shared_parameters(system);
+    return Quantity{Kind::Potential, 0, std::move(system)};
+}
+
+
+auto Quantity::total_energy(System system) -> Quantity
+{
+    expect_shared_parameters(system);
+    return Quantity{Kind::TotalEnergy, 0, std::move(system)};
+}
+
+
+namespace {
+
+// Buffers of an observer for threads calling it at the same time.
+// Every call takes a buffer from the pool and returns it afterwards,
+// so that there are at most as many buffers as concurrent calls.
+class BufferPool
+{
+public:
+    template<typename Func>
+    void with_buffers(Func&& func)
+    {
+        Quantity::Buffers buffers = acquire();
+        func(buffers);
+        release(std::move(buffers));
+    }
+
+
+private:
+    auto acquire() -> Quantity::Buffers
+    {
+        const std::lock_guard lock{mutex_};
+        if(free_.empty())
+            return Quantity::Buffers();
+
+        Quantity::Buffers buffers = std::move(free_.back());
+        free_.pop_back();
+        return buffers;
+    }
+
+    void release(Quantity::Buffers&& buffers)
+    {
+        const std::lock_guard lock{mutex_};
+        free_.push_back(std::move(buffers));
+    }
+
+
+private:
+    std::mutex mutex_;
+    std::vector<Quantity::Buffers> free_;
+};
+
+} // namespace
+
+
+// ==== MomentsObserver ==== //
+
+struct MomentsObserver::State
+{
+    const Quantity quantity;
+    mutable std::mutex mutex{};
+    Index count{0};
+    Vector mean{};
+    Vector m2{};
+    BufferPool buffers{};
+
+    // Merge the moments of the passed values using Chan's algorithm.
+    template<typename Values>
+    void add(const Values& values)
+    {
+        const Index n = values.rows();
+        if(n == 0)
+            return;
+
+        const std::lock_guard lock{mutex};
+        if(mean.size() == 0)
+        {
+            mean = Vector::Zero(values.cols());
+            m2 = Vector::Zero(values.cols());
+        }
+        expect(values.cols() == mean.size(),
+            "The number of observed values must not change.");
+
+        const auto total = static_cast<double>(count + n);
+        const auto fraction = static_cast<double>(n) / total;
+        const auto weight = static_cast<double>(count) * fraction;
+        for(Index col = 0; col < mean.size(); ++col)
+        {
+            const double block_mean = values.col(col).mean();
+            const double delta = block_mean - mean[col];
+            mean[col] += delta * fraction;
+            m2[col] += (values.col(col) - block_mean).square().sum()
+                + delta * delta * weight;
+        }
+        count += n;
+    }
+};
+
+
+MomentsObserver::MomentsObserver(Quantity quantity)
+    : state_{std::make_shared<State>(std::move(quantity))}
+{}
+
+
+MomentsObserver::operator Observer() const
+{
+    return Observer{[state = state_](const VectorsCRef& states, double t)
+    {
+        state->buffers.with_buffers([&](Quantity::Buffers& buffers)
+        {
+            state->quantity.visit(states, t, buffers,
+                [&](const auto& values) { state->add(values); });
+        });
+    }};
+}
+
+
+auto MomentsObserver::count() const -> Index
+{
+    const std::lock_guard lock{state_->mutex};
+    return state_->count;
+}
+
+
+auto MomentsObserver::mean() const -> Vector
+{
+    const std::lock_guard lock{state_->mutex};
+    return state_->mean;
+}
+
+
+auto MomentsObserver::variance() const -> Vector
+{
+    const std::lock_guard lock{state_->mutex};
+    if(state_->count < 2)
+        return Vector::Constant(state_->m2.size(),
+            std::numeric_limits<double>::quiet_NaN());
+    return state_->m2 / static_cast<double>(state_->count - 1);
+}
+
+
+void MomentsObserver::reset()
+{
+    const std::lock_guard lock{state_->mutex};
+    state_->count = 0;
+    state_->mean.resize(0);
+    state_->m2.resize(0);
+}
+
+
+// ==== HistogramObserver ==== //
+
+struct HistogramObserver::State
+{
+    const Quantity quantity;
+    const double lower;
+    const double upper;
+    Indices counts;
+    Index underflow{0};
+    Index overflow{0};
+    mutable std::mutex mutex{};
+    BufferPool buffers{};
+
+    template<typename Values>
+    void add(const Values& values)
+    {
+        const Index bins = counts.size();
+        const double scale = static_cast<double>(bins) / (upper - lower);
+
+        const std::lock_guard lock{mutex};
+        for(Index i = 0; i < values.rows(); ++i)
+        {
+            const double value = values(i, 0);
+            if(value < lower)
+                ++underflow;
+            else if(value >= upper)
+                ++overflow;
+            else if(!std::isnan(value))
+            {
+                // Rounding may yield an out-of-range bin for values near upper.
+                const auto bin = static_cast<Index>((value - lower) * scale);
+                ++counts[std::min(bin, bins - 1)];
+            }
+        }
+    }
+};
+
+
+HistogramObserver::HistogramObserver(
+    Quantity quantity, double lower, double upper, Index bins
+)
+{
+    expect(quantity.width() == 1,
+        "Histograms can only be accumulated for scalar quantities.");
+    expect(std::isfinite(lower) and std::isfinite(upper) and lower < upper,
+        "The histogram range must be finite and non-empty.");
+    expect(bins >= 1, "The number of bins must be >= 1.");
+
+    state_ = std::make_shared<State>(
+        std::move(quantity), lower, upper, Indices{Indices::Zero(bins)});
+}
+
+
+HistogramObserver::operator Observer() const
+{
+    return Observer{[state = state_](const VectorsCRef& states, double t)
+    {
+        state->buffers.with_buffers([&](Quantity::Buffers& buffers)
+        {
+            state->quantity.visit(states, t, buffers,
+                [&](const auto& values) { state->add(values); });
+        });
+    }};
+}
+
+
+auto HistogramObserver::edges() const -> Scalars
+{
+    return Scalars::LinSpaced(
+        state_->counts.size() + 1, state_->lower, state_->upper);
+}
+
+
+auto HistogramObserver::counts() const -> Indices
+{
+    const std::lock_guard lock{state_->mutex};
+    return state_->counts;
+}
+
+
+auto HistogramObserver::underflow() const -> Index
+{
+    const std::lock_guard lock{state_->mutex};
+    return state_->underflow;
+}
+
+
+auto HistogramObserver::overflow() const -> Index
+{
+    const std::lock_guard lock{state_->mutex};
+    return state_->overflow;
+}
+
+
+void HistogramObserver::reset()
+{
+    const std::lock_guard lock{state_->mutex};
+    state_->counts.setZero();
+    state_->underflow = 0;
+    state_->overflow = 0;
+}
+
+
+// ==== SurvivalObserver ==== //
+
+struct SurvivalObserver::State
+{
+    mutable std::mutex mutex{};
+    std::vector<double> times{};
+    std::vector<Index> counts{};
+
+    void add(Index rows, double t)
+    {
+        const std::lock_guard lock{mutex};
+
+        // Blocks propagated by different threads may lag behind.
+        if(times.empty() or times.back() < t)
+        {
+            times.push_back(t);
+            counts.push_back(rows);
+            return;
+        }
+
+        const auto it = std::lower_bound(times.begin(), times.end(), t);
+        const auto pos = it - times.begin();
+        if(*it == t)
+            counts[std::size_t(pos)] += rows;
+        else
+        {
+            times.insert(it, t);
+            counts.insert(counts.begin() + pos, rows);
+        }
+    }
+};
+
+
+SurvivalObserver::SurvivalObserver()
+    : state_{std::make_shared<State>()}
+{}
+
+
+SurvivalObserver::operator Observer() const
+{
+    return Observer{[state = state_](const VectorsCRef& states, double t)
+        { state->add(states.rows(), t); }};
+}
+
+
+auto SurvivalObserver::times() const -> Scalars
+{
+    const std::lock_guard lock{state_->mutex};
+    return Eigen::Map<const Scalars>(
+        state_->times.data(), Index(state_->times.size()));
+}
+
+
+auto SurvivalObserver::counts() const -> Indices
+{
+    const std::lock_guard lock{state_->mutex};
+    return Eigen::Map<const Indices>(
+        state_->counts.data(), Index(state_->counts.size()));
+}
+
+
+void SurvivalObserver::reset()
+{
+    const std::lock_guard lock{state_->mutex};
+    state_->times.clear();
+    state_->counts.clear();
+}
+
+
+auto combine_observers(std::vector<Observer> observers) -> Observer
+{
+    std::erase_if(observers, [](const Observer& obs) { return !obs; });
+
+    return Observer{[observers = std::move(observers)](
+        const VectorsCRef& states, double t)
+    {
+        for(const Observer& observe : observers)
+            observe(states, t);
+    }};
+}
+
+} // namespace mfptlib
@@ -0,0 +1,282 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include <mfptlib/math/TabulatedMemoryBath.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+
+#include <unsupported/Eigen/FFT>
+
+#include <mfptlib/core/Errors.hpp>
+
+
+namespace mfptlib {
+
+namespace {
+
+using FftVector = Eigen::VectorXd;
+using Spectrum = Eigen::VectorXcd;
+
+
+auto make_fft() -> Eigen::FFT<double>
+{
+    Eigen::FFT<double> fft;
+    fft.SetFlag(Eigen::FFT<double>::HalfSpectrum);
+    return fft;
+}
+
+
+auto fft_size(Index size) -> Index
+{ return static_cast<Index>(std::bit_ceil(static_cast<std::size_t>(size))); }
+
+
+// Index of step in a ring buffer of the given length.
+auto slot(Index step, Index length) noexcept -> Index
+{ return (step % length + length) % length; }
+
+} // namespace
+
+
+struct TabulatedMemoryBath::Spectra
+{
+    // Trapezoidal quadrature weights of the memory integral.
+    Scalars weights;
+    // Length of the filter turning white noise into colored noise.
+    Index filter_size;
+    Index block_size;
+    Index momenta_length;
+    Index white_length;
+    // Sizes and half spectra of the zero-padded weights and filter.
+    Index memory_fft_size;
+    Index noise_fft_size;
+    Spectrum memory_spectrum;
+    Spectrum noise_spectrum;
+};
+
+
+/**
+ * The memory force at step n is the convolution Σ_j w_j p_{n-j} of the
+ * past momenta with the kernel weights w_j = dt K(j dt), halved for j = 0.
+ * Momenta before the current block of B steps contribute through one FFT
+ * per block (overlap-save), the momenta within the block directly. For a
+ * kernel with N values, this costs O(N log N / B + B) per step, which is
+ * minimized by B ≈ (N log N)^½. Unlike the noise, the momenta of a block
+ * are not known in advance, which rules out larger blocks.
+ *
+ * The colored noise R_n = Σ_j g_j ξ_{n-j} filters white noise ξ with the
+ * "square root" g of the covariance kb_t K(|n - m| dt). It is obtained by
+ * circulant embedding: with the spectrum S of the symmetrically extended
+ * covariance, the inverse FFT of S^½ is centered to give g. The noise is
+ * generated in blocks by overlap-save as well. Its autocorrelation is
+ * exact if the kernel has decayed at the end of the table and S ≥ 0.
+ *
+ * References:
+ * - Wood and Chan, J. Comput. Graph. Stat. 3(4), 409-432 (1994):
+ *   https://doi.org/10.1080/10618600.1994.10474655
+ * - Press et al., Numerical Recipes, 3rd ed., sec. 13.1 (2007)
+ */
+TabulatedMemoryBath::TabulatedMemoryBath(
+    double kb_t, Scalars kernel, double dt, NoiseSource noise
+)
+    : dt_{dt}
+    , noise_source_{std::move(noise)}
+{
+    expect(kb_t >= 0.0, "The temperature kb_t must be >= 0.");
+    expect(dt > 0.0, "The time step dt must be > 0.");
+    expect(kernel.size() > 0, "The kernel must have at least one value.");
+    expect(kernel.isFinite().all(), "The kernel must be finite.");
+
+    const Index size = kernel.size();
+    auto spectra = std::make_shared<Spectra>();
+    spectra->weights = dt * kernel;
+    spectra->weights[0] *= 0.5;
+
+    const auto log_size = std::log2(static_cast<double>(size) + 1.0);
+    spectra->block_size = fft_size(static_cast<Index>(
+        std::sqrt(static_cast<double>(size) * log_size)));
+    const Index block = spectra->block_size;
+
+    // Symmetric extension of the covariance of length 2 (N - 1).
+    const Index filter_size = std::max(2 * (size - 1), Index{1});
+    spectra->filter_size = filter_size;
+    FftVector covariance{filter_size};
+    for(Index i = 0; i < filter_size; ++i)
+        covariance[i] = kb_t * kernel[std::min(i, filter_size - i)];
+
+    Eigen::FFT<double> full_fft;
+    Spectrum covariance_spectrum;
+    full_fft.fwd(covariance_spectrum, covariance);
+    const Spectrum sqrt_spectrum = covariance_spectrum.unaryExpr(
+        [](std::complex<double> s)
+            { return std::complex{std::sqrt(std::max(s.real(), 0.0)), 0.0}; });
+    Eigen::VectorXcd root;
+    full_fft.inv(root, sqrt_spectrum);
+
+    auto fft = make_fft();
+    spectra->memory_fft_size = fft_size(size - 1 + block);
+    FftVector padded_weights =
+        FftVector::Zero(spectra->memory_fft_size);
+    padded_weights.head(size) = spectra->weights.matrix();
+    fft.fwd(spectra->memory_spectrum, padded_weights);
+
+    spectra->noise_fft_size = fft_size(filter_size - 1 + block);
+    FftVector padded_filter = FftVector::Zero(spectra->noise_fft_size);
+    for(Index i = 0; i < filter_size; ++i)
+        padded_filter[i] = root[(i + filter_size / 2) % filter_size].real();
+    fft.fwd(spectra->noise_spectrum, padded_filter);
+
+    spectra->momenta_length = size - 1 + block;
+    spectra->white_length =
+        (filter_size - 1 + block + block - 1) / block * block;
+    spectra_ = std::move(spectra);
+}
+
+
+auto TabulatedMemoryBath::block_size() const noexcept -> Index
+{ return spectra_->block_size; }
+
+
+void TabulatedMemoryBath::apply_forces(
+    VectorsRef momenta, const VectorsCRef& masses, double dt
+)
+{
+    expect(std::abs(dt - dt_) <= 1e-12 * dt_,
+        "The time step must match the one of the tabulated kernel.");
+
+    const Spectra& spectra = *spectra_;
+    const Index rows = momenta.rows();
+    const Index cols = momenta.cols();
+    const Index block = spectra.block_size;
+    const Index momenta_length = spectra.momenta_length;
+
+    if(momenta_.rows() == 0)
+    {
+        momenta_ = Vectors::Zero(rows, cols * momenta_length);
+        white_ = Vectors::Zero(rows, cols * spectra.white_length);
+        memory_ = Vectors::Zero(rows, cols * block);
+        colored_ = Vectors::Zero(rows, cols * block);
+        draw_past_noise(cols);
+    }
+    else
+        expect(
+            momenta_.rows() == rows
+                and momenta_.cols() == cols * momenta_length,
+            "Size of the passed momenta is incompatible with the cached "
+            "momenta. Did you forget to call Bath.reset() or "
+            "Bath.filter_states()?"
+        );
+
+    const Index offset = step_ % block;
+    if(offset == 0)
+        start_block(cols);
+
+    auto history = *momenta_;
+    for(Index col = 0; col < cols; ++col)
+        history.col(col * momenta_length + slot(step_, momenta_length)) =
+            momenta.col(col);
+
+    // Contributions of the current block are added directly.
+    friction_.resize(rows, cols);
+    for(Index col = 0; col < cols; ++col)
+    {
+        auto friction = (*friction_).col(col);
+        friction = (*memory_).col(col * block + offset);
+        const Index lags = std::min(offset + 1, spectra.weights.size());
+        for(Index lag = 0; lag < lags; ++lag)
+            friction += spectra.weights[lag] * history.col(
+                col * momenta_length + slot(step_ - lag, momenta_length));
+    }
+
+    // Unlike Eigen's vectorized sqrt, std::sqrt is correctly rounded.
+    for(Index col = 0; col < cols; ++col)
+        momenta.col(col) += dt * (masses.col(col).unaryExpr(
+                [](double m){ return std::sqrt(m); })
+            * (*colored_).col(col * block + offset) - (*friction_).col(col));
+
+    ++step_;
+}
+
+
+// The centered filter of the colored noise reaches M - 1 steps into the
+// past. Drawing the white noise of these steps makes the colored noise
+// stationary from the first step on instead of ramping up from zero.
+void TabulatedMemoryBath::draw_past_noise(Index cols)
+{
+    const Index past = spectra_->filter_size - 1;
+    const Index white_length = spectra_->white_length;
+    if(past == 0)
+        return;
+
+    Vectors white{white_.rows(), past};
+    for(Index col = 0; col < cols; ++col)
+    {
+        noise_source_.fill(white, 1.0);
+        for(Index i = 0; i < past; ++i)
+            (*white_).col(col * white_length
+                + slot(step_ - past + i, white_length)) = white.col(i);
+    }
+}
+
+
+// Draw the white noise of the next block and evaluate the convolutions
+// that only depend on values before it, one state and DoF at a time.
+void TabulatedMemoryBath::start_block(Index cols)
+{
+    const Spectra& spectra = *spectra_;
+    const Index rows = momenta_.rows();
+    const Index block = spectra.block_size;
+    const Index kernel_size = spectra.weights.size();
+    const Index filter_size = spectra.filter_size;
+    const Index momenta_length = spectra.momenta_length;
+    const Index white_length = spectra.white_length;
+
+    // The ring length is a multiple of the block size, so blocks are
+    // contiguous.
+    auto white = *white_;
+    for(Index col = 0; col < cols; ++col)
+        noise_source_.fill(white.middleCols(
+            col * white_length + slot(step_, white_length), block), 1.0);
+
+    auto fft = make_fft();
+    FftVector memory_input = FftVector::Zero(spectra.memory_fft_size);
+    FftVector noise_input = FftVector::Zero(spectra.noise_fft_size);
+    FftVector output;
+    Spectrum spectrum;
+    const auto history = *momenta_;
+    auto memory = *memory_;
+    auto colored = *colored_;
+
+    for(Index col = 0; col < cols; ++col)
+    {
+        for(Index row = 0; row < rows; ++row)
+        {
+            // Momenta p_{s-N+1}, ..., p_{s-1} contribute to steps s + i
+            // through the output at i + N - 1.
+            for(Index i = 0; i < kernel_size - 1; ++i)
+                memory_input[i] = history(row, col * momenta_length
+                    + slot(step_ - kernel_size + 1 + i, momenta_length));
+            fft.fwd(spectrum, memory_input);
+            spectrum = spectrum.cwiseProduct(spectra.memory_spectrum);
+            fft.inv(output, spectrum, spectra.memory_fft_size);
+            memory.row(row).segment(col * block, block) =
+                output.segment(kernel_size - 1, block).transpose().array();
+
+            // White noise ξ_{s-M+1}, ..., ξ_{s+B-1} gives the colored noise
+            // of steps s + i at i + M - 1.
+            for(Index i = 0; i < filter_size - 1 + block; ++i)
+                noise_input[i] = white(row, col * white_length
+                    + slot(step_ - filter_size + 1 + i, white_length));
+            fft.fwd(spectrum, noise_input);
+            spectrum = spectrum.cwiseProduct(spectra.noise_spectrum);
+            fft.inv(output, spectrum, spectra.noise_fft_size);
+            colored.row(row).segment(col * block, block) =
+                output.segment(filter_size - 1, block).transpose().array();
+        }
+    }
+}
+
+} // namespace mfptlib
@@ -0,0 +1,792 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include <mfptlib/sys/ExpressionSystem.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <numbers>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <mfptlib/core/Errors.hpp>
+
+
+namespace mfptlib {
+
+namespace {
+
+// Number of states evaluated at once. The intermediate results
+// of all instructions for a chunk should stay in the cache.
+constexpr Index ChunkSize = 256;
+
+
+enum class Op : std::uint8_t
+{
+    Add, Sub, Mul, Div, Pow,
+    Neg, Square, Sin, Cos, Tan, Sinh, Cosh, Tanh, Atan, Exp, Log, Sqrt, Abs,
+};
+
+
+struct Operand
+{
+    enum Kind : std::uint8_t
+    {
+        Constant, Time, Position, Register,
+    };
+
+    Kind kind{Constant};
+    Index index{0};
+    double value{0.0};
+};
+
+
+// The result of every instruction is stored in its own register, i.e.,
+// the register with the same index, to keep it for the backward pass.
+struct Instruction
+{
+    Op op;
+    Operand lhs;
+    Operand rhs; // Unused by unary operations.
+    bool differentiable; // Whether the result depends on the positions.
+};
+
+} // namespace
+
+
+struct ExpressionSystem::Program
+{
+    std::vector<Instruction> code;
+    Operand result;
+    Index degrees_of_freedom;
+    bool time_dependent{false};
+};
+
+
+namespace {
+
+using std::abs, std::atan, std::cos, std::cosh, std::exp, std::log;
+using std::sin, std::sinh, std::sqrt, std::tan, std::tanh;
+
+using Column = Eigen::Map<Scalars>;
+using ConstColumn = Eigen::Map<const Scalars>;
+
+
+auto sign(double x) noexcept -> double
+{ return static_cast<double>((0.0 < x) - (x < 0.0)); }
+
+
+// Element-wise std::pow. Eigen's vectorized pow triggers -Wuninitialized
+// false positives in the AVX-512 intrinsics with GCC 12.
+auto power(double a, double b) noexcept -> double
+{ return std::pow(a, b); }
+
+template<typename Base>
+auto power(const Eigen::ArrayBase<Base>& a, double b) noexcept
+{ return a.unaryExpr([b](double x) { return std::pow(x, b); }); }
+
+template<typename Exponent>
+auto power(double a, const Eigen::ArrayBase<Exponent>& b) noexcept
+{ return b.unaryExpr([a](double y) { return std::pow(a, y); }); }
+
+template<typename Base, typename Exponent>
+auto power(
+    const Eigen::ArrayBase<Base>& a, const Eigen::ArrayBase<Exponent>& b
+) noexcept
+{
+    return a.binaryExpr(b, [](double x, double y) { return std::pow(x, y); });
+}
+
+
+struct NoPartial
+{
+    auto operator()(const auto&...) const noexcept -> double
+    { return 0.0; }
+};
+
+
+// Evaluation and differentiation rules for operands a and b,
+// which are either scalars or columns.
+// - eval(a, b) returns the result r.
+// - d0(a, b, r, g) and d1(a, b, r, g) return the contribution
+//   of the adjoint g of r to the adjoints of a and b, respectively.
+template<typename Eval, typename D0, typename D1 = NoPartial>
+struct Rule
+{
+    Eval eval;
+    D0 d0;
+    D1 d1{};
+};
+
+template<typename Eval, typename D0>
+Rule(Eval, D0) -> Rule<Eval, D0>;
+
+template<typename Eval, typename D0, typename D1>
+Rule(Eval, D0, D1) -> Rule<Eval, D0, D1>;
+
+
+template<typename Func>
+void with_rule(Op op, Func&& func)
+{
+    switch(op)
+    {
+    case Op::Add:
+        return func(Rule{
+            [](const auto& a, const auto& b) { return a + b; },
+            [](const auto&, const auto&, const auto&, const auto& g)
+            { return g; },
+            [](const auto&, const auto&, const auto&, const auto& g)
+            { return g; },
+        });
+    case Op::Sub:
+        return func(Rule{
+            [](const auto& a, const auto& b) { return a - b; },
+            [](const auto&, const auto&, const auto&, const auto& g)
+            { return g; },
+            [](const auto&, const auto&, const auto&, const auto& g)
+            { return -g; },
+        });
+    case Op::Mul:
+        return func(Rule{
+            [](const auto& a, const auto& b) { return a * b; },
+            [](const auto&, const auto& b, const auto&, const auto& g)
+            { return g * b; },
+            [](const auto& a, const auto&, const auto&, const auto& g)
+            { return g * a; },
+        });
+    case Op::Div:
+        return func(Rule{
+            [](const auto& a, const auto& b) { return a / b; },
+            [](const auto&, const auto& b, const auto&, const auto& g)
+            { return g / b; },
+            [](const auto&, const auto& b, const auto& r, const auto& g)
+            { return -g * r / b; },
+        });
+    case Op::Pow:
+        return func(Rule{
+            [](const auto& a, const auto& b) { return power(a, b); },
+            [](const auto& a, const auto& b, const auto&, const auto& g)
+            { return g * b * power(a, b - 1.0); },
+            [](const auto& a, const auto&, const auto& r, const auto& g)
+            { return g * r * log(a); },
+        });
+    case Op::Neg:
+        return func(Rule{
+            [](const auto& a, const auto&) { return -a; },
+            [](const auto&, const auto&, const auto&, const auto& g)
+            { return -g; },
+        });
+    case Op::Square:
+        return func(Rule{
+            [](const auto& a, const auto&) { return a * a; },
+            [](const auto& a, const auto&, const auto&, const auto& g)
+            { return 2.0 * g * a; },
+        });
+    case Op::Sin:
+        return func(Rule{
+            [](const auto& a, const auto&) { return sin(a); },
+            [](const auto& a, const auto&, const auto&, const auto& g)
+            { return g * cos(a); },
+        });
+    case Op::Cos:
+        return func(Rule{
+            [](const auto& a, const auto&) { return cos(a); },
+            [](const auto& a, const auto&, const auto&, const auto& g)
+            { return -g * sin(a); },
+        });
+    case Op::Tan:
+        return func(Rule{
+            [](const auto& a, const auto&) { return tan(a); },
+            [](const auto&, const auto&, const auto& r, const auto& g)
+            { return g * (1.0 + r * r); },
+        });
+    case Op::Sinh:
+        return func(Rule{
+            [](const auto& a, const auto&) { return sinh(a); },
+            [](const auto& a, const auto&, const auto&, const auto& g)
+            { return g * cosh(a); },
+        });
+    case Op::Cosh:
+        return func(Rule{
+            [](const auto& a, const auto&) { return cosh(a); },
+            [](const auto& a, const auto&, const auto&, const auto& g)
+            { return g * sinh(a); },
+        });
+    case Op::Tanh:
+        return func(Rule{
+            [](const auto& a, const auto&) { return tanh(a); },
+            [](const auto&, const auto&, const auto& r, const auto& g)
+            { return g * (1.0 - r * r); },
+        });
+    case Op::Atan:
+        return func(Rule{
+            [](const auto& a, const auto&) { return atan(a); },
+            [](const auto& a, const auto&, const auto&, const auto& g)
+            { return g / (1.0 + a * a); },
+        });
+    case Op::Exp:
+        return func(Rule{
+            [](const auto& a, const auto&) { return exp(a); },
+            [](const auto&, const auto&, const auto& r, const auto& g)
+            { return g * r; },
+        });
+    case Op::Log:
+        return func(Rule{
+            [](const auto& a, const auto&) { return log(a); },
+            [](const auto& a, const auto&, const auto&, const auto& g)
+            { return g / a; },
+        });
+    case Op::Sqrt:
+        return func(Rule{
+            [](const auto& a, const auto&) { return sqrt(a); },
+            [](const auto&, const auto&, const auto& r, const auto& g)
+            { return 0.5 * g / r; },
+        });
+    case Op::Abs:
+        return func(Rule{
+            [](const auto& a, const auto&) { return abs(a); },
+            [](const auto& a, const auto&, const auto&, const auto& g)
+            { return g * sign(a); },
+        });
+    }
+}
+
+
+// ==== PARSER ==== //
+
+struct Function
+{
+    std::string_view name;
+    Op op;
+};
+
+constexpr Function UnaryFunctions[] = {
+    {"sin", Op::Sin}, {"cos", Op::Cos}, {"tan", Op::Tan},
+    {"sinh", Op::Sinh}, {"cosh", Op::Cosh}, {"tanh", Op::Tanh},
+    {"atan", Op::Atan}, {"exp", Op::Exp}, {"log", Op::Log},
+    {"sqrt", Op::Sqrt}, {"abs", Op::Abs},
+};
+
+
+auto is_identifier_start(char c) noexcept -> bool
+{ return std::isalpha(static_cast<unsigned char>(c)) or c == '_'; }
+
+auto is_identifier_char(char c) noexcept -> bool
+{ return std::isalnum(static_cast<unsigned char>(c)) or c == '_'; }
+
+auto is_digit(char c) noexcept -> bool
+{ return std::isdigit(static_cast<unsigned char>(c)); }
+
+
+// Index of the position q<index> or -1 if name does not refer to one.
+auto position_index(std::string_view name) noexcept -> Index
+{
+    if(name.size() < 2 or name[0] != 'q'
+        or !std::all_of(name.begin() + 1, name.end(), is_digit))
+        return -1;
+
+    Index res = -1;
+    const auto [end, ec] = std::from_chars(name.data() + 1,
+        name.data() + name.size(), res);
+    return ec == std::errc{} ? res : -1;
+}
+
+
+/**
+ * Recursive descent parser for the grammar:
+ *
+ * sum     = product {("+" | "-") product}
+ * product = unary {("*" | "/") unary}
+ * unary   = ("+" | "-") unary | power
+ * power   = primary [("^" | "**") unary]
+ * primary = number | name | name "(" sum ["," sum] ")" | "(" sum ")"
+ *
+ * Operations on constants are evaluated while parsing.
+ */
+class Parser
+{
+public:
+    explicit Parser(
+        std::string_view source,
+        Index dofs,
+        const ExpressionSystem::Parameters& parameters
+    )
+        : source_{source}
+        , dofs_{dofs}
+        , parameters_{parameters}
+    {}
+
+    auto parse() -> ExpressionSystem::Program
+    {
+        program_.degrees_of_freedom = dofs_;
+        program_.result = parse_sum();
+        skip_space();
+        check(pos_ == source_.size(), "Unexpected character");
+        return std::move(program_);
+    }
+
+
+private:
+    std::string_view source_;
+    std::size_t pos_{0};
+    Index dofs_;
+    const ExpressionSystem::Parameters& parameters_;
+    ExpressionSystem::Program program_;
+
+
+    void check(bool condition, std::string_view message) const
+    {
+        if(!condition) [[unlikely]]
+            throw std::invalid_argument(std::string{message}
+                + " at position " + std::to_string(pos_)
+                + " of expression \"" + std::string{source_} + "\".");
+    }
+
+    void skip_space() noexcept
+    {
+        while(pos_ < source_.size()
+            and std::isspace(static_cast<unsigned char>(source_[pos_])))
+            ++pos_;
+    }
+
+    auto lookahead(std::string_view token) noexcept -> bool
+    {
+        skip_space();
+        return source_.substr(pos_).starts_with(token);
+    }
+
+    auto accept(std::string_view token) noexcept -> bool
+    {
+        if(!lookahead(token))
+            return false;
+        pos_ += token.size();
+        return true;
+    }
+
+    auto peek() noexcept -> char
+    {
+        skip_space();
+        return pos_ < source_.size() ? source_[pos_] : '\0';
+    }
+
+
+    auto depends_on_positions(const Operand& operand) const noexcept -> bool
+    {
+        return operand.kind == Operand::Position
+            or (operand.kind == Operand::Register
+                and program_.code[operand.index].differentiable);
+    }
+
+    auto emit(Op op, Operand lhs, Operand rhs = {}) -> Operand
+    {
+        if(lhs.kind == Operand::Constant and rhs.kind == Operand::Constant)
+        {
+            Operand res{};
+            with_rule(op, [&](const auto& rule)
+                { res.value = rule.eval(lhs.value, rhs.value); });
+            return res;
+        }
+
+        // Cheaper special cases of powers.
+        if(op == Op::Pow and rhs.kind == Operand::Constant)
+        {
+            if(rhs.value == 1.0)
+                return lhs;
+            if(rhs.value == 2.0)
+                op = Op::Square;
+            else if(rhs.value == 0.5)
+                op = Op::Sqrt;
+        }
+
+        program_.code.push_back(Instruction{
+            .op = op,
+            .lhs = lhs,
+            .rhs = rhs,
+            .differentiable =
+                depends_on_positions(lhs) or depends_on_positions(rhs),
+        });
+        return Operand{
+            .kind = Operand::Register,
+            .index = static_cast<Index>(program_.code.size()) - 1,
+        };
+    }
+
+
+    auto parse_sum() -> Operand
+    {
+        Operand res = parse_product();
+        while(true)
+        {
+            if(accept("+"))
+                res = emit(Op::Add, res, parse_product());
+            else if(accept("-"))
+                res = emit(Op::Sub, res, parse_product());
+            else
+                return res;
+        }
+    }
+
+    auto parse_product() -> Operand
+    {
+        Operand res = parse_unary();
+        while(true)
+        {
+            if(!lookahead("**") and accept("*"))
+                res = emit(Op::Mul, res, parse_unary());
+            else if(accept("/"))
+                res = emit(Op::Div, res, parse_unary());
+            else
+                return res;
+        }
+    }
+
+    auto parse_unary() -> Operand
+    {
+        if(accept("-"))
+            return emit(Op::Neg, parse_unary());
+        if(accept("+"))
+            return parse_unary();
+        return parse_power();
+    }
+
+    auto parse_power() -> Operand
+    {
+        const Operand base = parse_primary();
+        if(accept("^") or accept("**"))
+            return emit(Op::Pow, base, parse_unary());
+        return base;
+    }
+
+    auto parse_primary() -> Operand
+    {
+        const char c = peek();
+
+        if(accept("("))
+        {
+            const Operand res = parse_sum();
+            check(accept(")"), "Expected ')'");
+            return res;
+        }
+
+        if(is_digit(c) or c == '.')
+            return parse_number();
+
+        check(is_identifier_start(c), "Expected a number or name");
+        const std::size_t start = pos_;
+        while(pos_ < source_.size() and is_identifier_char(source_[pos_]))
+            ++pos_;
+        const std::string_view name = source_.substr(start, pos_ - start);
+
+        if(accept("("))
+            return parse_call(name);
+        return resolve(name, start);
+    }
+
+    auto parse_number() -> Operand
+    {
+        Operand res{};
+        const auto [end, ec] = std::from_chars(
+            source_.data() + pos_, source_.data() + source_.size(),
+            res.value);
+        check(ec == std::errc{}, "Invalid number");
+        pos_ = static_cast<std::size_t>(end - source_.data());
+        return res;
+    }
+
+    auto parse_call(std::string_view name) -> Operand
+    {
+        const Operand arg = parse_sum();
+
+        if(name == "pow")
+        {
+            check(accept(","), "Expected ','");
+            const Operand exponent = parse_sum();
+            check(accept(")"), "Expected ')'");
+            return emit(Op::Pow, arg, exponent);
+        }
+
+        check(accept(")"), "Expected ')'");
+        const auto* func = std::find_if(
+            std::begin(UnaryFunctions), std::end(UnaryFunctions),
+            [&](const Function& f) { return f.name == name; });
+        check(func != std::end(UnaryFunctions),
+            "Unknown function \"" + std::string{name} + "\"");
+        return emit(func->op, arg);
+    }
+
+    auto resolve(std::string_view name, std::size_t start) -> Operand
+    {
+        if(const Index index = position_index(name); index >= 0)
+        {
+            pos_ = start;
+            check(index < dofs_, "Position \"" + std::string{name}
+                + "\" exceeds the degrees of freedom");
+            pos_ += name.size();
+            return Operand{.kind = Operand::Position, .index = index};
+        }
+        if(name == "t")
+        {
+            program_.time_dependent = true;
+            return Operand{.kind = Operand::Time};
+        }
+        if(const auto param = parameters_.find(name);
+            param != parameters_.end())
+            return Operand{.value = param->second};
+        if(name == "pi")
+            return Operand{.value = std::numbers::pi};
+        if(name == "e")
+            return Operand{.value = std::numbers::e};
+
+        pos_ = start;
+        check(false, "Unknown name \"" + std::string{name} + "\"");
+        return {};
+    }
+};
+
+
+// ==== EVALUATION ==== //
+
+// Registers and adjoints of a chunk of states.
+struct Frame
+{
+    const VectorsCRef& states;
+    double t;
+    Index begin;
+    Index size;
+    Vectors& scratch;
+    Index num_registers;
+
+    auto value(Index reg) const noexcept -> Column
+    { return Column{scratch.col(reg).data(), size}; }
+
+    auto const_value(Index reg) const noexcept -> ConstColumn
+    { return ConstColumn{scratch.col(reg).data(), size}; }
+
+    auto adjoint(Index reg) const noexcept -> Column
+    { return Column{scratch.col(num_registers + reg).data(), size}; }
+
+    auto gradient(Index dof) const noexcept -> Column
+    { return Column{scratch.col(2 * num_registers + dof).data(), size}; }
+
+    auto position(Index dof) const noexcept -> ConstColumn
+    { return ConstColumn{states.col(dof).data() + begin, size}; }
+};
+
+
+// Call func with the value of operand, either a scalar or a column.
+template<typename Func>
+void visit(const Operand& operand, const Frame& frame, Func&& func)
+{
+    switch(operand.kind)
+    {
+    case Operand::Constant:
+        return func(operand.value);
+    case Operand::Time:
+        return func(frame.t);
+    case Operand::Position:
+        return func(frame.position(operand.index));
+    case Operand::Register:
+        return func(frame.const_value(operand.index));
+    }
+}
+
+
+template<typename Value>
+void assign(Column out, const Value& value)
+{
+    if constexpr(std::is_arithmetic_v<Value>)
+        out.setConstant(value);
+    else
+        out = value;
+}
+
+
+void forward(const ExpressionSystem::Program& program, const Frame& frame)
+{
+    for(Index reg = 0; reg < frame.num_registers; ++reg)
+    {
+        const Instruction& instr = program.code[reg];
+        with_rule(instr.op, [&](const auto& rule)
+        {
+            visit(instr.lhs, frame, [&](const auto& a)
+            {
+                visit(instr.rhs, frame, [&](const auto& b)
+                { assign(frame.value(reg), rule.eval(a, b)); });
+            });
+        });
+    }
+}
+
+
+void backward(const ExpressionSystem::Program& program, const Frame& frame)
+{
+    const auto adjoint = [&](const Operand& operand)
+    {
+        return operand.kind == Operand::Position
+            ? frame.gradient(operand.index)
+            : frame.adjoint(operand.index);
+    };
+    const auto differentiable = [&](const Operand& operand)
+    {
+        return operand.kind == Operand::Position
+            or (operand.kind == Operand::Register
+                and program.code[operand.index].differentiable);
+    };
+
+    for(Index reg = 0; reg < frame.num_registers; ++reg)
+        if(program.code[reg].differentiable)
+            frame.adjoint(reg).setZero();
+    for(Index dof = 0; dof < program.degrees_of_freedom; ++dof)
+        frame.gradient(dof).setZero();
+
+    if(!differentiable(program.result))
+        return;
+    adjoint(program.result).setOnes();
+
+    for(Index reg = frame.num_registers - 1; reg >= 0; --reg)
+    {
+        const Instruction& instr = program.code[reg];
+        if(!instr.differentiable)
+            continue;
+
+        const ConstColumn r = frame.const_value(reg);
+        const ConstColumn g = frame.const_value(frame.num_registers + reg);
+        with_rule(instr.op, [&](const auto& rule)
+        {
+            visit(instr.lhs, frame, [&](const auto& a)
+            {
+                visit(instr.rhs, frame, [&](const auto& b)
+                {
+                    if(differentiable(instr.lhs))
+                        adjoint(instr.lhs) += rule.d0(a, b, r, g);
+                    if(differentiable(instr.rhs))
+                        adjoint(instr.rhs) += rule.d1(a, b, r, g);
+                });
+            });
+        });
+    }
+}
+
+
+template<bool WithPotential, bool WithForce>
+void evaluate(
+    const ExpressionSystem::Program& program,
+    const VectorsCRef& states,
+    double t,
+    ScalarsRef* potential_out,
+    VectorsRef* force_out
+) noexcept
+{
+    const Index dofs = program.degrees_of_freedom;
+    const Index num_registers = static_cast<Index>(program.code.size());
+    assert(states.cols() == 2 * dofs);
+
+    // Systems are shared between threads, so each one needs its own buffer.
+    thread_local Vectors scratch;
+    const Index cols = 2 * num_registers + dofs;
+    if(scratch.rows() < ChunkSize or scratch.cols() < cols)
+        scratch.resize(ChunkSize, std::max(cols, scratch.cols()));
+
+    for(Index begin = 0; begin < states.rows(); begin += ChunkSize)
+    {
+        const Frame frame{
+            .states = states,
+            .t = t,
+            .begin = begin,
+            .size = std::min(ChunkSize, states.rows() - begin),
+            .scratch = scratch,
+            .num_registers = num_registers,
+        };
+
+        forward(program, frame);
+
+        if constexpr(WithPotential)
+            visit(program.result, frame, [&](const auto& res)
+            {
+                assign(
+                    Column{potential_out->data() + begin, frame.size}, res);
+            });
+
+        if constexpr(WithForce)
+        {
+            backward(program, frame);
+            for(Index dof = 0; dof < dofs; ++dof)
+                force_out->col(dof).segment(begin, frame.size) =
+                    -frame.gradient(dof);
+        }
+    }
+}
+
+} // namespace
+
+
+ExpressionSystem::ExpressionSystem(
+    std::string expression, Vector masses, const Parameters& parameters
+)
+    : expression_{std::move(expression)}
+    , masses_{std::move(masses)}
+{
+    expect(masses_.size() > 0, "At least one mass is required.");
+    for(const auto& [name, value] : parameters)
+        expect(name != "t" and position_index(name) < 0,
+            "Parameter \"" + name + "\" shadows a variable.");
+
+    program_ = std::make_shared<const Program>(
+        Parser{expression_, masses_.size(), parameters}.parse());
+}
+
+
+auto traits(const ExpressionSystem& model) noexcept -> SystemTraits
+{
+    return {
+        .velocity_independent_forces = true,
+        .constant_masses = true,
+        .time_independent_potential = !model.program().time_dependent,
+    };
+}
+
+
+void potential_into(
+    const ExpressionSystem& model,
+    const VectorsCRef& states,
+    double t,
+    ScalarsRef out
+) noexcept
+{
+    evaluate<true, false>(model.program(), states, t, &out, nullptr);
+}
+
+
+void force_into(
+    const ExpressionSystem& model,
+    const VectorsCRef& states,
+    double t,
+    VectorsRef out
+) noexcept
+{
+    evaluate<false, true>(model.program(), states, t, nullptr, &out);
+}
+
+
+void energy_and_force_into(
+    const ExpressionSystem& model,
+    const VectorsCRef& states,
+    double t,
+    ScalarsRef potential_out,
+    VectorsRef force_out
+) noexcept
+{
+    evaluate<true, true>(
+        model.program(), states, t, &potential_out, &force_out);
+}
+
+} // namespace mfptlib
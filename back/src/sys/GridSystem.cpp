@@ -0,0 +1,338 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include <mfptlib/sys/GridSystem.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <utility>
+
+#include <mfptlib/core/Errors.hpp>
+
+
+namespace mfptlib {
+
+namespace {
+
+constexpr Index MaxDimensions = GridSystem::MaxDimensions;
+
+
+auto share(const Scalars& values, const Indices& shape)
+    -> std::shared_ptr<const double[]>
+{
+    expect(values.size() == shape.prod(),
+        "The number of values must match the shape of the grid.");
+
+    std::shared_ptr<double[]> res{new double[values.size()]};
+    std::copy(values.begin(), values.end(), res.get());
+    return res;
+}
+
+
+// Rows interpolated at once, small enough for the stencils of all axes
+// and the partial sums of the contraction to stay in L1.
+constexpr Index ChunkRows = 16;
+
+using Chunk = Eigen::Array<
+    double, Eigen::Dynamic, 1, Eigen::ColMajor, ChunkRows>;
+using IndexChunk = Eigen::Array<
+    Index, Eigen::Dynamic, 1, Eigen::ColMajor, ChunkRows>;
+
+
+// Grid offsets and interpolation weights along one axis
+// for the four points surrounding the coordinates of a chunk of rows.
+struct AxisStencil
+{
+    std::array<IndexChunk, 4> offsets;
+    std::array<Chunk, 4> weights;
+    std::array<Chunk, 4> derivs;
+
+    void resize(Index n)
+    {
+        for(Index k = 0; k < 4; ++k)
+        {
+            offsets[k].resize(n);
+            weights[k].resize(n);
+            derivs[k].resize(n);
+        }
+    }
+};
+
+using Stencils = std::array<AxisStencil, MaxDimensions>;
+
+
+// Catmull-Rom weights and their derivatives for the relative position
+// t ∈ [0, 1] inside of the cell of row i.
+void set_weights(
+    AxisStencil& stencil, Index i, double t, double inv_spacing
+) noexcept
+{
+    const double t2 = t * t;
+    const double t3 = t2 * t;
+    stencil.weights[0][i] = 0.5 * (-t3 + 2.0 * t2 - t);
+    stencil.weights[1][i] = 0.5 * (3.0 * t3 - 5.0 * t2 + 2.0);
+    stencil.weights[2][i] = 0.5 * (-3.0 * t3 + 4.0 * t2 + t);
+    stencil.weights[3][i] = 0.5 * (t3 - t2);
+
+    const double h = 0.5 * inv_spacing;
+    stencil.derivs[0][i] = h * (-3.0 * t2 + 4.0 * t - 1.0);
+    stencil.derivs[1][i] = h * (9.0 * t2 - 10.0 * t);
+    stencil.derivs[2][i] = h * (-9.0 * t2 + 8.0 * t + 1.0);
+    stencil.derivs[3][i] = h * (3.0 * t2 - 2.0 * t);
+}
+
+
+void set_stencil(
+    AxisStencil& stencil,
+    Index i,
+    const GridSystem& model,
+    Index axis,
+    double x
+) noexcept
+{
+    const Index n = model.shape()[axis];
+    const Index stride = model.strides()[axis];
+    const double inv_spacing = 1.0 / model.spacing()[axis];
+    double u = (x - model.lower()[axis]) * inv_spacing;
+
+    if(model.periodic()[axis])
+        u -= static_cast<double>(n) * std::floor(u / static_cast<double>(n));
+
+    if(std::isnan(u)) [[unlikely]]
+    {
+        for(Index k = 0; k < 4; ++k)
+        {
+            stencil.offsets[k][i] = 0;
+            stencil.weights[k][i] = std::numeric_limits<double>::quiet_NaN();
+            stencil.derivs[k][i] = std::numeric_limits<double>::quiet_NaN();
+        }
+    }
+    else if(model.periodic()[axis])
+    {
+        // Rounding may map tiny negative u to n.
+        const Index cell = std::min(static_cast<Index>(u), n - 1);
+        set_weights(stencil, i, u - static_cast<double>(cell), inv_spacing);
+        for(Index k = 0; k < 4; ++k)
+        {
+            Index j = cell - 1 + k;
+            j += j < 0 ? n : (j >= n ? -n : 0);
+            stencil.offsets[k][i] = j * stride;
+        }
+    }
+    else
+    {
+        const bool inside = 0.0 <= u and u <= static_cast<double>(n - 1);
+        u = std::clamp(u, 0.0, static_cast<double>(n - 1));
+        const Index cell = std::min(static_cast<Index>(u), n - 2);
+        set_weights(stencil, i, u - static_cast<double>(cell), inv_spacing);
+        for(Index k = 0; k < 4; ++k)
+        {
+            stencil.offsets[k][i] =
+                std::clamp(cell - 1 + k, Index{0}, n - 1) * stride;
+
+            // The potential is constant outside of the grid.
+            if(!inside)
+                stencil.derivs[k][i] = 0.0;
+        }
+    }
+}
+
+
+// Sum the values weighted by the stencils of all axes starting at axis
+// for every row of the chunk, where base holds the offsets of the rows
+// accumulated over the previous axes. res[0] receives the interpolated
+// values and, if WithGradient is set, res[1 + j] their derivatives with
+// respect to axis + j.
+template<bool WithGradient>
+void contract(
+    const double* values,
+    const Stencils& stencils,
+    const IndexChunk& base,
+    Index dims,
+    Index axis,
+    Chunk* res
+) noexcept
+{
+    const AxisStencil& stencil = stencils[axis];
+    const Index rows = base.size();
+    const Index width = WithGradient ? dims - axis + 1 : 1;
+    for(Index j = 0; j < width; ++j)
+        res[j].setZero(rows);
+
+    if(axis + 1 == dims)
+    {
+        Chunk value{rows};
+        for(Index k = 0; k < 4; ++k)
+        {
+            for(Index i = 0; i < rows; ++i)
+                value[i] = values[base[i] + stencil.offsets[k][i]];
+            res[0] += stencil.weights[k] * value;
+            if constexpr(WithGradient)
+                res[1] += stencil.derivs[k] * value;
+        }
+        return;
+    }
+
+    std::array<Chunk, MaxDimensions + 1> sub{};
+    for(Index k = 0; k < 4; ++k)
+    {
+        const IndexChunk offsets = base + stencil.offsets[k];
+        contract<WithGradient>(
+            values, stencils, offsets, dims, axis + 1, sub.data());
+        res[0] += stencil.weights[k] * sub[0];
+        if constexpr(WithGradient)
+        {
+            res[1] += stencil.derivs[k] * sub[0];
+            for(Index j = 2; j < width; ++j)
+                res[j] += stencil.weights[k] * sub[j - 1];
+        }
+    }
+}
+
+
+// The stencils are set up row by row, while the contraction, which visits
+// 4^N grid points per row, works on whole chunks of rows.
+template<bool WithPotential, bool WithForce>
+void evaluate(
+    const GridSystem& model,
+    const VectorsCRef& states,
+    ScalarsRef* potential_out,
+    VectorsRef* force_out
+) noexcept
+{
+    const Index dims = degrees_of_freedom(model);
+    assert(states.cols() == 2 * dims);
+
+    Stencils stencils{};
+    std::array<Chunk, MaxDimensions + 1> res{};
+
+    for(Index first = 0; first < states.rows(); first += ChunkRows)
+    {
+        const Index n = std::min(ChunkRows, states.rows() - first);
+        for(Index axis = 0; axis < dims; ++axis)
+        {
+            stencils[axis].resize(n);
+            for(Index i = 0; i < n; ++i)
+                set_stencil(
+                    stencils[axis], i, model, axis, states(first + i, axis));
+        }
+
+        contract<WithForce>(
+            model.values(), stencils, IndexChunk::Zero(n), dims, 0, res.data());
+
+        if constexpr(WithPotential)
+            potential_out->segment(first, n) = res[0];
+        if constexpr(WithForce)
+            for(Index axis = 0; axis < dims; ++axis)
+                force_out->col(axis).segment(first, n) = -res[1 + axis];
+    }
+}
+
+} // namespace
+
+
+GridSystem::GridSystem(
+    std::shared_ptr<const double[]> values,
+    Indices shape,
+    Vector lower,
+    Vector upper,
+    Vector masses,
+    Booleans periodic
+)
+    : values_{std::move(values)}
+    , shape_{std::move(shape)}
+    , lower_{std::move(lower)}
+    , upper_{std::move(upper)}
+    , masses_{std::move(masses)}
+    , periodic_{std::move(periodic)}
+{
+    const Index dims = shape_.size();
+    if(periodic_.size() == 0)
+        periodic_ = Booleans::Constant(dims, false);
+
+    expect(values_ != nullptr, "The grid values must not be null.");
+    expect(0 < dims and dims <= MaxDimensions,
+        "The grid must have between 1 and 8 dimensions.");
+    expect(lower_.size() == dims and upper_.size() == dims,
+        "The number of bounds must match the dimension of the grid.");
+    expect(masses_.size() == dims,
+        "The number of masses must match the dimension of the grid.");
+    expect(periodic_.size() == dims,
+        "The number of periodic flags must match the dimension of the grid.");
+    expect((shape_ >= 2).all(),
+        "The grid must have at least two points along every axis.");
+    expect((upper_ > lower_).all(),
+        "The upper bounds of the grid must exceed the lower bounds.");
+
+    strides_.resize(dims);
+    spacing_.resize(dims);
+    Index stride = 1;
+    for(Index axis = dims - 1; axis >= 0; --axis)
+    {
+        strides_[axis] = stride;
+        stride *= shape_[axis];
+
+        const Index intervals = shape_[axis] - (periodic_[axis] ? 0 : 1);
+        spacing_[axis] = (upper_[axis] - lower_[axis])
+            / static_cast<double>(intervals);
+    }
+}
+
+
+GridSystem::GridSystem(
+    const Scalars& values,
+    Indices shape,
+    Vector lower,
+    Vector upper,
+    Vector masses,
+    Booleans periodic
+)
+    : GridSystem{
+        share(values, shape),
+        std::move(shape),
+        std::move(lower),
+        std::move(upper),
+        std::move(masses),
+        std::move(periodic),
+    }
+{}
+
+
+void potential_into(
+    const GridSystem& model,
+    const VectorsCRef& states,
+    [[maybe_unused]] double t,
+    ScalarsRef out
+) noexcept
+{
+    evaluate<true, false>(model, states, &out, nullptr);
+}
+
+
+void force_into(
+    const GridSystem& model,
+    const VectorsCRef& states,
+    [[maybe_unused]] double t,
+    VectorsRef out
+) noexcept
+{
+    evaluate<false, true>(model, states, nullptr, &out);
+}
+
+
+void energy_and_force_into(
+    const GridSystem& model,
+    const VectorsCRef& states,
+    [[maybe_unused]] double t,
+    ScalarsRef potential_out,
+    VectorsRef force_out
+) noexcept
+{
+    evaluate<true, true>(model, states, &potential_out, &force_out);
+}
+
+} // namespace mfptlib
@@ -3,8 +3,10 @@
 
 #include <mfptlib/sys/LithiumCyanide.hpp>
 
+#include <algorithm>
 #include <array>
 #include <cassert>
+#include <cstddef>
 
 
 namespace mfptlib {
@@ -65,281 +67,225 @@ enum Column : Index
 };
 
 
-using LegendreCoeffs = Eigen::Array<
-    double, Eigen::Dynamic, ShortRngParams.size()>;
-
-
-// See https://en.wikipedia.org/wiki/Legendre_polynomials#Definition_via_generating_function
-auto legendre(const ScalarsCRef& x) noexcept -> LegendreCoeffs
+// Coefficients of the long-range expansion Σ_k C_L,k r^{-k-1} for every
+// Legendre order L, combining the electrostatic and induction energies.
+constexpr auto LongRngCoeffs = []
 {
-    static_assert(ShortRngParams.size() >= 3);
-
-    LegendreCoeffs p{x.size(), ShortRngParams.size()};
-    p.col(0) = 1.0;
-    p.col(1) = x;
-    p.col(2) = 1.5 * x.square() - 0.5;
-
-    constexpr auto to_dbl = [](Eigen::Index i){ return static_cast<double>(i); };
-    for(Eigen::Index l = 3; l < p.cols(); ++l)
+    static_assert(MomentQ.size() <= InductionCoeffs.size() + 3);
+    static_assert(InductionCoeffs[0].size() <= ShortRngParams.size());
+
+    std::array<std::array<double, InductionCoeffs.size() + 3>,
+        ShortRngParams.size()> coeffs{};
+    for(std::size_t l = 0u; l < MomentQ.size(); ++l)
+        coeffs[l][l] = MomentQ[l];
+    for(std::size_t k = 0u; k < InductionCoeffs.size(); ++k)
+        for(std::size_t l = 0u; l < InductionCoeffs[k].size(); ++l)
+            coeffs[l][k + 3] += InductionCoeffs[k][l];
+
+    return coeffs;
+}();
+
+
+// Rows evaluated at once, small enough for all temporaries to stay in L1.
+constexpr Index ChunkRows = 64;
+
+using Chunk = Eigen::Array<
+    double, Eigen::Dynamic, 1, Eigen::ColMajor, ChunkRows>;
+
+
+/**
+ * Evaluate the potential and/or the forces for rows [first, first + n).
+ *
+ * The potential is a Legendre series V = Σ_L c_L(R) P_L(cos θ) with
+ * c_L(R) = D(R) Σ_k C_L,k R^{-k-1} + exp(-A_L - B_L R - C_L R²)
+ * and the damping function D(R) = 1 - exp(-a (R - R_0)²).
+ * The series and its derivatives with respect to R and cos θ are summed
+ * with Clenshaw's algorithm, so the Legendre polynomials are never stored
+ * and every exponential is evaluated only once.
+ *
+ * References:
+ * - Clenshaw, Math. Comp. 9, 118-120 (1955):
+ *   https://doi.org/10.1090/S0025-5718-1955-0071856-0
+ */
+template<bool WithPotential, bool WithForce>
+void evaluate_chunk(
+    const VectorsCRef& states,
+    Index first,
+    Index n,
+    [[maybe_unused]] ScalarsRef* potential_out,
+    [[maybe_unused]] VectorsRef* force_out
+) noexcept
+{
+    const Chunk theta = states.col(Theta).segment(first, n);
+    const Chunk r = states.col(R).segment(first, n);
+    const Chunk x = Eigen::cos(theta);
+    const Chunk inv_r = 1.0 / r;
+    const Chunk r2 = r.square();
+    const Chunk damping_exp =
+        Eigen::exp(-DampingA * (r - DampingR0).square());
+    const Chunk damping = 1.0 - damping_exp;
+    const Chunk ddamping_dr = 2.0 * DampingA * (r - DampingR0) * damping_exp;
+
+    // Clenshaw recurrences for V, ∂V/∂R, and ∂V/∂cos θ.
+    Chunk b1 = Chunk::Zero(n), b2 = Chunk::Zero(n);
+    Chunk db_dr1 = Chunk::Zero(n), db_dr2 = Chunk::Zero(n);
+    Chunk db_dx1 = Chunk::Zero(n), db_dx2 = Chunk::Zero(n);
+
+    for(std::size_t l = ShortRngParams.size(); l-- > 0u;)
     {
-        p.col(l) =
-            to_dbl(2 * l - 1) / to_dbl(l) * x * p.col(l - 1)
-            - to_dbl(l - 1) / to_dbl(l) * p.col(l - 2);
+        const auto [a, b, c] = ShortRngParams[l];
+        const auto& coeffs = LongRngCoeffs[l];
+        const auto ld = static_cast<double>(l);
+
+        // Horner's scheme in 1/R for the long-range part and its derivative.
+        Chunk long_rng = Chunk::Zero(n);
+        Chunk dlong_rng = Chunk::Zero(n);
+        for(std::size_t k = coeffs.size(); k-- > 0u;)
+        {
+            long_rng = long_rng * inv_r + coeffs[k];
+            if constexpr(WithForce)
+                dlong_rng = dlong_rng * inv_r
+                    + static_cast<double>(k + 1) * coeffs[k];
+        }
+
+        const Chunk short_rng = Eigen::exp(-a - b * r - c * r2);
+        const Chunk coeff = damping * long_rng * inv_r + short_rng;
+
+        // P_{L+1}(x) = (2L + 1) / (L + 1) x P_L(x) - L / (L + 1) P_{L-1}(x)
+        const double alpha = (2.0 * ld + 1.0) / (ld + 1.0);
+        const double beta = -(ld + 1.0) / (ld + 2.0);
+        const Chunk b0 = coeff + alpha * x * b1 + beta * b2;
+
+        if constexpr(WithForce)
+        {
+            const Chunk dcoeff_dr =
+                ddamping_dr * long_rng * inv_r
+                - damping * dlong_rng * inv_r.square()
+                - (b + 2.0 * c * r) * short_rng;
+            const Chunk db_dr0 =
+                dcoeff_dr + alpha * x * db_dr1 + beta * db_dr2;
+            const Chunk db_dx0 =
+                alpha * (b1 + x * db_dx1) + beta * db_dx2;
+
+            db_dr2 = db_dr1;
+            db_dr1 = db_dr0;
+            db_dx2 = db_dx1;
+            db_dx1 = db_dx0;
+        }
+
+        b2 = b1;
+        b1 = b0;
     }
 
-    return p;
-}
+    if constexpr(WithPotential)
+        potential_out->segment(first, n) = b1;
 
-
-// See https://en.wikipedia.org/wiki/Legendre_polynomials#Recurrence_relations
-auto legendre_prime(
-    const ScalarsCRef& x, const LegendreCoeffs& p
-) noexcept -> LegendreCoeffs
-{
-    static_assert(ShortRngParams.size() >= 2);
-
-    LegendreCoeffs dp{x.size(), ShortRngParams.size()};
-    dp.col(0) = 0.0;
-    dp.col(1) = 1.0;
-    dp.col(2) = 3.0 * x;
-
-    for(Eigen::Index l = 3; l < dp.cols(); ++l)
-        dp.col(l) = l * p.col(l - 1) + x * dp.col(l - 1);
-
-    return dp;
-}
-
-
-void set_pot_long_rng(
-    ScalarsRef res, const ScalarsCRef& r, const LegendreCoeffs& p
-) noexcept
-{
-    static_assert(MomentQ.size() == 7);
-    static_assert(InductionCoeffs.size() == 5);
-    static_assert(LegendreCoeffs::ColsAtCompileTime >= MomentQ.size()
-        and LegendreCoeffs::ColsAtCompileTime >= InductionCoeffs[0].size());
-    constexpr auto& c = InductionCoeffs;
-
-    const Scalars inv_r = 1.0 / r;
-    Scalars inv_r_pow = inv_r;
-
-    res = inv_r_pow * (MomentQ[0] * p.col(0));
-    inv_r_pow *= inv_r;
-    res += inv_r_pow * (MomentQ[1] * p.col(1));
-    inv_r_pow *= inv_r;
-    res += inv_r_pow * (MomentQ[2] * p.col(2));
-    inv_r_pow *= inv_r;
-    res += inv_r_pow * (MomentQ[3] * p.col(3)
-        + c[0][0] * p.col(0) + c[0][2] * p.col(2));
-    inv_r_pow *= inv_r;
-    res += inv_r_pow * (MomentQ[4] * p.col(4)
-        + c[1][1] * p.col(1) + c[1][3] * p.col(3));
-    inv_r_pow *= inv_r;
-    res += inv_r_pow * (MomentQ[5] * p.col(5)
-        + c[2][0] * p.col(0) + c[2][2] * p.col(2) + c[2][4] * p.col(4));
-    inv_r_pow *= inv_r;
-    res += inv_r_pow * (MomentQ[6] * p.col(6)
-        + c[3][1] * p.col(1) + c[3][3] * p.col(3) + c[3][5] * p.col(5));
-    inv_r_pow *= inv_r;
-    res += inv_r_pow * (c[4][0] * p.col(0)
-        + c[4][2] * p.col(2) + c[4][4] * p.col(4) + c[4][6] * p.col(6));
+    if constexpr(WithForce)
+    {
+        const auto p_theta = states.col(PTheta).segment(first, n);
+        force_out->col(Theta).segment(first, n) = Eigen::sin(theta) * db_dx1;
+        force_out->col(R).segment(first, n) =
+            -db_dr1 + p_theta.square() / (Mu1 * r * r2);
+    }
 }
 
 
-void add_pot_short_rng(
-    Scalars& res, const ScalarsCRef& r, const LegendreCoeffs& p
+template<bool WithPotential, bool WithForce>
+void evaluate(
+    const VectorsCRef& states,
+    ScalarsRef* potential_out,
+    VectorsRef* force_out
 ) noexcept
 {
-    static_assert(LegendreCoeffs::ColsAtCompileTime >= ShortRngParams.size());
-
-    const Scalars r2 = r.square();
-    for(std::size_t i = 0u; i < ShortRngParams.size(); ++i)
+    for(Index first = 0; first < states.rows(); first += ChunkRows)
     {
-        const auto [a, b, c] = ShortRngParams[i];
-        res += p.col(static_cast<Index>(i)) * Eigen::exp(-a - b * r - c * r2);
+        const Index n = std::min(ChunkRows, states.rows() - first);
+        evaluate_chunk<WithPotential, WithForce>(
+            states, first, n, potential_out, force_out);
     }
 }
 
-
-void set_force_theta_long_rng(
-    ScalarsRef res, const ScalarsCRef& r, const LegendreCoeffs& dp
-) noexcept
-{
-    static_assert(MomentQ.size() == 7);
-    static_assert(InductionCoeffs.size() == 5);
-    static_assert(LegendreCoeffs::ColsAtCompileTime >= MomentQ.size()
-        and LegendreCoeffs::ColsAtCompileTime >= InductionCoeffs[0].size());
-    constexpr auto& c = InductionCoeffs;
-
-    const Scalars inv_r = 1.0 / r;
-    Scalars inv_r_pow = inv_r;
-
-    res = -inv_r_pow * (MomentQ[0] * dp.col(0));
-    inv_r_pow *= inv_r;
-    res -= inv_r_pow * (MomentQ[1] * dp.col(1));
-    inv_r_pow *= inv_r;
-    res -= inv_r_pow * (MomentQ[2] * dp.col(2));
-    inv_r_pow *= inv_r;
-    res -= inv_r_pow * (MomentQ[3] * dp.col(3)
-        + c[0][0] * dp.col(0) + c[0][2] * dp.col(2));
-    inv_r_pow *= inv_r;
-    res -= inv_r_pow * (MomentQ[4] * dp.col(4)
-        + c[1][1] * dp.col(1) + c[1][3] * dp.col(3));
-    inv_r_pow *= inv_r;
-    res -= inv_r_pow * (MomentQ[5] * dp.col(5)
-        + c[2][0] * dp.col(0) + c[2][2] * dp.col(2) + c[2][4] * dp.col(4));
-    inv_r_pow *= inv_r;
-    res -= inv_r_pow * (MomentQ[6] * dp.col(6)
-        + c[3][1] * dp.col(1) + c[3][3] * dp.col(3) + c[3][5] * dp.col(5));
-    inv_r_pow *= inv_r;
-    res -= inv_r_pow * (c[4][0] * dp.col(0)
-        + c[4][2] * dp.col(2) + c[4][4] * dp.col(4) + c[4][6] * dp.col(6));
-}
+} // namespace
 
 
-void add_force_theta_short_rng(
-    ScalarsRef res, const ScalarsCRef& r, const LegendreCoeffs& dp
+void potential_into(
+    [[maybe_unused]] const LithiumCyanide& model,
+    const VectorsCRef& states,
+    [[maybe_unused]] double t,
+    ScalarsRef out
 ) noexcept
 {
-    static_assert(LegendreCoeffs::ColsAtCompileTime >= ShortRngParams.size());
-
-    const Scalars r2 = r.square();
-    for(std::size_t i = 0u; i < ShortRngParams.size(); ++i)
-    {
-        const auto [a, b, c] = ShortRngParams[i];
-        res -= dp.col(static_cast<Index>(i)) * Eigen::exp(-a - b * r - c * r2);
-    }
+    assert(states.cols() == 2 * degrees_of_freedom(model));
+    evaluate<true, false>(states, &out, nullptr);
 }
 
 
-auto force_r_long_rng(
-    const ScalarsCRef& r, const LegendreCoeffs& p
-) noexcept -> Scalars
+void force_into(
+    [[maybe_unused]] const LithiumCyanide& model,
+    const VectorsCRef& states,
+    [[maybe_unused]] double t,
+    VectorsRef out
+) noexcept
 {
-    static_assert(MomentQ.size() == 7);
-    static_assert(InductionCoeffs.size() == 5);
-    static_assert(LegendreCoeffs::ColsAtCompileTime >= MomentQ.size()
-        and LegendreCoeffs::ColsAtCompileTime >= InductionCoeffs[0].size());
-    constexpr auto& c = InductionCoeffs;
-
-    const Scalars inv_r = 1.0 / r;
-    Scalars inv_r_pow = inv_r * inv_r;
-
-    Scalars res = inv_r_pow * (MomentQ[0] * p.col(0));
-    inv_r_pow *= inv_r;
-    res += inv_r_pow * (2.0 * MomentQ[1] * p.col(1));
-    inv_r_pow *= inv_r;
-    res += inv_r_pow * (3.0 * MomentQ[2] * p.col(2));
-    inv_r_pow *= inv_r;
-    res += 4.0 * inv_r_pow * (MomentQ[3] * p.col(3)
-        + c[0][0] * p.col(0) + c[0][2] * p.col(2));
-    inv_r_pow *= inv_r;
-    res += 5.0 * inv_r_pow * (MomentQ[4] * p.col(4)
-        + c[1][1] * p.col(1) + c[1][3] * p.col(3));
-    inv_r_pow *= inv_r;
-    res += 6.0 * inv_r_pow * (MomentQ[5] * p.col(5)
-        + c[2][0] * p.col(0) + c[2][2] * p.col(2) + c[2][4] * p.col(4));
-    inv_r_pow *= inv_r;
-    res += 7.0 * inv_r_pow * (MomentQ[6] * p.col(6)
-        + c[3][1] * p.col(1) + c[3][3] * p.col(3) + c[3][5] * p.col(5));
-    inv_r_pow *= inv_r;
-    res += 8.0 * inv_r_pow * (c[4][0] * p.col(0)
-        + c[4][2] * p.col(2) + c[4][4] * p.col(4) + c[4][6] * p.col(6));
-
-    return res;
+    assert(states.cols() == 2 * degrees_of_freedom(model));
+    evaluate<false, true>(states, nullptr, &out);
 }
 
 
-void add_force_r_short_rng(
-    ScalarsRef res, const ScalarsCRef& r, const LegendreCoeffs& p
+void energy_and_force_into(
+    [[maybe_unused]] const LithiumCyanide& model,
+    const VectorsCRef& states,
+    [[maybe_unused]] double t,
+    ScalarsRef potential_out,
+    VectorsRef force_out
 ) noexcept
 {
-    static_assert(LegendreCoeffs::ColsAtCompileTime >= ShortRngParams.size());
-
-    const Scalars r2 = r.square();
-    for(std::size_t i = 0u; i < ShortRngParams.size(); ++i)
-    {
-        const auto [a, b, c] = ShortRngParams[i];
-        res += p.col(static_cast<Index>(i)) * (b + 2 * c * r)
-            * Eigen::exp(-a - b * r - c * r2);
-    }
+    assert(states.cols() == 2 * degrees_of_freedom(model));
+    evaluate<true, true>(states, &potential_out, &force_out);
 }
 
 
-auto damping(const ScalarsCRef& r) noexcept
+void masses_into(
+    [[maybe_unused]] const LithiumCyanide& model,
+    const VectorsCRef& states,
+    VectorsRef out
+) noexcept
 {
-    return 1.0 - Eigen::exp(-DampingA * (r - DampingR0).square());
-}
-
+    assert(states.cols() == 2 * degrees_of_freedom(model));
 
-auto ddamping_dr(const ScalarsCRef& r) noexcept
-{
-    return 2.0 * DampingA * (r - DampingR0)
-        * Eigen::exp(-DampingA * (r - DampingR0).square());
+    out.col(Theta) = 1.0 / (
+        1.0 / (Mu1 * states.col(R).square()) + 1.0 / (Mu2 * DistNCSquared));
+    out.col(R).setConstant(Mu1);
 }
 
-} // namespace
-
 
 auto potential(
-    [[maybe_unused]] const LithiumCyanide& model,
-    const VectorsCRef& states,
-    [[maybe_unused]] double t
+    const LithiumCyanide& model, const VectorsCRef& states, double t
 ) noexcept -> Scalars
 {
-    assert(states.cols() == 2 * degrees_of_freedom(model));
-
-    const LegendreCoeffs p_cos = legendre(Eigen::cos(states.col(Theta)).eval());
     Scalars res{states.rows()};
-
-    set_pot_long_rng(res, states.col(R), p_cos);
-    res *= damping(states.col(R));
-    add_pot_short_rng(res, states.col(R), p_cos);
-
+    potential_into(model, states, t, res);
     return res;
 }
 
 
 auto force(
-    [[maybe_unused]] const LithiumCyanide& model,
-    const VectorsCRef& states,
-    [[maybe_unused]] double t
+    const LithiumCyanide& model, const VectorsCRef& states, double t
 ) noexcept -> Vectors
 {
-    assert(states.cols() == 2 * degrees_of_freedom(model));
-
-    const Scalars cos_theta = Eigen::cos(states.col(Theta));
-    const LegendreCoeffs p_cos = legendre(cos_theta);
-    const LegendreCoeffs dp_cos =
-        legendre_prime(cos_theta, p_cos).colwise()
-        * -Eigen::sin(states.col(Theta));
-
     Vectors res{states.rows(), degrees_of_freedom(model)};
-
-    set_force_theta_long_rng(res.col(Theta), states.col(R), dp_cos);
-    res.col(Theta) *= damping(states.col(R));
-    add_force_theta_short_rng(res.col(Theta), states.col(R), dp_cos);
-
-    set_pot_long_rng(res.col(R), states.col(R), p_cos);
-    res.col(R) *= -ddamping_dr(states.col(R));
-    res.col(R) += force_r_long_rng(states.col(R), p_cos) * damping(states.col(R));
-    add_force_r_short_rng(res.col(R), states.col(R), p_cos);
-    res.col(R) += states.col(PTheta).square() / (Mu1 * states.col(R).cube());
-
+    force_into(model, states, t, res);
     return res;
 }
 
 
 auto masses(
-    [[maybe_unused]] const LithiumCyanide& model, const VectorsCRef& states
+    const LithiumCyanide& model, const VectorsCRef& states
 ) noexcept -> Vectors
 {
-    assert(states.cols() == 2 * degrees_of_freedom(model));
-
-    return (Vectors{states.rows(), 2} <<
-        1.0 / (1.0 / (Mu1 * states.col(R).square()) + 1.0 / (Mu2 * DistNCSquared)),
-        Scalars::Constant(states.rows(), Mu1)
-    ).finished();
+    Vectors res{states.rows(), degrees_of_freedom(model)};
+    masses_into(model, states, res);
+    return res;
 }
 
 } // namespace mfptlib
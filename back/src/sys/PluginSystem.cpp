@@ -0,0 +1,170 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include <mfptlib/sys/PluginSystem.hpp>
+
+#include <cassert>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <dlfcn.h>
+
+#include <mfptlib/core/Errors.hpp>
+
+
+namespace mfptlib {
+
+namespace {
+
+void validate(const mfptlib_plugin& plugin)
+{
+    expect(plugin.abi_version == MFPTLIB_PLUGIN_ABI_VERSION,
+        "The plugin ABI version " + std::to_string(plugin.abi_version)
+        + " is not supported, expected "
+        + std::to_string(MFPTLIB_PLUGIN_ABI_VERSION) + ".");
+    expect(plugin.degrees_of_freedom > 0,
+        "The plugin must have at least one degree of freedom.");
+    expect(plugin.potential != nullptr and plugin.force != nullptr,
+        "The plugin must provide the potential and force functions.");
+    expect(plugin.masses != nullptr or plugin.constant_masses != nullptr,
+        "The plugin must provide a masses function or constant masses.");
+}
+
+
+auto copy_constant_masses(const mfptlib_plugin& plugin) -> Vector
+{
+    if(plugin.masses != nullptr or plugin.constant_masses == nullptr
+        or plugin.degrees_of_freedom <= 0)
+        return {};
+    return Eigen::Map<const Vector>{
+        plugin.constant_masses, plugin.degrees_of_freedom};
+}
+
+
+auto dl_error() -> std::string
+{
+    const char* message = ::dlerror();
+    return message != nullptr ? message : "unknown error";
+}
+
+} // namespace
+
+
+PluginSystem::State::~State()
+{
+    if(plugin.release != nullptr)
+        plugin.release(plugin.context);
+}
+
+
+PluginSystem::PluginSystem(
+    const mfptlib_plugin& plugin, std::shared_ptr<const void> owner
+)
+    : state_{new State{plugin, copy_constant_masses(plugin), std::move(owner)}}
+{
+    // Invalid plugins are released together with state_.
+    validate(plugin);
+}
+
+
+auto PluginSystem::load(
+    const std::filesystem::path& library, const std::string& options
+) -> PluginSystem
+{
+    void* handle = ::dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL);
+    expect<std::runtime_error>(handle != nullptr,
+        "Cannot load plugin '" + library.string() + "': " + dl_error());
+    const std::shared_ptr<const void> owner{handle,
+        [](const void* ptr) noexcept { ::dlclose(const_cast<void*>(ptr)); }};
+
+    auto* init = reinterpret_cast<mfptlib_plugin_init_fn*>(
+        ::dlsym(handle, "mfptlib_plugin_init"));
+    expect<std::runtime_error>(init != nullptr,
+        "Plugin '" + library.string() + "' does not export "
+        "mfptlib_plugin_init.");
+
+    mfptlib_plugin plugin{};
+    expect<std::runtime_error>(init(&plugin, options.c_str()) == 0,
+        "Plugin '" + library.string() + "' failed to initialize.");
+
+    return PluginSystem{plugin, owner};
+}
+
+
+void potential_into(
+    const PluginSystem& model,
+    const VectorsCRef& states,
+    double t,
+    ScalarsRef out
+) noexcept
+{
+    const mfptlib_plugin& plugin = model.plugin();
+    assert(states.cols() == 2 * plugin.degrees_of_freedom);
+
+    plugin.potential(plugin.context,
+        states.rows(), states.data(), states.outerStride(), t, out.data());
+}
+
+
+void force_into(
+    const PluginSystem& model,
+    const VectorsCRef& states,
+    double t,
+    VectorsRef out
+) noexcept
+{
+    const mfptlib_plugin& plugin = model.plugin();
+    assert(states.cols() == 2 * plugin.degrees_of_freedom);
+
+    plugin.force(plugin.context,
+        states.rows(), states.data(), states.outerStride(), t,
+        out.data(), out.outerStride());
+}
+
+
+void energy_and_force_into(
+    const PluginSystem& model,
+    const VectorsCRef& states,
+    double t,
+    ScalarsRef potential_out,
+    VectorsRef force_out
+) noexcept
+{
+    const mfptlib_plugin& plugin = model.plugin();
+    assert(states.cols() == 2 * plugin.degrees_of_freedom);
+
+    if(plugin.energy_and_force == nullptr)
+    {
+        potential_into(model, states, t, potential_out);
+        force_into(model, states, t, force_out);
+        return;
+    }
+
+    plugin.energy_and_force(plugin.context,
+        states.rows(), states.data(), states.outerStride(), t,
+        potential_out.data(), force_out.data(), force_out.outerStride());
+}
+
+
+void masses_into(
+    const PluginSystem& model,
+    const VectorsCRef& states,
+    VectorsRef out
+) noexcept
+{
+    const mfptlib_plugin& plugin = model.plugin();
+    assert(states.cols() == 2 * plugin.degrees_of_freedom);
+
+    if(plugin.masses == nullptr)
+    {
+        out.rowwise() = model.constant_masses();
+        return;
+    }
+
+    plugin.masses(plugin.context,
+        states.rows(), states.data(), states.outerStride(),
+        out.data(), out.outerStride());
+}
+
+} // namespace mfptlib
@@ -0,0 +1,522 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include <mfptlib/sys/TabulatedLithiumCyanide.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <numbers>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include <mfptlib/core/Errors.hpp>
+#include <mfptlib/core/MappedFile.hpp>
+#include <mfptlib/sys/LithiumCyanide.hpp>
+
+
+namespace mfptlib {
+
+namespace {
+
+enum Column : Index
+{
+    Theta, R, PTheta, PR,
+};
+
+
+constexpr std::array<char, 8> Magic{'M', 'F', 'P', 'T', 'L', 'C', 'N', '\0'};
+constexpr std::uint64_t FormatVersion = 1;
+
+// Coefficients of the bicubic polynomial stored per grid cell.
+constexpr Index CellSize = 16;
+
+// Step size for the finite differences of ∂V/∂θ with respect to R.
+constexpr double CrossDelta = 1e-5;
+
+
+// The cache file consists of this header followed by the coefficients in
+// row-major [θ cell][R cell][coefficient] order.
+struct Header
+{
+    std::array<char, 8> magic;
+    std::uint64_t version;
+    std::int64_t theta_points;
+    std::int64_t r_points;
+    double r_min;
+    double r_max;
+    double max_potential_error;
+    double max_force_error;
+};
+
+static_assert(std::is_trivially_copyable_v<Header> and sizeof(Header) == 64);
+
+
+auto describes_same_grid(const Header& lhs, const Header& rhs) noexcept
+{
+    return lhs.magic == rhs.magic
+        and lhs.version == rhs.version
+        and lhs.theta_points == rhs.theta_points
+        and lhs.r_points == rhs.r_points
+        and lhs.r_min == rhs.r_min
+        and lhs.r_max == rhs.r_max;
+}
+
+
+auto num_coeffs(const Header& header) noexcept -> std::size_t
+{
+    return static_cast<std::size_t>(
+        (header.theta_points - 1) * (header.r_points - 1) * CellSize);
+}
+
+
+auto cache_file(
+    const std::filesystem::path& dir, const Header& header
+) -> std::filesystem::path
+{
+    std::ostringstream name{};
+    name << "licn-v" << header.version
+        << '-' << header.theta_points << '-' << header.r_points
+        << std::hex
+        << '-' << std::bit_cast<std::uint64_t>(header.r_min)
+        << '-' << std::bit_cast<std::uint64_t>(header.r_max)
+        << ".bin";
+    return dir / name.str();
+}
+
+
+// Mass of the R coordinate, which is constant.
+auto reduced_mass() noexcept -> double
+{
+    static const double mu = masses(
+        LithiumCyanide{}, Vectors{{0.0, 1.0, 0.0, 0.0}})(0, R);
+    return mu;
+}
+
+
+} // namespace
+
+
+struct TabulatedLithiumCyanide::Table
+{
+    Header header;
+    std::shared_ptr<const double> coeffs;
+    bool cached;
+
+    auto theta_step() const noexcept -> double
+    { return std::numbers::pi / static_cast<double>(header.theta_points - 1); }
+
+    auto r_step() const noexcept -> double
+    {
+        return (header.r_max - header.r_min)
+            / static_cast<double>(header.r_points - 1);
+    }
+
+    auto contains(double r) const noexcept -> bool
+    { return r >= header.r_min and r <= header.r_max; }
+
+    // Potential and its derivatives with respect to θ and R.
+    auto interpolate(double theta, double r) const noexcept
+        -> std::array<double, 3>;
+};
+
+
+auto TabulatedLithiumCyanide::Table::interpolate(
+    double theta, double r
+) const noexcept -> std::array<double, 3>
+{
+    assert(contains(r));
+
+    // The potential is even and 2π-periodic in θ.
+    constexpr double Period = 2 * std::numbers::pi;
+    const double reduced = theta - Period * std::nearbyint(theta / Period);
+    const double sign = std::signbit(reduced) ? -1.0 : 1.0;
+
+    const double dt = theta_step();
+    const double dr = r_step();
+    const double u = std::abs(reduced) / dt;
+    const double w = (r - header.r_min) / dr;
+    const Index i = std::min(static_cast<Index>(u), header.theta_points - 2);
+    const Index j = std::min(static_cast<Index>(w), header.r_points - 2);
+    const double s = u - static_cast<double>(i);
+    const double x = w - static_cast<double>(j);
+
+    // V = Σ_k s^k Σ_l a_kl x^l with local coordinates s and x in [0, 1].
+    const double* a = coeffs.get() + (i * (header.r_points - 1) + j) * CellSize;
+    std::array<double, 4> q{}, dq_dx{};
+    for(std::size_t k = 0u; k < 4u; ++k, a += 4)
+    {
+        q[k] = ((a[3] * x + a[2]) * x + a[1]) * x + a[0];
+        dq_dx[k] = (3 * a[3] * x + 2 * a[2]) * x + a[1];
+    }
+
+    const double v = ((q[3] * s + q[2]) * s + q[1]) * s + q[0];
+    const double dv_ds = (3 * q[3] * s + 2 * q[2]) * s + q[1];
+    const double dv_dx =
+        ((dq_dx[3] * s + dq_dx[2]) * s + dq_dx[1]) * s + dq_dx[0];
+
+    return {v, sign * dv_ds / dt, dv_dx / dr};
+}
+
+
+namespace {
+
+using Table = TabulatedLithiumCyanide::Table;
+
+
+template<bool WithPotential, bool WithForce>
+void evaluate(
+    const Table& table,
+    const VectorsCRef& states,
+    double t,
+    [[maybe_unused]] ScalarsRef* potential_out,
+    [[maybe_unused]] VectorsRef* force_out
+) noexcept
+{
+    const double mu = reduced_mass();
+
+    for(Index row = 0; row < states.rows(); ++row)
+    {
+        const double r = states(row, R);
+
+        if(!table.contains(r)) [[unlikely]]
+        {
+            const auto state = states.middleRows(row, 1);
+            if constexpr(WithPotential and WithForce)
+                energy_and_force_into(LithiumCyanide{}, state, t,
+                    potential_out->segment(row, 1),
+                    force_out->middleRows(row, 1));
+            else if constexpr(WithPotential)
+                potential_into(LithiumCyanide{}, state, t,
+                    potential_out->segment(row, 1));
+            else
+                force_into(LithiumCyanide{}, state, t,
+                    force_out->middleRows(row, 1));
+            continue;
+        }
+
+        const auto [v, dv_dtheta, dv_dr] =
+            table.interpolate(states(row, Theta), r);
+
+        if constexpr(WithPotential)
+            (*potential_out)[row] = v;
+
+        if constexpr(WithForce)
+        {
+            const double p_theta = states(row, PTheta);
+            (*force_out)(row, Theta) = -dv_dtheta;
+            (*force_out)(row, R) =
+                -dv_dr + p_theta * p_theta / (mu * r * r * r);
+        }
+    }
+}
+
+
+// Bicubic Hermite coefficients of all cells from V, ∂V/∂θ, ∂V/∂R,
+// and ∂²V/∂θ∂R at the grid points.
+auto build_coeffs(const Header& header) -> std::vector<double>
+{
+    const Index rows = header.theta_points * header.r_points;
+    Vectors states = Vectors::Zero(rows, 4);
+    for(Index i = 0; i < header.theta_points; ++i)
+    {
+        const auto first = i * header.r_points;
+        states.col(Theta).segment(first, header.r_points).setConstant(
+            std::numbers::pi * static_cast<double>(i)
+            / static_cast<double>(header.theta_points - 1));
+        states.col(R).segment(first, header.r_points) = Scalars::LinSpaced(
+            header.r_points, header.r_min, header.r_max);
+    }
+
+    Scalars pot{rows};
+    Vectors force{rows, 2};
+    energy_and_force_into(LithiumCyanide{}, states, 0.0, pot, force);
+
+    // The mixed derivative is approximated by central differences.
+    Vectors shifted = states;
+    Vectors force_plus{rows, 2};
+    Vectors force_minus{rows, 2};
+    shifted.col(R) = states.col(R) + CrossDelta;
+    force_into(LithiumCyanide{}, shifted, 0.0, force_plus);
+    shifted.col(R) = states.col(R) - CrossDelta;
+    force_into(LithiumCyanide{}, shifted, 0.0, force_minus);
+
+    const double dt = std::numbers::pi
+        / static_cast<double>(header.theta_points - 1);
+    const double dr = (header.r_max - header.r_min)
+        / static_cast<double>(header.r_points - 1);
+    const auto grid_point = [&](Index i, Index j) -> Eigen::Array4d
+    {
+        const Index row = i * header.r_points + j;
+        return {
+            pot[row],
+            -force(row, Theta) * dt,
+            -force(row, R) * dr,
+            (force_minus(row, Theta) - force_plus(row, Theta))
+                / (2 * CrossDelta) * dt * dr,
+        };
+    };
+
+    // Maps [p(0), p(1), p'(0), p'(1)] to the coefficients of a cubic p.
+    const Eigen::Matrix4d hermite{
+        { 1.0,  0.0,  0.0,  0.0},
+        { 0.0,  0.0,  1.0,  0.0},
+        {-3.0,  3.0, -2.0, -1.0},
+        { 2.0, -2.0,  1.0,  1.0},
+    };
+
+    std::vector<double> coeffs(num_coeffs(header));
+    double* cell = coeffs.data();
+    for(Index i = 0; i + 1 < header.theta_points; ++i)
+        for(Index j = 0; j + 1 < header.r_points; ++j, cell += CellSize)
+        {
+            // Rows: θ values and derivatives, columns: R likewise.
+            Eigen::Matrix4d values{};
+            for(Index a = 0; a < 2; ++a)
+                for(Index b = 0; b < 2; ++b)
+                {
+                    const Eigen::Array4d point = grid_point(i + a, j + b);
+                    values(a, b) = point[0];
+                    values(a + 2, b) = point[1];
+                    values(a, b + 2) = point[2];
+                    values(a + 2, b + 2) = point[3];
+                }
+
+            Eigen::Map<Eigen::Matrix<double, 4, 4, Eigen::RowMajor>>{cell} =
+                hermite * values * hermite.transpose();
+        }
+
+    return coeffs;
+}
+
+
+// Maximum errors at the points of every grid cell where the interpolation
+// errors of a cubic Hermite polynomial and its derivative peak in 1D,
+// i.e., the cell center and 1/2 ± 1/√12 in units of the grid spacing.
+void measure_errors(Table& table)
+{
+    static constexpr std::array Offsets{
+        0.5 - 0.5 / std::numbers::sqrt3, 0.5, 0.5 + 0.5 / std::numbers::sqrt3};
+    constexpr auto NumOffsets = static_cast<Index>(Offsets.size());
+    const auto offset = [](Index k)
+    {
+        return static_cast<double>(k / NumOffsets)
+            + Offsets[static_cast<std::size_t>(k % NumOffsets)];
+    };
+
+    Header& header = table.header;
+    const Index theta_samples = (header.theta_points - 1) * NumOffsets;
+    const Index r_samples = (header.r_points - 1) * NumOffsets;
+
+    Vectors states = Vectors::Zero(theta_samples * r_samples, 4);
+    for(Index i = 0; i < theta_samples; ++i)
+    {
+        states.col(Theta).segment(i * r_samples, r_samples).setConstant(
+            offset(i) * table.theta_step());
+        for(Index j = 0; j < r_samples; ++j)
+            states(i * r_samples + j, R) =
+                header.r_min + offset(j) * table.r_step();
+    }
+
+    Scalars exact_pot{states.rows()}, pot{states.rows()};
+    Vectors exact_force{states.rows(), 2}, force{states.rows(), 2};
+    energy_and_force_into(
+        LithiumCyanide{}, states, 0.0, exact_pot, exact_force);
+    ScalarsRef pot_ref{pot};
+    VectorsRef force_ref{force};
+    evaluate<true, true>(table, states, 0.0, &pot_ref, &force_ref);
+
+    header.max_potential_error = (pot - exact_pot).abs().maxCoeff();
+    header.max_force_error = (force - exact_force).abs().maxCoeff();
+}
+
+
+auto load_table(
+    const std::filesystem::path& path, const Header& expected
+) -> std::optional<Table>
+{
+    try
+    {
+        const MappedFile file{path};
+        const auto size = sizeof(Header) + sizeof(double) * num_coeffs(expected);
+        if(file.size() != size)
+            return std::nullopt;
+
+        Header header{};
+        std::memcpy(&header, file.data(), sizeof(Header));
+        if(!describes_same_grid(header, expected))
+            return std::nullopt;
+
+        // The mapping is page-aligned and the header preserves the alignment.
+        const auto* coeffs =
+            reinterpret_cast<const double*>(file.data() + sizeof(Header));
+        return Table{header, {file.bytes(), coeffs}, true};
+    }
+    catch(const std::runtime_error&)
+    {
+        return std::nullopt;
+    }
+}
+
+
+// The cache is only an optimization, so failing to write it is not an error.
+// Writing to a temporary file first keeps concurrent processes from reading
+// incomplete tables.
+void store_table(const std::filesystem::path& path, const Table& table)
+{
+    std::error_code error{};
+    std::filesystem::create_directories(path.parent_path(), error);
+    if(error)
+        return;
+
+    auto tmp = path;
+    tmp += ".tmp" + std::to_string(::getpid());
+    {
+        std::ofstream out{tmp, std::ios::binary | std::ios::trunc};
+        out.write(reinterpret_cast<const char*>(&table.header), sizeof(Header));
+        out.write(
+            reinterpret_cast<const char*>(table.coeffs.get()),
+            static_cast<std::streamsize>(
+                sizeof(double) * num_coeffs(table.header))
+        );
+        if(!out)
+        {
+            out.close();
+            std::filesystem::remove(tmp, error);
+            return;
+        }
+    }
+
+    std::filesystem::rename(tmp, path, error);
+    if(error)
+        std::filesystem::remove(tmp, error);
+}
+
+} // namespace
+
+
+auto TabulationOptions::default_cache_dir() -> std::filesystem::path
+{
+    if(const char* cache_home = std::getenv("XDG_CACHE_HOME"); cache_home
+        and *cache_home)
+    {
+        return std::filesystem::path{cache_home} / "mfptlib";
+    }
+    if(const char* home = std::getenv("HOME"); home and *home)
+        return std::filesystem::path{home} / ".cache" / "mfptlib";
+    return {};
+}
+
+
+TabulatedLithiumCyanide::TabulatedLithiumCyanide(
+    const TabulationOptions& options
+)
+{
+    expect(options.theta_points >= 2 and options.r_points >= 2,
+        "The number of grid points must be >= 2.");
+    expect(std::isfinite(options.r_min) and std::isfinite(options.r_max)
+        and 0.0 < options.r_min and options.r_min < options.r_max,
+        "The range of R must be finite, positive, and non-empty.");
+
+    const Header expected{
+        Magic, FormatVersion,
+        options.theta_points, options.r_points,
+        options.r_min, options.r_max,
+        0.0, 0.0,
+    };
+    const bool use_cache = !options.cache_dir.empty();
+    const auto path = use_cache
+        ? cache_file(options.cache_dir, expected)
+        : std::filesystem::path{};
+
+    if(use_cache)
+        if(auto table = load_table(path, expected))
+        {
+            table_ = std::make_shared<const Table>(std::move(*table));
+            return;
+        }
+
+    auto coeffs = std::make_shared<const std::vector<double>>(
+        build_coeffs(expected));
+    Table table{expected, {coeffs, coeffs->data()}, false};
+    measure_errors(table);
+
+    if(use_cache)
+        store_table(path, table);
+
+    table_ = std::make_shared<const Table>(std::move(table));
+}
+
+
+auto TabulatedLithiumCyanide::max_potential_error() const noexcept -> double
+{ return table_->header.max_potential_error; }
+
+
+auto TabulatedLithiumCyanide::max_force_error() const noexcept -> double
+{ return table_->header.max_force_error; }
+
+
+auto TabulatedLithiumCyanide::is_cached() const noexcept -> bool
+{ return table_->cached; }
+
+
+void potential_into(
+    const TabulatedLithiumCyanide& model,
+    const VectorsCRef& states,
+    double t,
+    ScalarsRef out
+) noexcept
+{
+    assert(states.cols() == 2 * degrees_of_freedom(model));
+    evaluate<true, false>(model.table(), states, t, &out, nullptr);
+}
+
+
+void force_into(
+    const TabulatedLithiumCyanide& model,
+    const VectorsCRef& states,
+    double t,
+    VectorsRef out
+) noexcept
+{
+    assert(states.cols() == 2 * degrees_of_freedom(model));
+    evaluate<false, true>(model.table(), states, t, nullptr, &out);
+}
+
+
+void energy_and_force_into(
+    const TabulatedLithiumCyanide& model,
+    const VectorsCRef& states,
+    double t,
+    ScalarsRef potential_out,
+    VectorsRef force_out
+) noexcept
+{
+    assert(states.cols() == 2 * degrees_of_freedom(model));
+    evaluate<true, true>(
+        model.table(), states, t, &potential_out, &force_out);
+}
+
+
+void masses_into(
+    [[maybe_unused]] const TabulatedLithiumCyanide& model,
+    const VectorsCRef& states,
+    VectorsRef out
+) noexcept
+{ masses_into(LithiumCyanide{}, states, std::move(out)); }
+
+} // namespace mfptlib
@@ -5,6 +5,7 @@
 #ifndef MFPTLIB_TEST_EULERSTEPPER_HPP
 #define MFPTLIB_TEST_EULERSTEPPER_HPP
 
+#include <atomic>
 #include <cstddef>
 #include <memory>
 
@@ -20,9 +21,9 @@ struct EulerStepper
 {
     struct Stats
     {
-        std::size_t step{};
-        std::size_t filter_states{};
-        std::size_t reset{};
+        std::atomic<std::size_t> step{};
+        std::atomic<std::size_t> filter_states{};
+        std::atomic<std::size_t> reset{};
     };
     using StatsPtr = std::shared_ptr<Stats>;
 
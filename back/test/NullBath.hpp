@@ -5,6 +5,7 @@
 #ifndef MFPTLIB_TEST_NULLBATH_HPP
 #define MFPTLIB_TEST_NULLBATH_HPP
 
+#include <atomic>
 #include <cstddef>
 
 #include <mfptlib/core/Types.hpp>
@@ -17,9 +18,9 @@ struct NullBath
 {
     struct Stats
     {
-        std::size_t apply_forces{};
-        std::size_t filter_states{};
-        std::size_t reset{};
+        std::atomic<std::size_t> apply_forces{};
+        std::atomic<std::size_t> filter_states{};
+        std::atomic<std::size_t> reset{};
     };
     using StatsPtr = std::shared_ptr<Stats>;
 
@@ -1,6 +1,9 @@
 // Copyright 2022 Johannes Reiff
 // SPDX-License-Identifier: Apache-2.0
 
+#include <stdexcept>
+#include <utility>
+
 #include <catch2/catch.hpp>
 
 #include <mfptlib/core/Cache.hpp>
@@ -19,6 +22,34 @@ TEST_CASE("core/Cache", "[core]")
         REQUIRE(cache.size() == 0);
         REQUIRE_THAT(*cache, mfptlib::test::equals<double>({}));
 
+        SECTION("Filtering an empty cache has no effect.")
+        {
+            cache.filter_rows(mfptlib::Booleans{{true, false}});
+            REQUIRE(cache.rows() == 0);
+        }
+
+        SECTION("Splitting an empty cache yields empty caches.")
+        {
+            const mfptlib::Cache<mfptlib::Vectors> tail = cache.split_rows(2);
+            REQUIRE(cache.rows() == 0);
+            REQUIRE(tail.rows() == 0);
+        }
+
+        SECTION("A cache can be resized.")
+        {
+            cache.resize(4, 2);
+            REQUIRE(cache.rows() == 4);
+            REQUIRE(cache.cols() == 2);
+
+            (*cache).setConstant(1.0);
+            const double* data = (*cache).data();
+            cache.resize(3, 2);
+            REQUIRE(cache.rows() == 3);
+            REQUIRE((*cache).data() == data);
+            REQUIRE_THAT(*cache, mfptlib::test::equals(
+                {{1.0, 1.0}, {1.0, 1.0}, {1.0, 1.0}}));
+        }
+
         SECTION("Data can be assigned.")
         {
             cache = mfptlib::Vectors{
@@ -57,7 +88,77 @@ TEST_CASE("core/Cache", "[core]")
                 REQUIRE(cache.cols() == 2);
                 REQUIRE(cache.size() == 6);
                 REQUIRE_THAT(*cache, mfptlib::test::equals(
-                    {{1.0, 2.0}, {7.0, 8.0}, {5.0, 6.0}}));
+                    {{1.0, 2.0}, {5.0, 6.0}, {7.0, 8.0}}));
+            }
+
+            SECTION("Rows can be split off into a new cache.")
+            {
+                const mfptlib::Cache<mfptlib::Vectors> tail = cache.split_rows(1);
+                REQUIRE(cache.rows() == 1);
+                REQUIRE(tail.rows() == 3);
+                REQUIRE(tail.cols() == 2);
+                REQUIRE_THAT(*cache, mfptlib::test::equals({{1.0, 2.0}}));
+                REQUIRE_THAT(*tail, mfptlib::test::equals(
+                    {{3.0, 4.0}, {5.0, 6.0}, {7.0, 8.0}}));
+            }
+
+            SECTION("A cache can be bound to external columns.")
+            {
+                mfptlib::Vectors columns{4, 3};
+                columns.col(2).setConstant(9.0);
+                cache.bind(columns.leftCols(2));
+                REQUIRE(cache.bound());
+                REQUIRE((*cache).data() == columns.data());
+                REQUIRE_THAT(mfptlib::Vectors{columns.leftCols(2)},
+                    mfptlib::test::equals(
+                        {{1.0, 2.0}, {3.0, 4.0}, {5.0, 6.0}, {7.0, 8.0}}));
+
+                SECTION("Filtering leaves moving the rows to the owner.")
+                {
+                    columns.row(1) = columns.row(3);
+                    cache.filter_rows({{true, false, true, true}});
+                    REQUIRE(cache.rows() == 3);
+                    REQUIRE((*cache).data() == columns.data());
+                    REQUIRE_THAT(*cache, mfptlib::test::equals(
+                        {{1.0, 2.0}, {7.0, 8.0}, {5.0, 6.0}}));
+                }
+
+                SECTION("Split caches share the columns and join again.")
+                {
+                    mfptlib::Cache<mfptlib::Vectors> tail = cache.split_rows(1);
+                    REQUIRE(tail.bound());
+                    REQUIRE((*tail).data() == columns.data() + 1);
+                    REQUIRE_THAT(*cache, mfptlib::test::equals({{1.0, 2.0}}));
+                    REQUIRE_THAT(*tail, mfptlib::test::equals(
+                        {{3.0, 4.0}, {5.0, 6.0}, {7.0, 8.0}}));
+
+                    cache.join_rows(std::move(tail));
+                    REQUIRE(cache.rows() == 4);
+                    REQUIRE((*cache).data() == columns.data());
+                }
+
+                SECTION("Unbinding copies the rows into own storage.")
+                {
+                    cache.unbind();
+                    columns.setZero();
+                    REQUIRE(!cache.bound());
+                    REQUIRE_THAT(*cache, mfptlib::test::equals(
+                        {{1.0, 2.0}, {3.0, 4.0}, {5.0, 6.0}, {7.0, 8.0}}));
+                }
+
+                SECTION("Assigning a different shape drops the binding.")
+                {
+                    cache = mfptlib::Vectors{{1.0, 2.0, 3.0}};
+                    REQUIRE(!cache.bound());
+                    REQUIRE(columns(0, 2) == 9.0);
+                }
+            }
+
+            SECTION("Binding columns of a different shape throws.")
+            {
+                mfptlib::Vectors columns{3, 2};
+                REQUIRE_THROWS_AS(
+                    cache.bind(columns), std::invalid_argument);
             }
 
             SECTION("A cache can be reset.")
@@ -0,0 +1,110 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdexcept>
+
+#include <catch2/catch.hpp>
+
+#include <mfptlib/core/Compaction.hpp>
+#include <mfptlib/core/Types.hpp>
+
+#include "../Matcher.hpp"
+
+
+TEST_CASE("core/Compaction", "[core]")
+{
+    // Long enough to cover full vector widths, a partial remainder,
+    // and more than one mask word.
+    const mfptlib::Index size = 75;
+    const mfptlib::Booleans predicate =
+        mfptlib::Indices::LinSpaced(size, 0, size - 1).unaryExpr(
+            [](mfptlib::Index i){ return i % 3 == 0 or i % 7 == 2; }
+        ).cast<bool>();
+
+    mfptlib::Vectors states{size, 3};
+    for(mfptlib::Index i = 0; i < size; ++i)
+        states.row(i) << double(i), -double(i), 0.5 * double(i);
+
+    mfptlib::Vectors expected_states{size, 3};
+    mfptlib::Indices expected_order{size};
+    mfptlib::Index num_selected{0};
+    for(mfptlib::Index pass = 0, row = 0; pass < 2; ++pass)
+        for(mfptlib::Index i = 0; i < size; ++i)
+            if(predicate[i] == (pass == 0))
+            {
+                expected_states.row(row) = states.row(i);
+                expected_order[row++] = i;
+                num_selected += (pass == 0);
+            }
+
+    SECTION("RowMask packs a predicate.")
+    {
+        const mfptlib::RowMask mask{predicate};
+        REQUIRE(mask.size() == size);
+        REQUIRE(mask.count() == num_selected);
+        for(mfptlib::Index i = 0; i < size; ++i)
+            REQUIRE(mask[i] == predicate[i]);
+    }
+
+    SECTION("compress_rows() stably moves selected rows to the top.")
+    {
+        const mfptlib::Index count =
+            mfptlib::compress_rows(states, mfptlib::RowMask{predicate});
+        REQUIRE(count == num_selected);
+        REQUIRE_THAT(states.topRows(count), mfptlib::test::equals(
+            expected_states.topRows(count)));
+    }
+
+    SECTION("partition_rows() stably partitions states.")
+    {
+        const mfptlib::Index count =
+            mfptlib::partition_rows(states, mfptlib::RowMask{predicate});
+        REQUIRE(count == num_selected);
+        REQUIRE_THAT(states, mfptlib::test::equals(expected_states));
+    }
+
+    SECTION("partition_rows() stably partitions indices.")
+    {
+        mfptlib::Indices order = mfptlib::Indices::LinSpaced(size, 0, size - 1);
+        const mfptlib::Index count =
+            mfptlib::partition_rows(order, mfptlib::RowMask{predicate});
+        REQUIRE(count == num_selected);
+        REQUIRE_THAT(order, mfptlib::test::equals(expected_order));
+    }
+
+    SECTION("partition_rows() handles masks selecting all or no rows.")
+    {
+        for(const bool value : {true, false})
+        {
+            mfptlib::Vectors partitioned = states;
+            mfptlib::Indices order =
+                mfptlib::Indices::LinSpaced(size, 0, size - 1);
+            const mfptlib::RowMask mask{
+                mfptlib::Booleans::Constant(size, value)};
+            REQUIRE(mfptlib::partition_rows(partitioned, mask)
+                == (value ? size : 0));
+            REQUIRE(mfptlib::partition_rows(order, mask)
+                == (value ? size : 0));
+            REQUIRE_THAT(partitioned, mfptlib::test::equals(states));
+            REQUIRE_THAT(order, mfptlib::test::equals(
+                mfptlib::Indices{mfptlib::Indices::LinSpaced(
+                    size, 0, size - 1)}));
+        }
+    }
+
+    SECTION("scatter_rows() inverts a partition.")
+    {
+        const mfptlib::Vectors original = states;
+        mfptlib::scatter_rows(expected_states, expected_order);
+        REQUIRE_THAT(expected_states, mfptlib::test::equals(original));
+    }
+
+    SECTION("Compaction throws if the sizes do not match.")
+    {
+        const mfptlib::RowMask mask{predicate.head(size - 1)};
+        REQUIRE_THROWS_AS(
+            mfptlib::compress_rows(states, mask), std::invalid_argument);
+        REQUIRE_THROWS_AS(
+            mfptlib::partition_rows(states, mask), std::invalid_argument);
+    }
+}
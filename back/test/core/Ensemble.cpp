@@ -0,0 +1,68 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdexcept>
+
+#include <catch2/catch.hpp>
+
+#include <mfptlib/core/Ensemble.hpp>
+#include <mfptlib/core/Types.hpp>
+
+#include "../Matcher.hpp"
+
+
+TEST_CASE("core/Ensemble", "[core]")
+{
+    mfptlib::Ensemble ensemble{mfptlib::Vectors{
+        {1.0, 2.0}, {3.0, 4.0}, {5.0, 6.0}}};
+
+    SECTION("An Ensemble initially only contains the states.")
+    {
+        REQUIRE(ensemble.rows() == 3);
+        REQUIRE(ensemble.state_cols() == 2);
+        REQUIRE(ensemble.data().cols() == 2);
+        REQUIRE_THAT(mfptlib::Vectors{ensemble.states()},
+            mfptlib::test::equals({{1.0, 2.0}, {3.0, 4.0}, {5.0, 6.0}}));
+    }
+
+    SECTION("Auxiliary columns follow the states.")
+    {
+        const mfptlib::Index labels = ensemble.add_columns(1);
+        const mfptlib::Index weights = ensemble.add_columns(2, 0.5);
+        REQUIRE(labels == 2);
+        REQUIRE(weights == 3);
+        REQUIRE(ensemble.state_cols() == 2);
+        REQUIRE(ensemble.data().cols() == 5);
+
+        ensemble.columns(labels, 1) = mfptlib::Vectors{{7.0}, {8.0}, {9.0}};
+        REQUIRE_THAT(mfptlib::Vectors{ensemble.states()},
+            mfptlib::test::equals({{1.0, 2.0}, {3.0, 4.0}, {5.0, 6.0}}));
+        REQUIRE_THAT(mfptlib::Vectors{ensemble.columns(weights, 2)},
+            mfptlib::test::equals({{0.5, 0.5}, {0.5, 0.5}, {0.5, 0.5}}));
+        REQUIRE_THAT(mfptlib::Vectors{ensemble.data()}, mfptlib::test::equals({
+            {1.0, 2.0, 7.0, 0.5, 0.5},
+            {3.0, 4.0, 8.0, 0.5, 0.5},
+            {5.0, 6.0, 9.0, 0.5, 0.5},
+        }));
+    }
+
+    SECTION("Auxiliary columns can be removed again.")
+    {
+        const mfptlib::Index labels = ensemble.add_columns(1, 7.0);
+        ensemble.add_columns(2);
+        ensemble.remove_columns(labels + 1);
+        REQUIRE(ensemble.data().cols() == 3);
+        REQUIRE_THAT(mfptlib::Vectors{ensemble.data()}, mfptlib::test::equals({
+            {1.0, 2.0, 7.0},
+            {3.0, 4.0, 7.0},
+            {5.0, 6.0, 7.0},
+        }));
+
+        REQUIRE_THROWS_AS(ensemble.remove_columns(1), std::invalid_argument);
+    }
+
+    SECTION("Adding a negative number of columns throws.")
+    {
+        REQUIRE_THROWS_AS(ensemble.add_columns(-1), std::invalid_argument);
+    }
+}
@@ -0,0 +1,58 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include <unistd.h>
+
+#include <catch2/catch.hpp>
+
+#include <mfptlib/core/MappedFile.hpp>
+
+
+TEST_CASE("core/MappedFile", "[core]")
+{
+    const auto dir = std::filesystem::temp_directory_path()
+        / ("mfptlib-test-mapped-file-" + std::to_string(::getpid()));
+    std::filesystem::create_directories(dir);
+    const auto path = dir / "data.bin";
+
+    SECTION("A file can be mapped.")
+    {
+        std::ofstream{path, std::ios::binary} << "mfptlib";
+        const mfptlib::MappedFile file{path};
+        REQUIRE(file.size() == 7);
+        REQUIRE(std::string(
+            reinterpret_cast<const char*>(file.data()), file.size())
+            == "mfptlib");
+
+        SECTION("The mapping outlives the file and its copies.")
+        {
+            const auto bytes = mfptlib::MappedFile{file}.bytes();
+            std::filesystem::remove(path);
+            REQUIRE(bytes.get()[6] == std::byte{'b'});
+        }
+    }
+
+    SECTION("An empty file can be mapped.")
+    {
+        std::ofstream{path, std::ios::binary};
+        const mfptlib::MappedFile file{path};
+        REQUIRE(file.size() == 0);
+        REQUIRE(file.data() == nullptr);
+    }
+
+    SECTION("Mapping a missing file throws.")
+    {
+        REQUIRE_THROWS_AS(
+            mfptlib::MappedFile{dir / "missing.bin"},
+            std::runtime_error
+        );
+    }
+
+    std::filesystem::remove_all(dir);
+}
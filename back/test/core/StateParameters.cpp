@@ -0,0 +1,54 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include <catch2/catch.hpp>
+
+#include <mfptlib/core/StateParameters.hpp>
+#include <mfptlib/core/Types.hpp>
+
+#include "../Matcher.hpp"
+
+
+TEST_CASE("core/StateParameters", "[core]")
+{
+    SECTION("Default-constructed parameters are empty.")
+    {
+        const mfptlib::StateParameters parameters{};
+        REQUIRE(parameters.empty());
+        REQUIRE(parameters.rows() == 0);
+        REQUIRE(parameters.cols() == 0);
+
+        mfptlib::StateParameters head{};
+        const mfptlib::StateParameters tail = head.split_rows(2);
+        REQUIRE(head.empty());
+        REQUIRE(tail.empty());
+    }
+
+    SECTION("Parameters follow their states.")
+    {
+        mfptlib::StateParameters parameters{mfptlib::Vectors{
+            {1.0, 2.0}, {3.0, 4.0}, {5.0, 6.0}, {7.0, 8.0}}};
+        REQUIRE(!parameters.empty());
+        REQUIRE(parameters.rows() == 4);
+        REQUIRE(parameters.cols() == 2);
+
+        parameters.filter_rows(mfptlib::Booleans{{true, false, true, true}});
+        REQUIRE_THAT(*parameters, mfptlib::test::equals(
+            {{1.0, 2.0}, {5.0, 6.0}, {7.0, 8.0}}));
+
+        SECTION("Parameters can be split.")
+        {
+            const mfptlib::StateParameters tail = parameters.split_rows(1);
+            REQUIRE_THAT(*parameters, mfptlib::test::equals({{1.0, 2.0}}));
+            REQUIRE_THAT(*tail, mfptlib::test::equals(
+                {{5.0, 6.0}, {7.0, 8.0}}));
+        }
+
+        SECTION("Resetting restores all parameters.")
+        {
+            parameters.reset();
+            REQUIRE_THAT(*parameters, mfptlib::test::equals(
+                {{1.0, 2.0}, {3.0, 4.0}, {5.0, 6.0}, {7.0, 8.0}}));
+        }
+    }
+}
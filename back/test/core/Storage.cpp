@@ -0,0 +1,98 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cstdint>
+#include <stdexcept>
+
+#include <catch2/catch.hpp>
+
+#include <mfptlib/core/Storage.hpp>
+#include <mfptlib/core/Types.hpp>
+#include <mfptlib/math/Bath.hpp>
+#include <mfptlib/math/FastBaoabStepper.hpp>
+#include <mfptlib/math/LangevinBath.hpp>
+#include <mfptlib/math/Stepper.hpp>
+#include <mfptlib/sys/LithiumCyanide.hpp>
+#include <mfptlib/sys/System.hpp>
+
+#include "../Matcher.hpp"
+
+
+TEST_CASE("core/Storage", "[core]")
+{
+    const mfptlib::Vectors states{
+        {0.1, 4.5, 0.1, 0.2},
+        {0.5, 4.4, 0.0, 0.1},
+        {1.0, 4.6, 0.2, 0.0},
+    };
+
+    SECTION("padded_rows() rounds up to whole blocks.")
+    {
+        REQUIRE(mfptlib::padded_rows(0) == 0);
+        REQUIRE(mfptlib::padded_rows(1) == mfptlib::BlockRows);
+        REQUIRE(mfptlib::padded_rows(mfptlib::BlockRows) == mfptlib::BlockRows);
+        REQUIRE(mfptlib::padded_rows(mfptlib::BlockRows + 1)
+            == 2 * mfptlib::BlockRows);
+    }
+
+    SECTION("PaddedVectors aligns every column and zeroes the padding.")
+    {
+        const mfptlib::PaddedVectors padded{states};
+        REQUIRE(padded.rows() == 3);
+        REQUIRE(padded.cols() == 4);
+        REQUIRE(padded.stride() == mfptlib::BlockRows);
+        REQUIRE_THAT(padded.view(), mfptlib::test::equals(states));
+
+        for(mfptlib::Index col = 0; col < padded.cols(); ++col)
+        {
+            const auto address = reinterpret_cast<std::uintptr_t>(
+                padded.view().col(col).data());
+            REQUIRE(address % mfptlib::StorageAlignment == 0);
+            REQUIRE((padded.padded().col(col).tail(5) == 0.0).all());
+        }
+    }
+
+    SECTION("PaddedVectors can be copied.")
+    {
+        const mfptlib::PaddedVectors padded{states};
+        mfptlib::PaddedVectors copy{};
+        copy = padded;
+        REQUIRE(copy.data() != padded.data());
+        REQUIRE_THAT(copy.view(), mfptlib::test::equals(states));
+    }
+
+    SECTION("PaddedVectors throws for negative sizes.")
+    {
+        REQUIRE_THROWS_AS(
+            (mfptlib::PaddedVectors{-1, 2}),
+            std::invalid_argument
+        );
+    }
+
+    SECTION("PaddedVectors can be propagated like Vectors.")
+    {
+        const mfptlib::System system{mfptlib::LithiumCyanide{}};
+        mfptlib::Stepper stepper{mfptlib::FastBaoabStepper{0.1}};
+        mfptlib::Bath bath{mfptlib::LangevinBath{1e-3, 1e-2, 42}};
+        mfptlib::Stepper padded_stepper = stepper.fork();
+        mfptlib::Bath padded_bath{mfptlib::LangevinBath{1e-3, 1e-2, 42}};
+
+        mfptlib::Vectors expected = states;
+        mfptlib::PaddedVectors padded{states};
+        REQUIRE_THAT(
+            force(system, padded, 0.0),
+            mfptlib::test::equals(force(system, states, 0.0))
+        );
+
+        double t = 0.0;
+        double padded_t = 0.0;
+        for(int i = 0; i < 3; ++i)
+        {
+            stepper.step(bath, system, expected, t);
+            padded_stepper.step(padded_bath, system, padded, padded_t);
+        }
+
+        REQUIRE(padded_t == t);
+        REQUIRE_THAT(padded.view(), mfptlib::test::equals(expected));
+    }
+}
@@ -1,11 +1,77 @@
 // Copyright 2022 Johannes Reiff
 // SPDX-License-Identifier: Apache-2.0
 
+#include <cstddef>
+#include <memory>
 #include <stdexcept>
+#include <utility>
 
 #include <catch2/catch.hpp>
 
+#include <mfptlib/core/Types.hpp>
 #include <mfptlib/math/BaoabStepper.hpp>
+#include <mfptlib/math/Observer.hpp>
+#include <mfptlib/math/Propagate.hpp>
+#include <mfptlib/math/Stepper.hpp>
+#include <mfptlib/sys/HarmonicOscillator.hpp>
+#include <mfptlib/sys/System.hpp>
+
+#include "../Matcher.hpp"
+#include "../NullBath.hpp"
+
+
+namespace {
+
+// Harmonic oscillator with configurable traits that counts evaluations.
+struct CountingOscillator
+{
+    struct Counts
+    {
+        std::size_t force{};
+        std::size_t masses{};
+    };
+
+    mfptlib::HarmonicOscillator model;
+    mfptlib::SystemTraits declared;
+    std::shared_ptr<Counts> counts = std::make_shared<Counts>();
+};
+
+auto degrees_of_freedom(const CountingOscillator& sys) -> mfptlib::Index
+{ return degrees_of_freedom(sys.model); }
+
+auto traits(const CountingOscillator& sys) -> mfptlib::SystemTraits
+{ return sys.declared; }
+
+void potential_into(
+    const CountingOscillator& sys,
+    const mfptlib::VectorsCRef& states,
+    double t,
+    mfptlib::ScalarsRef out
+)
+{ potential_into(sys.model, states, t, std::move(out)); }
+
+void force_into(
+    const CountingOscillator& sys,
+    const mfptlib::VectorsCRef& states,
+    double t,
+    mfptlib::VectorsRef out
+)
+{
+    ++sys.counts->force;
+    force_into(sys.model, states, t, std::move(out));
+}
+
+void masses_into(
+    const CountingOscillator& sys,
+    const mfptlib::VectorsCRef& states,
+    mfptlib::VectorsRef out
+)
+{
+    ++sys.counts->masses;
+    masses_into(sys.model, states, std::move(out));
+}
+
+} // namespace
 
 
 TEST_CASE("math/BaoabStepper", "[math]")
@@ -22,4 +88,119 @@ TEST_CASE("math/BaoabStepper", "[math]")
             std::invalid_argument
         );
     }
+
+    SECTION("BaoabStepper skips evaluations permitted by the traits.")
+    {
+        constexpr int steps{10};
+        const mfptlib::HarmonicOscillator model{
+            mfptlib::Vector{{1.0, 2.0}}, mfptlib::Vector{{4.0, 1.0}}};
+        const mfptlib::Vectors initial = mfptlib::Vectors::Random(5, 4);
+
+        const auto run = [&](
+            const CountingOscillator& impl, mfptlib::Vectors& states
+        )
+        {
+            const mfptlib::System system{impl};
+            auto [bath, bath_stats] = mfptlib::test::null_bath();
+            mfptlib::BaoabStepper stepper{1e-2};
+            double t{0.0};
+            stepper.begin_propagation();
+            for(int i = 0; i < steps; ++i)
+                stepper.step(bath, system, states, t);
+            stepper.end_propagation();
+        };
+
+        const CountingOscillator plain{model, {}};
+        mfptlib::Vectors expected = initial;
+        run(plain, expected);
+        REQUIRE(plain.counts->force == 2 * steps);
+        REQUIRE(plain.counts->masses == 3 * steps);
+
+        const CountingOscillator reusing{model, {
+            .velocity_independent_forces = true,
+            .constant_masses = true,
+            .time_independent_potential = true,
+        }};
+        mfptlib::Vectors states = initial;
+        run(reusing, states);
+        REQUIRE(reusing.counts->force == steps + 1);
+        REQUIRE(reusing.counts->masses == steps);
+        REQUIRE_THAT(states, mfptlib::test::equals(expected));
+    }
+
+    SECTION("BaoabStepper recomputes forces once they are invalidated.")
+    {
+        const CountingOscillator impl{
+            mfptlib::HarmonicOscillator{
+                mfptlib::Vector{{1.0}}, mfptlib::Vector{{1.0}}},
+            {.velocity_independent_forces = true,
+                .time_independent_potential = true},
+        };
+        const mfptlib::System system{impl};
+        auto [bath, bath_stats] = mfptlib::test::null_bath();
+        mfptlib::BaoabStepper stepper{1e-2};
+        mfptlib::Vectors states{{1.0, 0.0}, {0.5, 1.0}};
+        double t{0.0};
+
+        stepper.begin_propagation();
+        stepper.step(bath, system, states, t);
+        stepper.step(bath, system, states, t);
+        REQUIRE(impl.counts->force == 3);
+
+        stepper.reset();
+        stepper.step(bath, system, states, t);
+        REQUIRE(impl.counts->force == 5);
+
+        stepper.filter_states(mfptlib::Booleans{{true, false}});
+        stepper.step(bath, system, states.topRows(1), t);
+        REQUIRE(impl.counts->force == 7);
+
+        stepper.begin_propagation();
+        stepper.step(bath, system, states.topRows(1), t);
+        REQUIRE(impl.counts->force == 9);
+
+        const mfptlib::BaoabStepper tail = stepper.split_states(0);
+        stepper.step(bath, system, states.topRows(1), t);
+        REQUIRE(impl.counts->force == 11);
+
+        const mfptlib::System other{impl};
+        stepper.step(bath, other, states.topRows(1), t);
+        REQUIRE(impl.counts->force == 13);
+
+        // Manual steps outside of a propagation never reuse forces.
+        stepper.end_propagation();
+        stepper.step(bath, other, states.topRows(1), t);
+        stepper.step(bath, other, states.topRows(1), t);
+        REQUIRE(impl.counts->force == 17);
+    }
+
+    SECTION("BaoabStepper does not reuse forces across propagations.")
+    {
+        const CountingOscillator impl{
+            mfptlib::HarmonicOscillator{
+                mfptlib::Vector{{1.0}}, mfptlib::Vector{{1.0}}},
+            {.velocity_independent_forces = true,
+                .time_independent_potential = true},
+        };
+        const mfptlib::System system{impl};
+        auto [bath, bath_stats] = mfptlib::test::null_bath();
+        mfptlib::Stepper stepper{mfptlib::BaoabStepper{0.25}};
+        mfptlib::Vectors states{{1.0, 0.0}, {0.5, 1.0}};
+
+        mfptlib::propagate_to(stepper, bath, system, states, 0.0, 1.0,
+            mfptlib::Observer{});
+        REQUIRE(impl.counts->force == 5);
+
+        // Modified states must not be stepped with the old forces.
+        states.col(0) += 1.0;
+        mfptlib::Vectors expected = states;
+        mfptlib::propagate_to(stepper, bath, system, states, 1.0, 2.0,
+            mfptlib::Observer{});
+        REQUIRE(impl.counts->force == 10);
+
+        mfptlib::Stepper fresh{mfptlib::BaoabStepper{0.25}};
+        mfptlib::propagate_to(fresh, bath, system, expected, 1.0, 2.0,
+            mfptlib::Observer{});
+        REQUIRE_THAT(states, mfptlib::test::equals(expected));
+    }
 }
@@ -0,0 +1,120 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include <tuple>
+
+#include <catch2/catch.hpp>
+
+#include <mfptlib/core/Types.hpp>
+#include <mfptlib/math/Bath.hpp>
+#include <mfptlib/math/Dispatch.hpp>
+#include <mfptlib/math/ExpMemoryBath.hpp>
+#include <mfptlib/math/FastBaoabStepper.hpp>
+#include <mfptlib/math/LangevinBath.hpp>
+#include <mfptlib/math/LfMiddleStepper.hpp>
+#include <mfptlib/math/Observer.hpp>
+#include <mfptlib/math/Predicate.hpp>
+#include <mfptlib/math/Propagate.hpp>
+#include <mfptlib/math/Stepper.hpp>
+#include <mfptlib/sys/HarmonicOscillator.hpp>
+#include <mfptlib/sys/System.hpp>
+
+#include "../EulerStepper.hpp"
+#include "../Matcher.hpp"
+
+
+namespace {
+
+// Same physics as HarmonicOscillator, but without a precompiled kernel.
+struct CustomOscillator : mfptlib::HarmonicOscillator
+{
+    using HarmonicOscillator::HarmonicOscillator;
+};
+
+} // namespace
+
+
+TEST_CASE("math/Dispatch", "[math]")
+{
+    const mfptlib::Vector masses{{1.0, 2.0}};
+    const mfptlib::Vector strengths{{1.0, 0.5}};
+
+    SECTION("target() returns the wrapped implementation.")
+    {
+        mfptlib::Stepper stepper{mfptlib::FastBaoabStepper{0.1}};
+        mfptlib::Bath bath{mfptlib::LangevinBath{1.0, 1.0, 42}};
+        const mfptlib::System system{
+            mfptlib::HarmonicOscillator{masses, strengths}};
+
+        REQUIRE(stepper.target<mfptlib::FastBaoabStepper>() != nullptr);
+        REQUIRE(stepper.target<mfptlib::LfMiddleStepper>() == nullptr);
+        REQUIRE(bath.target<mfptlib::LangevinBath>() != nullptr);
+        REQUIRE(bath.target<mfptlib::ExpMemoryBath>() == nullptr);
+        REQUIRE(system.target<mfptlib::HarmonicOscillator>() != nullptr);
+        REQUIRE(system.target<CustomOscillator>() == nullptr);
+    }
+
+    SECTION("has_static_kernel() only accepts built-in combinations.")
+    {
+        const mfptlib::Stepper stepper{mfptlib::LfMiddleStepper{0.1}};
+        const mfptlib::Bath bath{mfptlib::ExpMemoryBath{1.0, 1.0, 1.0, 42}};
+        const mfptlib::System system{
+            mfptlib::HarmonicOscillator{masses, strengths}};
+        const mfptlib::System custom{CustomOscillator{masses, strengths}};
+        auto [euler, euler_stats] = mfptlib::test::euler_stepper();
+
+        REQUIRE(mfptlib::has_static_kernel(stepper, bath, system));
+        REQUIRE(!mfptlib::has_static_kernel(stepper, bath, custom));
+        REQUIRE(!mfptlib::has_static_kernel(euler, bath, system));
+    }
+
+    SECTION("Static kernels match the type-erased propagation.")
+    {
+        // Fixed-size kernels are used for up to three DoFs.
+        const mfptlib::Index dofs = GENERATE(1, 2, 3, 4);
+        const mfptlib::Vector masses =
+            mfptlib::Vector::LinSpaced(dofs, 1.0, 2.0);
+        const mfptlib::Vector strengths =
+            mfptlib::Vector::LinSpaced(dofs, 1.0, 0.5);
+
+        const mfptlib::Predicate predicate{
+            [](const mfptlib::VectorsCRef& s, double) -> mfptlib::Booleans
+            { return s.col(0) < 1.0; }};
+
+        mfptlib::Vectors states{4, 2 * dofs};
+        states.col(0) << 0.0, 0.5, 0.9, 1.5;
+        states.rightCols(2 * dofs - 1).setConstant(0.5);
+        mfptlib::Vectors expected_states = states;
+
+        const auto run = [&](const mfptlib::System& system, auto& qp)
+        {
+            mfptlib::Stepper stepper{mfptlib::FastBaoabStepper{0.1}};
+            mfptlib::Bath bath{mfptlib::ExpMemoryBath{0.1, 1.0, 0.5, 42}};
+
+            mfptlib::Index num_observed{0};
+            const mfptlib::Observer observer{
+                [&](const mfptlib::VectorsCRef& s, double)
+                { num_observed += s.rows(); }};
+
+            const mfptlib::Scalars t_end = mfptlib::propagate_while(
+                stepper, bath, system, qp, 0.0, predicate, observer);
+            stepper.reset();
+            bath.reset();
+            const double t = mfptlib::propagate_to(
+                stepper, bath, system, qp, 0.0, 1.0, observer);
+            return std::tuple{t_end, t, num_observed};
+        };
+
+        const mfptlib::System system{
+            mfptlib::HarmonicOscillator{masses, strengths}};
+        const mfptlib::System custom{CustomOscillator{masses, strengths}};
+        const auto [t_end, t, num_observed] = run(system, states);
+        const auto [expected_t_end, expected_t, expected_observed] =
+            run(custom, expected_states);
+
+        REQUIRE(num_observed == expected_observed);
+        REQUIRE(t == expected_t);
+        REQUIRE_THAT(t_end, mfptlib::test::equals(expected_t_end));
+        REQUIRE_THAT(states, mfptlib::test::equals(expected_states));
+    }
+}
@@ -7,6 +7,9 @@
 
 #include <mfptlib/core/Types.hpp>
 #include <mfptlib/math/LangevinBath.hpp>
+#include <mfptlib/math/NoiseSource.hpp>
+
+#include "../Matcher.hpp"
 
 
 TEST_CASE("math/LangevinBath", "[math]")
@@ -24,4 +27,62 @@ TEST_CASE("math/LangevinBath", "[math]")
             std::invalid_argument
         );
     }
+
+    SECTION("LangevinBath accepts parameters per state.")
+    {
+        const mfptlib::Scalars kb_t{{1.0, 2.0, 0.5}};
+        const mfptlib::Scalars friction{{0.5, 1.0, 2.0}};
+        const mfptlib::NoiseSource noise{42};
+        REQUIRE_NOTHROW(mfptlib::LangevinBath{kb_t, friction, noise});
+        REQUIRE_THROWS_AS(
+            (mfptlib::LangevinBath{-kb_t, friction, noise}),
+            std::invalid_argument
+        );
+        REQUIRE_THROWS_AS(
+            (mfptlib::LangevinBath{kb_t, -friction, noise}),
+            std::invalid_argument
+        );
+        REQUIRE_THROWS_AS(
+            (mfptlib::LangevinBath{kb_t, friction.head(2), noise}),
+            std::invalid_argument
+        );
+
+        // Each state sees the same noise as with shared parameters.
+        const auto counter = []
+        {
+            return mfptlib::NoiseSource{
+                42, mfptlib::NoiseGenerator::Counter};
+        };
+        const mfptlib::Vectors masses = mfptlib::Vectors::Constant(3, 2, 1.5);
+        const mfptlib::Vectors initial = mfptlib::Vectors::Ones(3, 2);
+        mfptlib::LangevinBath bath{kb_t, friction, counter()};
+        mfptlib::Vectors momenta = initial;
+        bath.apply_forces(momenta, masses, 0.1);
+        for(mfptlib::Index i = 0; i < kb_t.size(); ++i)
+        {
+            mfptlib::LangevinBath shared{kb_t[i], friction[i], counter()};
+            mfptlib::Vectors expected = initial;
+            shared.apply_forces(expected, masses, 0.1);
+            REQUIRE_THAT(mfptlib::Vectors{momenta.middleRows(i, 1)},
+                mfptlib::test::approx(
+                    mfptlib::Vectors{expected.middleRows(i, 1)}, 1e-12));
+        }
+
+        SECTION("Parameters per state follow their states.")
+        {
+            bath.filter_states(mfptlib::Booleans{{true, false, true}});
+            mfptlib::LangevinBath tail = bath.split_states(1);
+            REQUIRE_THROWS_AS(
+                bath.apply_forces(momenta, masses, 0.1),
+                std::invalid_argument
+            );
+            REQUIRE_NOTHROW(bath.apply_forces(
+                momenta.topRows(1), masses.topRows(1), 0.1));
+            REQUIRE_NOTHROW(tail.apply_forces(
+                momenta.topRows(1), masses.topRows(1), 0.1));
+
+            bath.reset();
+            REQUIRE_NOTHROW(bath.apply_forces(momenta, masses, 0.1));
+        }
+    }
 }
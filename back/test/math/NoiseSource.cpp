@@ -0,0 +1,222 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+#include <catch2/catch.hpp>
+#include <pcg_random.hpp>
+
+#include <mfptlib/core/Types.hpp>
+#include <mfptlib/math/NoiseSource.hpp>
+
+#include "../Matcher.hpp"
+
+
+TEST_CASE("math/NoiseSource", "[math]")
+{
+    using mfptlib::NoiseGenerator;
+
+    SECTION("The scalar generator reproduces pcg64 and std::normal_distribution.")
+    {
+        mfptlib::NoiseSource source{42, NoiseGenerator::Scalar};
+        mfptlib::Vectors noise{7, 3};
+        source.fill(noise, 0.5);
+
+        pcg64_oneseq rng{42};
+        std::normal_distribution normal{0.0, 0.5};
+        const mfptlib::Vectors expected = mfptlib::Vectors::NullaryExpr(
+            7, 3, [&](){ return normal(rng); });
+        REQUIRE_THAT(noise, mfptlib::test::equals(expected));
+    }
+
+    SECTION("The vectorized generator draws from N(0, stddev²).")
+    {
+        mfptlib::NoiseSource source{42};
+        mfptlib::Vectors noise{100'000, 2};
+        source.fill(noise, 2.0);
+
+        const double mean = noise.mean();
+        const double variance = (noise - mean).square().mean();
+        const double kurtosis = (noise - mean).square().square().mean()
+            / (variance * variance);
+        REQUIRE(std::abs(mean) < 0.02);
+        REQUIRE(std::abs(variance - 4.0) < 0.05);
+        REQUIRE(std::abs(kurtosis - 3.0) < 0.05);
+        REQUIRE(noise.isFinite().all());
+
+        // About 4.6% of the values should lie outside of ±2 stddev.
+        const double tails = (noise.abs() > 4.0).cast<double>().mean();
+        REQUIRE(std::abs(tails - 0.0455) < 0.003);
+    }
+
+    SECTION("Noise does not depend on how arrays are split between calls.")
+    {
+        mfptlib::NoiseSource whole{42};
+        mfptlib::Vectors expected{333, 2};
+        whole.fill(expected, 1.0);
+
+        mfptlib::NoiseSource parts{42};
+        mfptlib::Vectors first{100, 1};
+        mfptlib::Vectors second{233, 1};
+        mfptlib::Vectors third{333, 1};
+        parts.fill(first, 1.0);
+        parts.fill(second, 1.0);
+        parts.fill(third, 1.0);
+
+        REQUIRE_THAT(first, mfptlib::test::equals(expected.col(0).head(100)));
+        REQUIRE_THAT(second, mfptlib::test::equals(expected.col(0).tail(233)));
+        REQUIRE_THAT(third, mfptlib::test::equals(expected.col(1)));
+    }
+
+    SECTION("Forks are reproducible and independent.")
+    {
+        for(NoiseGenerator generator :
+            {NoiseGenerator::Vectorized, NoiseGenerator::Scalar})
+        {
+            mfptlib::NoiseSource source{42, generator};
+            mfptlib::NoiseSource forked = source.fork();
+            mfptlib::NoiseSource forked_again =
+                mfptlib::NoiseSource{42, generator}.fork();
+            REQUIRE(forked.generator() == generator);
+
+            mfptlib::Vectors noise{50, 2};
+            mfptlib::Vectors forked_noise{50, 2};
+            mfptlib::Vectors forked_again_noise{50, 2};
+            source.fill(noise, 1.0);
+            forked.fill(forked_noise, 1.0);
+            forked_again.fill(forked_again_noise, 1.0);
+
+            REQUIRE_THAT(
+                forked_again_noise, mfptlib::test::equals(forked_noise));
+            REQUIRE((forked_noise != noise).all());
+        }
+    }
+
+    SECTION("Prefetched noise is the same as vectorized noise.")
+    {
+        mfptlib::NoiseSource direct{42};
+        mfptlib::NoiseSource prefetched{
+            42, NoiseGenerator::Vectorized, mfptlib::Prefetch::On};
+        REQUIRE(prefetched.prefetch() == mfptlib::Prefetch::On);
+
+        for(mfptlib::Index rows : {1000, 1000, 600, 600, 37, 5000, 1})
+        {
+            mfptlib::Vectors expected{rows, 3};
+            mfptlib::Vectors noise{rows, 3};
+            direct.fill(expected, 2.0);
+            prefetched.fill(noise, 2.0);
+            REQUIRE_THAT(noise, mfptlib::test::equals(expected));
+            prefetched.filter_states(mfptlib::Booleans::Constant(rows, true));
+        }
+
+        mfptlib::NoiseSource forked = prefetched.fork();
+        mfptlib::NoiseSource direct_forked = direct.fork();
+        REQUIRE(forked.prefetch() == mfptlib::Prefetch::Off);
+        REQUIRE(prefetched.split_states(0).prefetch()
+            == mfptlib::Prefetch::Off);
+        mfptlib::Vectors expected{100, 2};
+        mfptlib::Vectors noise{100, 2};
+        direct_forked.fill(expected, 1.0);
+        forked.fill(noise, 1.0);
+        REQUIRE_THAT(noise, mfptlib::test::equals(expected));
+
+        REQUIRE_THROWS_AS(
+            (mfptlib::NoiseSource{
+                42, NoiseGenerator::Counter, mfptlib::Prefetch::On}),
+            std::invalid_argument
+        );
+    }
+
+    SECTION("philox4x32() reproduces the known-answer tests.")
+    {
+        using mfptlib::detail::philox4x32;
+        REQUIRE(philox4x32({0, 0, 0, 0}, {0, 0})
+            == mfptlib::detail::PhiloxCounter{
+                0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8});
+        REQUIRE(philox4x32(
+                {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+                {0xffffffff, 0xffffffff})
+            == mfptlib::detail::PhiloxCounter{
+                0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd});
+        REQUIRE(philox4x32(
+                {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+                {0xa4093822, 0x299f31d0})
+            == mfptlib::detail::PhiloxCounter{
+                0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1});
+    }
+
+    SECTION("Counter-based noise only depends on trajectory and step.")
+    {
+        mfptlib::NoiseSource whole{42, NoiseGenerator::Counter};
+        mfptlib::Vectors expected{10, 3};
+        mfptlib::Vectors expected_next{10, 3};
+        whole.fill(expected, 0.5);
+        whole.fill(expected_next, 0.5);
+
+        mfptlib::NoiseSource head{42, NoiseGenerator::Counter};
+        mfptlib::NoiseSource tail = head.split_states(4);
+        mfptlib::Vectors noise{10, 3};
+        head.fill(noise.topRows(4), 0.5);
+        tail.fill(noise.bottomRows(6), 0.5);
+        REQUIRE_THAT(noise, mfptlib::test::equals(expected));
+
+        mfptlib::Booleans keep{10};
+        keep << true, false, false, true, true, false, true, true, false, true;
+        tail.filter_states(keep.tail(6));
+        mfptlib::Vectors next{4, 3};
+        tail.fill(next, 0.5);
+        REQUIRE_THAT(next.row(0), mfptlib::test::equals(expected_next.row(4)));
+        REQUIRE_THAT(next.row(1), mfptlib::test::equals(expected_next.row(6)));
+        REQUIRE_THAT(next.row(2), mfptlib::test::equals(expected_next.row(7)));
+        REQUIRE_THAT(next.row(3), mfptlib::test::equals(expected_next.row(9)));
+
+        REQUIRE_THROWS_AS(tail.fill(next.topRows(2), 0.5),
+            std::invalid_argument);
+    }
+
+    SECTION("Counter-based forks take over the noise of their parent.")
+    {
+        mfptlib::NoiseSource source{42, NoiseGenerator::Counter};
+        mfptlib::Vectors expected{10, 2};
+        mfptlib::NoiseSource{42, NoiseGenerator::Counter}.fill(expected, 1.0);
+
+        mfptlib::NoiseSource forked = source.fork();
+        mfptlib::Vectors forked_noise{10, 2};
+        mfptlib::Vectors noise{10, 2};
+        forked.fill(forked_noise, 1.0);
+        source.fill(noise, 1.0);
+
+        REQUIRE_THAT(forked_noise, mfptlib::test::equals(expected));
+        REQUIRE((noise != expected).all());
+    }
+
+    SECTION("Replayed noise is read by trajectory and step.")
+    {
+        const mfptlib::Vectors replay{
+            {0.0, 1.0, 2.0, 3.0},
+            {4.0, 5.0, 6.0, 7.0},
+            {8.0, 9.0, 10.0, 11.0},
+        };
+        mfptlib::NoiseSource source{replay};
+        REQUIRE(source.generator() == NoiseGenerator::Replay);
+
+        mfptlib::Vectors noise{3, 2};
+        source.fill(noise, 2.0);
+        REQUIRE_THAT(noise, mfptlib::test::equals(
+            {{0.0, 2.0}, {8.0, 10.0}, {16.0, 18.0}}));
+
+        source.filter_states(mfptlib::Booleans{{false, true, true}});
+        source.fill(noise.topRows(2), 1.0);
+        REQUIRE_THAT(noise.topRows(2), mfptlib::test::equals(
+            {{6.0, 7.0}, {10.0, 11.0}}));
+
+        REQUIRE_THROWS_AS(source.fill(noise.topRows(2), 1.0),
+            std::runtime_error);
+        REQUIRE_THROWS_AS(
+            (mfptlib::NoiseSource{42, NoiseGenerator::Replay}),
+            std::invalid_argument
+        );
+    }
+}
@@ -1,12 +1,16 @@
 // Copyright 2022 Johannes Reiff
 // SPDX-License-Identifier: Apache-2.0
 
+#include <limits>
+#include <numbers>
 #include <stdexcept>
 
 #include <catch2/catch.hpp>
 
 #include <mfptlib/core/Types.hpp>
 #include <mfptlib/math/Predicate.hpp>
+#include <mfptlib/sys/HarmonicOscillator.hpp>
+#include <mfptlib/sys/System.hpp>
 
 #include "../Matcher.hpp"
 
@@ -49,4 +53,150 @@ TEST_CASE("math/Predicate", "[math]")
             std::invalid_argument
         );
     }
+
+    SECTION("Predicates can be combined with logical operators.")
+    {
+        const mfptlib::Predicate lhs{[](const mfptlib::VectorsCRef& s, double)
+            { return s.col(0) >= 2.0; }};
+        const mfptlib::Predicate rhs{[](const mfptlib::VectorsCRef& s, double)
+            { return s.col(1) < 3.0; }};
+
+        REQUIRE_THAT(
+            (lhs && rhs)(states, t),
+            mfptlib::test::equals({false, true, false})
+        );
+        REQUIRE_THAT(
+            (lhs || rhs)(states, t),
+            mfptlib::test::equals({true, true, true})
+        );
+        REQUIRE_THAT(
+            (!lhs)(states, t),
+            mfptlib::test::equals({true, false, false})
+        );
+    }
+}
+
+
+TEST_CASE("math/Predicate/native", "[math]")
+{
+    const double pi = std::numbers::pi;
+    const double inf = std::numeric_limits<double>::infinity();
+    const double t{0.0};
+    const mfptlib::Vectors states{
+        { 0.0     ,  0.0,  1.0,  0.0},
+        { 1.0     ,  1.0,  0.0,  1.0},
+        {-3.0     ,  4.0,  0.0,  0.0},
+        { 2.0 * pi, -1.0,  2.0, -2.0},
+    };
+
+    SECTION("coordinate_interval() checks a single column.")
+    {
+        REQUIRE_THAT(
+            mfptlib::coordinate_interval(1, 0.0, 4.0)(states, t),
+            mfptlib::test::equals({true, true, false, false})
+        );
+        REQUIRE_THAT(
+            mfptlib::coordinate_interval(2, 1.0, inf)(states, t),
+            mfptlib::test::equals({true, false, false, true})
+        );
+        REQUIRE_THROWS_AS(
+            mfptlib::coordinate_interval(4, 0.0, 1.0)(states, t),
+            std::invalid_argument
+        );
+        REQUIRE_THROWS_AS(
+            mfptlib::coordinate_interval(0, 1.0, 0.0),
+            std::invalid_argument
+        );
+    }
+
+    SECTION("coordinate_box() checks all positions.")
+    {
+        const auto pred = mfptlib::coordinate_box({{-1.0, -1.0}}, {{2.0, 2.0}});
+        REQUIRE_THAT(
+            pred(states, t),
+            mfptlib::test::equals({true, true, false, false})
+        );
+        REQUIRE_THROWS_AS(
+            mfptlib::coordinate_box({{-1.0}}, {{2.0}})(states, t),
+            std::invalid_argument
+        );
+        REQUIRE_THROWS_AS(
+            mfptlib::coordinate_box({{1.0, 1.0}}, {{0.0, 2.0}}),
+            std::invalid_argument
+        );
+    }
+
+    SECTION("half_space() checks the projection of the positions.")
+    {
+        REQUIRE_THAT(
+            mfptlib::half_space({{1.0, 1.0}}, 1.5)(states, t),
+            mfptlib::test::equals({true, false, true, false})
+        );
+    }
+
+    SECTION("radial_distance() checks the distance to a center.")
+    {
+        REQUIRE_THAT(
+            mfptlib::radial_distance({{0.0, 0.0}}, 1.0, 5.0)(states, t),
+            mfptlib::test::equals({false, true, false, false})
+        );
+        REQUIRE_THAT(
+            mfptlib::radial_distance({{1.0, 1.0}}, 0.0, 1.0)(states, t),
+            mfptlib::test::equals({false, true, false, false})
+        );
+    }
+
+    SECTION("angle_window() wraps the angle periodically.")
+    {
+        REQUIRE_THAT(
+            mfptlib::angle_window(0, 0.0, 0.6 * pi)(states, t),
+            mfptlib::test::equals({true, true, false, true})
+        );
+        REQUIRE_THAT(
+            mfptlib::angle_window(0, pi, 0.1 * pi)(states, t),
+            mfptlib::test::equals({false, false, true, false})
+        );
+        REQUIRE_THROWS_AS(
+            mfptlib::angle_window(2, 0.0, 1.0)(states, t),
+            std::invalid_argument
+        );
+    }
+
+    SECTION("Energy predicates evaluate the system.")
+    {
+        const mfptlib::System system{mfptlib::HarmonicOscillator{
+            {{1.0, 2.0}}, {{2.0, 2.0}}}};
+
+        // V = {0, 2, 25, 4π² + 1}, T = {0.5, 0.25, 0, 3}
+        REQUIRE_THAT(
+            mfptlib::potential_interval(system, 1.0, 25.0)(states, t),
+            mfptlib::test::equals({false, true, false, false})
+        );
+        REQUIRE_THAT(
+            mfptlib::total_energy_interval(system, -inf, 2.5)(states, t),
+            mfptlib::test::equals({true, true, false, false})
+        );
+
+        // Per-state parameters would not follow the compacted states.
+        const mfptlib::System per_state{mfptlib::HarmonicOscillator::per_state(
+            {{1.0, 2.0}}, mfptlib::Vectors::Constant(4, 2, 2.0))};
+        REQUIRE_THROWS_AS(
+            mfptlib::potential_interval(per_state, 1.0, 25.0),
+            std::invalid_argument
+        );
+        REQUIRE_THROWS_AS(
+            mfptlib::total_energy_interval(per_state, -inf, 2.5),
+            std::invalid_argument
+        );
+    }
+
+    SECTION("Native predicates can be combined.")
+    {
+        const auto pred = mfptlib::angle_window(0, 0.0, 0.6 * pi)
+            && !mfptlib::coordinate_interval(1, 0.5, inf);
+        REQUIRE_THAT(
+            pred(states, t),
+            mfptlib::test::equals({true, false, false, true})
+        );
+    }
 }
@@ -0,0 +1,110 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdexcept>
+
+#include <catch2/catch.hpp>
+
+#include <mfptlib/core/Types.hpp>
+#include <mfptlib/math/ExpMemoryBath.hpp>
+#include <mfptlib/math/NoiseSource.hpp>
+#include <mfptlib/math/PronyMemoryBath.hpp>
+
+#include "../Matcher.hpp"
+
+
+TEST_CASE("math/PronyMemoryBath", "[math]")
+{
+    const mfptlib::Scalars frictions{{0.5, 1.0, 0.25}};
+    const mfptlib::Scalars memories{{2.0, 0.5, 10.0}};
+
+    SECTION("PronyMemoryBath throws iff constructed with invalid arguments.")
+    {
+        REQUIRE_NOTHROW(mfptlib::PronyMemoryBath{1.0, frictions, memories, 42});
+        REQUIRE_THROWS_AS(
+            (mfptlib::PronyMemoryBath{-1.0, frictions, memories, 42}),
+            std::invalid_argument
+        );
+        REQUIRE_THROWS_AS(
+            (mfptlib::PronyMemoryBath{1.0, -frictions, memories, 42}),
+            std::invalid_argument
+        );
+        REQUIRE_THROWS_AS(
+            (mfptlib::PronyMemoryBath{1.0, frictions, -memories, 42}),
+            std::invalid_argument
+        );
+        REQUIRE_THROWS_AS(
+            (mfptlib::PronyMemoryBath{1.0, frictions, memories.head(2), 42}),
+            std::invalid_argument
+        );
+        REQUIRE_THROWS_AS(
+            (mfptlib::PronyMemoryBath{1.0, {}, {}, 42}),
+            std::invalid_argument
+        );
+    }
+
+    SECTION("A single term behaves like ExpMemoryBath.")
+    {
+        mfptlib::ExpMemoryBath expected_bath{2.0, 0.5, 3.0, 42};
+        mfptlib::PronyMemoryBath bath{
+            2.0, mfptlib::Scalars{{0.5}}, mfptlib::Scalars{{3.0}}, 42};
+
+        const mfptlib::Vectors masses = mfptlib::Vectors::Constant(150, 2, 1.5);
+        mfptlib::Vectors expected = mfptlib::Vectors::Zero(150, 2);
+        mfptlib::Vectors momenta = expected;
+        for(int step = 0; step < 10; ++step)
+        {
+            expected_bath.apply_forces(expected, masses, 0.1);
+            bath.apply_forces(momenta, masses, 0.1);
+        }
+
+        REQUIRE((momenta != 0.0).all());
+        REQUIRE_THAT(momenta, mfptlib::test::approx(expected, 1e-12));
+    }
+
+    SECTION("Auxiliary forces follow their states.")
+    {
+        const auto make_bath = [&]()
+        {
+            return mfptlib::PronyMemoryBath{1.0, frictions, memories,
+                mfptlib::NoiseSource{42, mfptlib::NoiseGenerator::Counter}};
+        };
+        const mfptlib::Vectors masses = mfptlib::Vectors::Ones(100, 3);
+        mfptlib::Booleans keep{100};
+        for(mfptlib::Index i = 0; i < keep.size(); ++i)
+            keep[i] = i % 3 != 0;
+
+        mfptlib::PronyMemoryBath whole = make_bath();
+        mfptlib::Vectors expected = mfptlib::Vectors::Zero(100, 3);
+        whole.apply_forces(expected, masses, 0.1);
+        whole.filter_states(keep);
+        mfptlib::Vectors expected_kept{keep.count(), 3};
+        for(mfptlib::Index i = 0, j = 0; i < keep.size(); ++i)
+            if(keep[i])
+                expected_kept.row(j++) = expected.row(i);
+        whole.apply_forces(expected_kept, masses.topRows(keep.count()), 0.1);
+
+        mfptlib::PronyMemoryBath head = make_bath();
+        mfptlib::Vectors momenta = mfptlib::Vectors::Zero(100, 3);
+        head.apply_forces(momenta, masses, 0.1);
+        head.filter_states(keep);
+        mfptlib::Vectors kept{keep.count(), 3};
+        for(mfptlib::Index i = 0, j = 0; i < keep.size(); ++i)
+            if(keep[i])
+                kept.row(j++) = momenta.row(i);
+        mfptlib::PronyMemoryBath tail = head.split_states(20);
+        head.apply_forces(kept.topRows(20), masses.topRows(20), 0.1);
+        tail.apply_forces(kept.bottomRows(kept.rows() - 20),
+            masses.topRows(kept.rows() - 20), 0.1);
+
+        REQUIRE_THAT(kept, mfptlib::test::equals(expected_kept));
+        REQUIRE_THROWS_AS(
+            head.apply_forces(kept, masses.topRows(kept.rows()), 0.1),
+            std::invalid_argument
+        );
+
+        head.reset();
+        REQUIRE_NOTHROW(
+            head.apply_forces(kept, masses.topRows(kept.rows()), 0.1));
+    }
+}
@@ -1,15 +1,31 @@
 // Copyright 2022 Johannes Reiff
 // SPDX-License-Identifier: Apache-2.0
 
+#include <atomic>
+#include <cmath>
+#include <filesystem>
+#include <functional>
+#include <system_error>
+#include <vector>
+
 #include <catch2/catch.hpp>
 
+#include <mfptlib/core/Ensemble.hpp>
 #include <mfptlib/core/Types.hpp>
+#include <mfptlib/math/BaoabStepper.hpp>
 #include <mfptlib/math/Bath.hpp>
+#include <mfptlib/math/ExpMemoryBath.hpp>
+#include <mfptlib/math/FastBaoabStepper.hpp>
+#include <mfptlib/math/LangevinBath.hpp>
+#include <mfptlib/math/NoiseSource.hpp>
 #include <mfptlib/math/Observer.hpp>
 #include <mfptlib/math/Predicate.hpp>
+#include <mfptlib/math/PronyMemoryBath.hpp>
 #include <mfptlib/math/Propagate.hpp>
 #include <mfptlib/math/Stepper.hpp>
+#include <mfptlib/math/TabulatedMemoryBath.hpp>
 #include <mfptlib/sys/EmptyPlane.hpp>
+#include <mfptlib/sys/HarmonicOscillator.hpp>
 #include <mfptlib/sys/System.hpp>
 
 #include "../EulerStepper.hpp"
@@ -19,61 +35,55 @@
 
 TEST_CASE("math/Propagate", "[math]")
 {
-    SECTION("partition_record() permutes according to the predicate array.")
+    SECTION("partition_record() stably partitions according to the predicate.")
     {
-        mfptlib::Indices order{{0, 4, 2, 3, 1, 5}};
-        mfptlib::Vectors states{
-            {0.1, 0.2},
-            {4.1, 4.2},
-            {2.1, 2.2},
-            {3.1, 3.2},
-            {1.1, 1.2},
-            {5.1, 5.2},
+        mfptlib::Vectors data{
+            {0.1, 0.2, 0.0},
+            {4.1, 4.2, 4.0},
+            {2.1, 2.2, 2.0},
+            {3.1, 3.2, 3.0},
+            {1.1, 1.2, 1.0},
+            {5.1, 5.2, 5.0},
         };
         const mfptlib::Booleans predicate{{false, true, false, true}};
-        const mfptlib::Indices expected_order{{3, 4, 2, 0, 1, 5}};
-        const mfptlib::Vectors expected_states{
-            {3.1, 3.2},
-            {4.1, 4.2},
-            {2.1, 2.2},
-            {0.1, 0.2},
-            {1.1, 1.2},
-            {5.1, 5.2},
+        const mfptlib::Vectors expected{
+            {4.1, 4.2, 4.0},
+            {3.1, 3.2, 3.0},
+            {0.1, 0.2, 0.0},
+            {2.1, 2.2, 2.0},
+            {1.1, 1.2, 1.0},
+            {5.1, 5.2, 5.0},
         };
 
         const mfptlib::Index partition_point = mfptlib::detail::partition_record(
-            order, states.topRows(4), predicate);
+            data.topRows(4), predicate);
 
         REQUIRE(partition_point == 2);
-        REQUIRE_THAT(order, mfptlib::test::equals(expected_order));
-        REQUIRE_THAT(states, mfptlib::test::equals(expected_states));
+        REQUIRE_THAT(data, mfptlib::test::equals(expected));
     }
 
-    SECTION("restore_order() permutes according to the order array.")
+    SECTION("restore_order() permutes according to the order column.")
     {
-        mfptlib::Indices order{{3, 4, 2, 0, 1, 5}};
-        mfptlib::Vectors states{
-            {3.1, 3.2},
-            {4.1, 4.2},
-            {2.1, 2.2},
-            {0.1, 0.2},
-            {1.1, 1.2},
-            {5.1, 5.2},
-        };
-        const mfptlib::Indices expected_order{{0, 1, 2, 3, 4, 5}};
-        const mfptlib::Vectors expected_states{
-            {0.1, 0.2},
-            {1.1, 1.2},
-            {2.1, 2.2},
-            {3.1, 3.2},
-            {4.1, 4.2},
-            {5.1, 5.2},
+        mfptlib::Vectors data{
+            {3.1, 3.0, 3.2},
+            {4.1, 4.0, 4.2},
+            {2.1, 2.0, 2.2},
+            {0.1, 0.0, 0.2},
+            {1.1, 1.0, 1.2},
+            {5.1, 5.0, 5.2},
+        };
+        const mfptlib::Vectors expected{
+            {0.1, 0.0, 0.2},
+            {1.1, 1.0, 1.2},
+            {2.1, 2.0, 2.2},
+            {3.1, 3.0, 3.2},
+            {4.1, 4.0, 4.2},
+            {5.1, 5.0, 5.2},
         };
 
-        mfptlib::detail::restore_order(order, states);
+        mfptlib::detail::restore_order(data, 1);
 
-        REQUIRE_THAT(order, mfptlib::test::equals(expected_order));
-        REQUIRE_THAT(states, mfptlib::test::equals(expected_states));
+        REQUIRE_THAT(data, mfptlib::test::equals(expected));
     }
 
     SECTION("propagate_to() propagates to the desired final time.")
@@ -173,4 +183,729 @@ TEST_CASE("math/Propagate", "[math]")
         REQUIRE(bath_stats->filter_states == 3);
         REQUIRE(bath_stats->reset == 0);
     }
+
+    SECTION("propagate_while() yields the same results on multiple threads.")
+    {
+        auto&& [stepper, stepper_stats] = mfptlib::test::euler_stepper();
+        auto [bath, bath_stats] = mfptlib::test::null_bath();
+        const mfptlib::System system{mfptlib::EmptyPlane{{{1.0, 2.0}}}};
+
+        mfptlib::Vectors states{
+            {0.0, 0.0, 3.0, 1.0},
+            {0.0, 0.0, 1.0, 1.0},
+            {1.0, 0.0, 1.5, 2.0},
+            {3.0, 0.0, 1.0, 1.0},
+            {0.0, 1.0, 0.5, 1.0},
+        };
+        const mfptlib::Vectors expected_states{
+            {3.0, 0.5, 3.0, 1.0},
+            {3.0, 1.5, 1.0, 1.0},
+            {4.0, 2.0, 1.5, 2.0},
+            {3.0, 0.0, 1.0, 1.0},
+            {3.0, 4.0, 0.5, 1.0},
+        };
+        const mfptlib::Scalars expected_t_end{{1.0, 3.0, 2.0, 0.0, 6.0}};
+
+        const mfptlib::Predicate predicate{
+            [&](const mfptlib::VectorsCRef& s, double) -> mfptlib::Booleans
+            { return s.col(0) < 2.9; },
+        };
+
+        std::atomic<int> num_observed{0};
+        const mfptlib::Observer observer{[&](const mfptlib::VectorsCRef&, double)
+            { ++num_observed; }};
+
+        const mfptlib::Scalars t_end = mfptlib::propagate_while(
+            stepper, bath, system, states, 0.0, predicate, observer,
+            mfptlib::PropagateOptions{.num_threads = 3});
+
+        REQUIRE(num_observed == 2 + 4 + 7);
+        REQUIRE_THAT(t_end, mfptlib::test::approx(expected_t_end));
+        REQUIRE_THAT(states, mfptlib::test::approx(expected_states));
+        REQUIRE(stepper_stats->step == 1 + 3 + 6);
+        REQUIRE(bath_stats->apply_forces == 1 + 3 + 6);
+    }
+
+    SECTION("propagate_while() throws if the number of threads is < 1.")
+    {
+        auto&& [stepper, stepper_stats] = mfptlib::test::euler_stepper();
+        auto [bath, bath_stats] = mfptlib::test::null_bath();
+        const mfptlib::System system{mfptlib::EmptyPlane{{{1.0, 2.0}}}};
+        mfptlib::Vectors states{{0.0, 0.0, 1.0, 1.0}};
+        const mfptlib::Predicate predicate{
+            [&](const mfptlib::VectorsCRef& s, double) -> mfptlib::Booleans
+            { return s.col(0) < 2.9; },
+        };
+
+        REQUIRE_THROWS_AS(
+            mfptlib::propagate_while(
+                stepper, bath, system, states, 0.0, predicate,
+                mfptlib::Observer{},
+                mfptlib::PropagateOptions{.num_threads = 0}),
+            std::invalid_argument
+        );
+    }
+
+    SECTION("propagate_while() with work stealing matches the serial results.")
+    {
+        auto&& [stepper, stepper_stats] = mfptlib::test::euler_stepper();
+        auto [bath, bath_stats] = mfptlib::test::null_bath();
+        const mfptlib::System system{mfptlib::EmptyPlane{{{1.0, 2.0}}}};
+
+        const mfptlib::Index size = 257;
+        mfptlib::Vectors states{size, 4};
+        for(mfptlib::Index i = 0; i < size; ++i)
+        {
+            const auto x = static_cast<double>(i);
+            states.row(i) << 0.0, x, 1.0 / (1.0 + x), 0.5;
+        }
+        mfptlib::Vectors expected_states = states;
+
+        const mfptlib::Predicate predicate{
+            [&](const mfptlib::VectorsCRef& s, double) -> mfptlib::Booleans
+            { return s.col(0) < 2.9; },
+        };
+
+        const mfptlib::Scalars expected_t_end = mfptlib::propagate_while(
+            stepper, bath, system, expected_states, 0.0, predicate,
+            mfptlib::Observer{});
+        const mfptlib::Scalars t_end = mfptlib::propagate_while(
+            stepper, bath, system, states, 0.0, predicate,
+            mfptlib::Observer{},
+            mfptlib::PropagateOptions{
+                .num_threads = 4,
+                .schedule = mfptlib::Schedule::WorkStealing,
+                .min_split_rows = 1,
+            });
+
+        REQUIRE_THAT(t_end, mfptlib::test::equals(expected_t_end));
+        REQUIRE_THAT(states, mfptlib::test::equals(expected_states));
+    }
+
+    SECTION("Work stealing splits caching steppers and baths before a step.")
+    {
+        const mfptlib::System system{mfptlib::HarmonicOscillator{
+            {{1.0, 2.0}}, {{1.0, 0.5}}}};
+
+        // Half of the states stop immediately, so that the other thread
+        // becomes idle before the caches have been filled.
+        const mfptlib::Index size = 400;
+        mfptlib::Vectors states{size, 4};
+        for(mfptlib::Index i = 0; i < size; ++i)
+        {
+            const auto x = static_cast<double>(i);
+            states.row(i) << (i < size / 2 ? 2.0 : 0.5 * std::sin(x)),
+                0.5 * std::cos(x), 0.0, 0.0;
+        }
+
+        const mfptlib::Predicate predicate{
+            [&](const mfptlib::VectorsCRef& s, double t) -> mfptlib::Booleans
+            {
+                return t < 2.0 ? mfptlib::Booleans{s.col(0).abs() < 1.5}
+                    : mfptlib::Booleans::Constant(s.rows(), false);
+            },
+        };
+
+        const auto propagate = [&](const mfptlib::PropagateOptions& options)
+        {
+            mfptlib::Stepper stepper{mfptlib::FastBaoabStepper{0.05}};
+            mfptlib::Bath bath{mfptlib::ExpMemoryBath{
+                1.0, 0.5, 2.0, 42, mfptlib::NoiseGenerator::Counter}};
+            mfptlib::Vectors propagated = states;
+            const mfptlib::Scalars t_end = mfptlib::propagate_while(
+                stepper, bath, system, propagated, 0.0, predicate,
+                mfptlib::Observer{}, options);
+            return std::pair{t_end, propagated};
+        };
+
+        const auto [expected_t_end, expected_states] =
+            propagate({.tile_rows = size});
+        for(int run = 0; run < 10; ++run)
+        {
+            const auto [t_end, propagated] = propagate({
+                .num_threads = 2,
+                .schedule = mfptlib::Schedule::WorkStealing,
+                .min_split_rows = 1,
+            });
+            REQUIRE_THAT(t_end, mfptlib::test::equals(expected_t_end));
+            REQUIRE_THAT(propagated, mfptlib::test::equals(expected_states));
+        }
+    }
+
+    SECTION("Tiles do not start a prefetching thread each.")
+    {
+        // Number of threads of this process, or 0 if it is unknown.
+        const auto count_threads = []
+        {
+            std::error_code error;
+            mfptlib::Index count = 0;
+            for(std::filesystem::directory_iterator task{
+                "/proc/self/task", error}, end; !error and task != end;
+                task.increment(error))
+                ++count;
+            return count;
+        };
+
+        const mfptlib::System system{mfptlib::EmptyPlane{{{1.0, 2.0}}}};
+        mfptlib::Stepper stepper{mfptlib::BaoabStepper{0.05}};
+        mfptlib::Bath bath{mfptlib::LangevinBath{1.0, 0.5,
+            mfptlib::NoiseSource{42, mfptlib::NoiseGenerator::Vectorized,
+                mfptlib::Prefetch::On}}};
+        mfptlib::Vectors states = mfptlib::Vectors::Zero(4000, 4);
+
+        // The bath itself keeps its producer, the forks do not get one.
+        const mfptlib::Index initial_threads = count_threads();
+        std::atomic<mfptlib::Index> max_threads{0};
+        const mfptlib::Observer observer{
+            [&](const mfptlib::VectorsCRef&, double)
+            {
+                const mfptlib::Index threads = count_threads();
+                mfptlib::Index current = max_threads;
+                while(current < threads
+                    and !max_threads.compare_exchange_weak(current, threads))
+                {}
+            },
+        };
+
+        mfptlib::propagate_to(stepper, bath, system, states, 0.0, 0.5,
+            observer, {.num_threads = 2, .tile_rows = 16, .tile_steps = 2});
+        REQUIRE(max_threads <= initial_threads + 2);
+    }
+
+    SECTION("propagate_while() with lazy compaction yields the same results.")
+    {
+        auto&& [stepper, stepper_stats] = mfptlib::test::euler_stepper();
+        auto [bath, bath_stats] = mfptlib::test::null_bath();
+        const mfptlib::System system{mfptlib::EmptyPlane{{{1.0, 2.0}}}};
+
+        mfptlib::Vectors states{
+            {0.0, 0.0, 3.0, 1.0},
+            {0.0, 0.0, 1.0, 1.0},
+            {1.0, 0.0, 1.5, 2.0},
+            {3.0, 0.0, 1.0, 1.0},
+        };
+        const mfptlib::Vectors expected_states{
+            {3.0, 0.5, 3.0, 1.0},
+            {3.0, 1.5, 1.0, 1.0},
+            {4.0, 2.0, 1.5, 2.0},
+            {3.0, 0.0, 1.0, 1.0},
+        };
+        const mfptlib::Scalars expected_t_end{{1.0, 3.0, 2.0, 0.0}};
+
+        // Stopped states keep being stepped until the block is compacted,
+        // but neither the predicate nor the observer may see them.
+        int num_evaluated{0};
+        const mfptlib::Predicate predicate{
+            [&](const mfptlib::VectorsCRef& s, double) -> mfptlib::Booleans
+            {
+                REQUIRE(s.rows() == 4 - num_evaluated);
+                ++num_evaluated;
+                return s.col(0) < 2.9;
+            },
+        };
+
+        int num_observed{0};
+        const mfptlib::Observer observer{
+            [&](const mfptlib::VectorsCRef& s, double)
+            {
+                REQUIRE(s.rows() == 4 - num_observed);
+                ++num_observed;
+            },
+        };
+
+        const mfptlib::Scalars t_end = mfptlib::propagate_while(
+            stepper, bath, system, states, 0.0, predicate, observer,
+            mfptlib::PropagateOptions{.compaction_threshold = 0.5});
+
+        REQUIRE(num_evaluated == 4);
+        REQUIRE(num_observed == 4);
+        REQUIRE_THAT(t_end, mfptlib::test::approx(expected_t_end));
+        REQUIRE_THAT(states, mfptlib::test::approx(expected_states));
+        REQUIRE(stepper_stats->step == 3);
+        REQUIRE(stepper_stats->filter_states == 1);
+        REQUIRE(bath_stats->filter_states == 1);
+    }
+
+    SECTION("propagate_while() throws if the compaction threshold is invalid.")
+    {
+        auto&& [stepper, stepper_stats] = mfptlib::test::euler_stepper();
+        auto [bath, bath_stats] = mfptlib::test::null_bath();
+        const mfptlib::System system{mfptlib::EmptyPlane{{{1.0, 2.0}}}};
+        mfptlib::Vectors states{{0.0, 0.0, 1.0, 1.0}};
+        const mfptlib::Predicate predicate{
+            [&](const mfptlib::VectorsCRef& s, double) -> mfptlib::Booleans
+            { return s.col(0) < 2.9; },
+        };
+
+        REQUIRE_THROWS_AS(
+            mfptlib::propagate_while(
+                stepper, bath, system, states, 0.0, predicate,
+                mfptlib::Observer{},
+                mfptlib::PropagateOptions{.compaction_threshold = 1.5}),
+            std::invalid_argument
+        );
+    }
+
+    SECTION("Tiled propagation matches the untiled results.")
+    {
+        auto&& [stepper, stepper_stats] = mfptlib::test::euler_stepper();
+        auto [bath, bath_stats] = mfptlib::test::null_bath();
+        const mfptlib::System system{mfptlib::EmptyPlane{{{1.0, 2.0}}}};
+
+        const mfptlib::Index size = 50;
+        mfptlib::Vectors states{size, 4};
+        for(mfptlib::Index i = 0; i < size; ++i)
+        {
+            const auto x = static_cast<double>(i);
+            states.row(i) << 0.0, x, 1.0 / (1.0 + x), 0.5;
+        }
+        mfptlib::Vectors expected_states = states;
+
+        const mfptlib::Predicate predicate{
+            [&](const mfptlib::VectorsCRef& s, double) -> mfptlib::Booleans
+            { return s.col(0) < 2.9; },
+        };
+
+        for(const mfptlib::Index threads : {1, 3})
+        {
+            mfptlib::Vectors tiled_states = states;
+            std::atomic<mfptlib::Index> num_observed{0};
+            std::atomic<bool> exceeds_tile{false};
+            const mfptlib::Observer observer{
+                [&](const mfptlib::VectorsCRef& s, double)
+                {
+                    num_observed += s.rows();
+                    if(s.rows() > 8)
+                        exceeds_tile = true;
+                },
+            };
+            const mfptlib::PropagateOptions options{
+                .num_threads = threads, .tile_rows = 8, .tile_steps = 3};
+
+            mfptlib::Vectors expected_to = states;
+            const double expected_t = mfptlib::propagate_to(
+                stepper, bath, system, expected_to, 0.0, 4.5,
+                mfptlib::Observer{});
+            const double t = mfptlib::propagate_to(
+                stepper, bath, system, tiled_states, 0.0, 4.5,
+                observer, options);
+
+            REQUIRE(t == expected_t);
+            REQUIRE(num_observed == 6 * size);
+            REQUIRE(!exceeds_tile);
+            REQUIRE_THAT(tiled_states, mfptlib::test::equals(expected_to));
+
+            tiled_states = states;
+            expected_states = states;
+            const mfptlib::Scalars expected_t_end = mfptlib::propagate_while(
+                stepper, bath, system, expected_states, 0.0, predicate,
+                mfptlib::Observer{});
+            const mfptlib::Scalars t_end = mfptlib::propagate_while(
+                stepper, bath, system, tiled_states, 0.0, predicate,
+                observer, options);
+
+            REQUIRE_THAT(t_end, mfptlib::test::equals(expected_t_end));
+            REQUIRE_THAT(tiled_states, mfptlib::test::equals(expected_states));
+        }
+    }
+
+    SECTION("Counter-based noise makes results independent of the options.")
+    {
+        const mfptlib::System system{mfptlib::HarmonicOscillator{
+            {{1.0, 2.0}}, {{1.0, 0.5}}}};
+
+        const mfptlib::Index size = 300;
+        mfptlib::Vectors states{size, 4};
+        for(mfptlib::Index i = 0; i < size; ++i)
+        {
+            const auto x = static_cast<double>(i);
+            states.row(i) << 0.5 * std::sin(x), 0.5 * std::cos(x), 0.0, 0.0;
+        }
+
+        const mfptlib::Predicate predicate{
+            [&](const mfptlib::VectorsCRef& s, double t) -> mfptlib::Booleans
+            {
+                return t < 5.0 ? mfptlib::Booleans{s.col(0).abs() < 1.0}
+                    : mfptlib::Booleans::Constant(s.rows(), false);
+            },
+        };
+
+        const auto propagate = [&](const mfptlib::PropagateOptions& options)
+        {
+            mfptlib::Stepper stepper{mfptlib::BaoabStepper{0.05}};
+            mfptlib::Bath bath{mfptlib::LangevinBath{
+                1.0, 0.5, 42, mfptlib::NoiseGenerator::Counter}};
+            mfptlib::Vectors propagated = states;
+            const mfptlib::Scalars t_end = mfptlib::propagate_while(
+                stepper, bath, system, propagated, 0.0, predicate,
+                mfptlib::Observer{}, options);
+            return std::pair{t_end, propagated};
+        };
+
+        // A single tile skips the statically dispatched kernel,
+        // whose fixed-size expressions may round differently.
+        const auto [expected_t_end, expected_states] =
+            propagate({.tile_rows = size});
+        REQUIRE((expected_t_end > 0.0 and expected_t_end < 5.0).any());
+
+        const auto [kernel_t_end, kernel_states] = propagate({});
+        REQUIRE_THAT(kernel_t_end, mfptlib::test::equals(expected_t_end));
+        REQUIRE_THAT(kernel_states,
+            mfptlib::test::approx(expected_states, 1e-12));
+
+        for(const mfptlib::PropagateOptions& options : {
+            mfptlib::PropagateOptions{.num_threads = 3},
+            mfptlib::PropagateOptions{
+                .num_threads = 4,
+                .schedule = mfptlib::Schedule::WorkStealing,
+                .min_split_rows = 1,
+            },
+            mfptlib::PropagateOptions{.compaction_threshold = 0.5},
+            mfptlib::PropagateOptions{
+                .num_threads = 2, .tile_rows = 16, .tile_steps = 5},
+        })
+        {
+            const auto [t_end, propagated] = propagate(options);
+            REQUIRE_THAT(t_end, mfptlib::test::equals(expected_t_end));
+            REQUIRE_THAT(propagated, mfptlib::test::equals(expected_states));
+        }
+    }
+
+    SECTION("Consecutive propagate_to() calls continue the noise.")
+    {
+        const mfptlib::System system{mfptlib::HarmonicOscillator{
+            {{1.0, 2.0}}, {{1.0, 0.5}}}};
+
+        const mfptlib::Index size = 40;
+        mfptlib::Vectors states{size, 4};
+        for(mfptlib::Index i = 0; i < size; ++i)
+        {
+            const auto x = static_cast<double>(i);
+            states.row(i) << 0.5 * std::sin(x), 0.5 * std::cos(x), 0.0, 0.0;
+        }
+
+        const auto propagate = [&](const mfptlib::PropagateOptions& options)
+        {
+            mfptlib::Stepper stepper{mfptlib::BaoabStepper{0.05}};
+            mfptlib::Bath bath{mfptlib::LangevinBath{
+                1.0, 0.5, 42, mfptlib::NoiseGenerator::Counter}};
+            mfptlib::Vectors propagated = states;
+            const double t = mfptlib::propagate_to(stepper, bath, system,
+                propagated, 0.0, 1.0, mfptlib::Observer{}, options);
+            mfptlib::propagate_to(stepper, bath, system,
+                propagated, t, 2.0, mfptlib::Observer{}, options);
+            return propagated;
+        };
+
+        const mfptlib::Vectors expected = propagate({});
+        for(const mfptlib::PropagateOptions& options : {
+            mfptlib::PropagateOptions{.num_threads = 2},
+            mfptlib::PropagateOptions{.num_threads = 3},
+            mfptlib::PropagateOptions{.tile_rows = 16},
+            mfptlib::PropagateOptions{.tile_rows = size},
+            mfptlib::PropagateOptions{
+                .num_threads = 2, .tile_rows = 16, .tile_steps = 5},
+            mfptlib::PropagateOptions{
+                .num_threads = 4,
+                .schedule = mfptlib::Schedule::WorkStealing,
+                .min_split_rows = 1,
+            },
+        })
+        {
+            // The statically dispatched serial kernel may round differently.
+            REQUIRE_THAT(propagate(options),
+                mfptlib::test::approx(expected, 1e-12));
+        }
+    }
+
+    SECTION("Threaded propagate_to() keeps the per-state data of forks.")
+    {
+        const mfptlib::System system{mfptlib::HarmonicOscillator{
+            {{1.0, 2.0}}, {{1.0, 0.5}}}};
+        const double dt = 0.05;
+        const auto counter = mfptlib::NoiseGenerator::Counter;
+
+        const mfptlib::Index size = 40;
+        mfptlib::Vectors states{size, 4};
+        for(mfptlib::Index i = 0; i < size; ++i)
+        {
+            const auto x = static_cast<double>(i);
+            states.row(i) << 0.5 * std::sin(x), 0.5 * std::cos(x), 0.0, 0.0;
+        }
+
+        const std::vector<std::function<mfptlib::Bath()>> baths{
+            [&]{ return mfptlib::Bath{
+                mfptlib::ExpMemoryBath{1.0, 0.5, 2.0, 42, counter}}; },
+            [&]{ return mfptlib::Bath{mfptlib::PronyMemoryBath{1.0,
+                mfptlib::Scalars{{0.5, 0.25}}, mfptlib::Scalars{{2.0, 0.5}},
+                42, counter}}; },
+            [&]{ return mfptlib::Bath{mfptlib::TabulatedMemoryBath{1.0,
+                (-mfptlib::Scalars::LinSpaced(30, 0.0, 29 * dt)).exp(), dt,
+                42, counter}}; },
+        };
+
+        for(const auto& make_bath : baths)
+            for(const mfptlib::PropagateOptions& options : {
+                mfptlib::PropagateOptions{.num_threads = 2},
+                mfptlib::PropagateOptions{.tile_rows = 16, .tile_steps = 5},
+            })
+            {
+                mfptlib::Stepper stepper{mfptlib::FastBaoabStepper{dt}};
+                mfptlib::Bath bath = make_bath();
+                mfptlib::Vectors expected = states;
+                mfptlib::propagate_to(stepper, bath, system, expected,
+                    0.0, 2.0, mfptlib::Observer{}, options);
+
+                stepper = mfptlib::Stepper{mfptlib::FastBaoabStepper{dt}};
+                bath = make_bath();
+                mfptlib::Vectors chunked = states;
+                double t = 0.0;
+                for(const double t_end : {0.5, 1.0, 2.0})
+                    t = mfptlib::propagate_to(stepper, bath, system, chunked,
+                        t, t_end, mfptlib::Observer{}, options);
+
+                REQUIRE_THAT(chunked, mfptlib::test::equals(expected));
+            }
+    }
+
+    SECTION("propagate_while() moves auxiliary columns with their states.")
+    {
+        const mfptlib::System system{mfptlib::HarmonicOscillator{
+            {{1.0, 2.0}}, {{1.0, 0.5}}}};
+
+        const mfptlib::Index size = 100;
+        mfptlib::Vectors states{size, 4};
+        for(mfptlib::Index i = 0; i < size; ++i)
+        {
+            const auto x = static_cast<double>(i);
+            states.row(i) << 0.5 * std::sin(x), 0.5 * std::cos(x), 0.0, 0.0;
+        }
+        const mfptlib::Scalars labels =
+            mfptlib::Scalars::LinSpaced(size, 0.0, size - 1.0);
+
+        const mfptlib::Predicate predicate{
+            [&](const mfptlib::VectorsCRef& s, double t) -> mfptlib::Booleans
+            {
+                REQUIRE(s.cols() == 4);
+                return t < 5.0 ? mfptlib::Booleans{s.col(0).abs() < 1.0}
+                    : mfptlib::Booleans::Constant(s.rows(), false);
+            },
+        };
+
+        mfptlib::Stepper expected_stepper{mfptlib::BaoabStepper{0.05}};
+        mfptlib::Bath expected_bath{mfptlib::LangevinBath{
+            1.0, 0.5, 42, mfptlib::NoiseGenerator::Counter}};
+        mfptlib::Vectors expected_states = states;
+        const mfptlib::Scalars expected_t_end = mfptlib::propagate_while(
+            expected_stepper, expected_bath, system, expected_states, 0.0,
+            predicate, mfptlib::Observer{}, {.tile_rows = size});
+        REQUIRE((expected_t_end > 0.0 and expected_t_end < 5.0).any());
+
+        for(const mfptlib::PropagateOptions& options : {
+            mfptlib::PropagateOptions{},
+            mfptlib::PropagateOptions{
+                .num_threads = 4,
+                .schedule = mfptlib::Schedule::WorkStealing,
+                .min_split_rows = 1,
+            },
+            mfptlib::PropagateOptions{.compaction_threshold = 0.5},
+            mfptlib::PropagateOptions{
+                .num_threads = 2, .tile_rows = 16, .tile_steps = 5},
+        })
+        {
+            mfptlib::Ensemble ensemble{states};
+            const mfptlib::Index label_col = ensemble.add_columns(1);
+            ensemble.columns(label_col, 1) = labels;
+
+            mfptlib::Stepper stepper{mfptlib::BaoabStepper{0.05}};
+            mfptlib::Bath bath{mfptlib::LangevinBath{
+                1.0, 0.5, 42, mfptlib::NoiseGenerator::Counter}};
+            const mfptlib::Scalars t_end = mfptlib::propagate_while(
+                stepper, bath, system, ensemble, 0.0, predicate,
+                mfptlib::Observer{}, options);
+
+            // The default options use a static kernel, which may round
+            // differently from the wrapped stepper.
+            REQUIRE_THAT(t_end, mfptlib::test::equals(expected_t_end));
+            REQUIRE_THAT(mfptlib::Vectors{ensemble.states()},
+                mfptlib::test::approx(expected_states, 1e-12));
+            REQUIRE_THAT(mfptlib::Vectors{ensemble.columns(label_col, 1)},
+                mfptlib::test::equals(mfptlib::Vectors{labels}));
+            REQUIRE(ensemble.data().cols() == label_col + 1);
+        }
+    }
+
+    SECTION("Caches bound to the ensemble follow their states.")
+    {
+        const mfptlib::Index size = 100;
+        const mfptlib::System system{mfptlib::HarmonicOscillator{
+            {{1.0, 2.0}}, {{1.0, 0.5}}}};
+        mfptlib::Vectors states{size, 4};
+        for(mfptlib::Index i = 0; i < size; ++i)
+        {
+            const auto x = static_cast<double>(i);
+            states.row(i) << 0.5 * std::sin(x), 0.5 * std::cos(x), 0.0, 0.0;
+        }
+
+        const mfptlib::Predicate predicate{
+            [&](const mfptlib::VectorsCRef& s, double t) -> mfptlib::Booleans
+            {
+                return t < 5.0 ? mfptlib::Booleans{s.col(0).abs() < 1.0}
+                    : mfptlib::Booleans::Constant(s.rows(), false);
+            },
+        };
+
+        const auto make_bath = [&]
+        {
+            return mfptlib::Bath{mfptlib::ExpMemoryBath{
+                1.0, 0.5, 2.0, 42, mfptlib::NoiseGenerator::Counter}};
+        };
+
+        mfptlib::Stepper expected_stepper{mfptlib::FastBaoabStepper{0.05}};
+        mfptlib::Bath expected_bath = make_bath();
+        mfptlib::Vectors expected_states = states;
+        const mfptlib::Scalars expected_t_end = mfptlib::propagate_while(
+            expected_stepper, expected_bath, system, expected_states, 0.0,
+            predicate, mfptlib::Observer{}, {.compaction_threshold = 0.0});
+        REQUIRE((expected_t_end > 0.0 and expected_t_end < 5.0).any());
+
+        for(const mfptlib::PropagateOptions& options : {
+            mfptlib::PropagateOptions{},
+            mfptlib::PropagateOptions{.compaction_threshold = 0.5},
+            mfptlib::PropagateOptions{
+                .num_threads = 2, .tile_rows = 16, .tile_steps = 5},
+        })
+        {
+            mfptlib::Ensemble ensemble{states};
+            mfptlib::Stepper stepper{mfptlib::FastBaoabStepper{0.05}};
+            mfptlib::Bath bath = make_bath();
+            const mfptlib::Scalars t_end = mfptlib::propagate_while(
+                stepper, bath, system, ensemble, 0.0, predicate,
+                mfptlib::Observer{}, options);
+
+            REQUIRE_THAT(t_end, mfptlib::test::equals(expected_t_end));
+            REQUIRE_THAT(mfptlib::Vectors{ensemble.states()},
+                mfptlib::test::approx(expected_states, 1e-12));
+            REQUIRE(ensemble.data().cols() == 4);
+        }
+    }
+
+    SECTION("Parameters per state follow their states during propagation.")
+    {
+        // Two parameter sets, alternating between the states.
+        const mfptlib::Index size = 200;
+        mfptlib::Vectors strengths{size, 2};
+        mfptlib::Scalars kb_t{size};
+        mfptlib::Scalars friction{size};
+        mfptlib::Vectors states{size, 4};
+        for(mfptlib::Index i = 0; i < size; ++i)
+        {
+            const bool even = i % 2 == 0;
+            strengths.row(i) << (even ? 1.0 : 3.0), 0.5;
+            kb_t[i] = even ? 1.0 : 0.5;
+            friction[i] = even ? 0.5 : 2.0;
+            const auto x = static_cast<double>(i);
+            states.row(i) << 0.5 * std::sin(x), 0.5 * std::cos(x), 0.0, 0.0;
+        }
+
+        const mfptlib::Predicate predicate{
+            [&](const mfptlib::VectorsCRef& s, double t) -> mfptlib::Booleans
+            {
+                return t < 5.0 ? mfptlib::Booleans{s.col(0).abs() < 1.0}
+                    : mfptlib::Booleans::Constant(s.rows(), false);
+            },
+        };
+
+        const auto propagate = [&](
+            const mfptlib::System& system, mfptlib::Bath bath,
+            const mfptlib::PropagateOptions& options)
+        {
+            mfptlib::Stepper stepper{mfptlib::BaoabStepper{0.05}};
+            mfptlib::Vectors propagated = states;
+            const mfptlib::Scalars t_end = mfptlib::propagate_while(
+                stepper, bath, system, propagated, 0.0, predicate,
+                mfptlib::Observer{}, options);
+            return std::pair{t_end, propagated};
+        };
+
+        const mfptlib::System system{
+            mfptlib::HarmonicOscillator::per_state({{1.0, 2.0}}, strengths)};
+        const auto make_bath = [&]
+        {
+            return mfptlib::Bath{mfptlib::LangevinBath{kb_t, friction,
+                mfptlib::NoiseSource{42, mfptlib::NoiseGenerator::Counter}}};
+        };
+
+        const auto [expected_t_end, expected_states] =
+            propagate(system, make_bath(), {.tile_rows = size});
+        REQUIRE((expected_t_end > 0.0 and expected_t_end < 5.0).any());
+
+        // Counter-based noise gives the even states the same noise
+        // as an ensemble with shared parameters.
+        const auto [even_t_end, even_states] = propagate(
+            mfptlib::System{mfptlib::HarmonicOscillator{
+                {{1.0, 2.0}}, {{1.0, 0.5}}}},
+            mfptlib::Bath{mfptlib::LangevinBath{
+                1.0, 0.5, 42, mfptlib::NoiseGenerator::Counter}},
+            {.tile_rows = size});
+        for(mfptlib::Index i = 0; i < size; i += 2)
+        {
+            REQUIRE(even_t_end[i] == expected_t_end[i]);
+            REQUIRE_THAT(mfptlib::Vectors{even_states.middleRows(i, 1)},
+                mfptlib::test::approx(
+                    mfptlib::Vectors{expected_states.middleRows(i, 1)},
+                    1e-12));
+        }
+
+        for(const mfptlib::PropagateOptions& options : {
+            mfptlib::PropagateOptions{},
+            mfptlib::PropagateOptions{.num_threads = 3},
+            mfptlib::PropagateOptions{
+                .num_threads = 4,
+                .schedule = mfptlib::Schedule::WorkStealing,
+                .min_split_rows = 1,
+            },
+            mfptlib::PropagateOptions{.compaction_threshold = 0.5},
+            mfptlib::PropagateOptions{
+                .num_threads = 2, .tile_rows = 16, .tile_steps = 5},
+        })
+        {
+            const auto [t_end, propagated] =
+                propagate(system, make_bath(), options);
+            REQUIRE_THAT(t_end, mfptlib::test::equals(expected_t_end));
+            REQUIRE_THAT(propagated,
+                mfptlib::test::approx(expected_states, 1e-12));
+        }
+
+        mfptlib::Vectors too_many{size + 1, 4};
+        too_many.setZero();
+        mfptlib::Stepper stepper{mfptlib::BaoabStepper{0.05}};
+        mfptlib::Bath bath{mfptlib::LangevinBath{1.0, 0.5, 42}};
+        REQUIRE_THROWS_AS(
+            mfptlib::propagate_while(stepper, bath, system, too_many, 0.0,
+                predicate, mfptlib::Observer{}),
+            std::invalid_argument
+        );
+    }
+
+    SECTION("Tiled propagation throws if the tile parameters are invalid.")
+    {
+        auto&& [stepper, stepper_stats] = mfptlib::test::euler_stepper();
+        auto [bath, bath_stats] = mfptlib::test::null_bath();
+        const mfptlib::System system{mfptlib::EmptyPlane{{{1.0, 2.0}}}};
+        mfptlib::Vectors states{{0.0, 0.0, 1.0, 1.0}};
+
+        REQUIRE_THROWS_AS(
+            mfptlib::propagate_to(
+                stepper, bath, system, states, 0.0, 1.0, mfptlib::Observer{},
+                mfptlib::PropagateOptions{.tile_rows = -1}),
+            std::invalid_argument
+        );
+        REQUIRE_THROWS_AS(
+            mfptlib::propagate_to(
+                stepper, bath, system, states, 0.0, 1.0, mfptlib::Observer{},
+                mfptlib::PropagateOptions{.tile_rows = 1, .tile_steps = 0}),
+            std::invalid_argument
+        );
+    }
 }
@@ -0,0 +1,208 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cmath>
+#include <stdexcept>
+
+#include <catch2/catch.hpp>
+
+#include <mfptlib/core/Types.hpp>
+#include <mfptlib/math/Observer.hpp>
+#include <mfptlib/math/Propagate.hpp>
+#include <mfptlib/math/Statistics.hpp>
+#include <mfptlib/sys/HarmonicOscillator.hpp>
+#include <mfptlib/sys/EmptyPlane.hpp>
+#include <mfptlib/sys/System.hpp>
+
+#include "../EulerStepper.hpp"
+#include "../Matcher.hpp"
+#include "../NullBath.hpp"
+
+
+TEST_CASE("math/Statistics", "[math]")
+{
+    const mfptlib::Vectors states{
+        {0.0,  1.0,  1.0,  0.0},
+        {1.0,  2.0,  0.0,  2.0},
+        {2.0, -1.0, -1.0,  0.0},
+    };
+    const mfptlib::System system{mfptlib::HarmonicOscillator{
+        {{1.0, 2.0}}, {{2.0, 2.0}}}};
+
+    SECTION("MomentsObserver accumulates mean and variance of all columns.")
+    {
+        mfptlib::MomentsObserver moments{};
+        const mfptlib::Observer observe = moments;
+        observe(states.topRows(1), 0.0);
+        observe(states.bottomRows(2), 1.0);
+
+        REQUIRE(moments.count() == 3);
+        REQUIRE_THAT(
+            moments.mean(),
+            mfptlib::test::approx({{1.0, 2.0 / 3.0, 0.0, 2.0 / 3.0}})
+        );
+        REQUIRE_THAT(
+            moments.variance(),
+            mfptlib::test::approx({{1.0, 7.0 / 3.0, 1.0, 4.0 / 3.0}})
+        );
+
+        moments.reset();
+        REQUIRE(moments.count() == 0);
+        REQUIRE(moments.mean().size() == 0);
+    }
+
+    SECTION("MomentsObserver accumulates energies.")
+    {
+        // V = {1, 5, 5}, T = {0.5, 1, 0.5}, E = {1.5, 6, 5.5}
+        const mfptlib::MomentsObserver moments{
+            mfptlib::Quantity::total_energy(system)};
+        const mfptlib::Observer observe = moments;
+        observe(states, 0.0);
+
+        REQUIRE(moments.count() == 3);
+        REQUIRE_THAT(moments.mean(), mfptlib::test::approx({{13.0 / 3.0}}));
+        REQUIRE_THAT(
+            moments.variance(),
+            mfptlib::test::approx({{73.0 / 12.0}})
+        );
+    }
+
+    SECTION("Energies reuse their buffers for changing numbers of states.")
+    {
+        // V = {1, 5, 5}, T = {0.5, 1, 0.5}
+        const mfptlib::MomentsObserver kinetic{
+            mfptlib::Quantity::kinetic_energy(system)};
+        const mfptlib::MomentsObserver potential{
+            mfptlib::Quantity::potential(system)};
+        for(const mfptlib::Observer& observe : {
+            mfptlib::Observer{kinetic}, mfptlib::Observer{potential}})
+        {
+            observe(states, 0.0);
+            observe(states.topRows(1), 1.0);
+            observe(states.bottomRows(2), 2.0);
+        }
+
+        REQUIRE(kinetic.count() == 6);
+        REQUIRE_THAT(kinetic.mean(), mfptlib::test::approx({{2.0 / 3.0}}));
+        REQUIRE(potential.count() == 6);
+        REQUIRE_THAT(potential.mean(), mfptlib::test::approx({{11.0 / 3.0}}));
+    }
+
+    SECTION("Energies reject systems with parameters per state.")
+    {
+        const mfptlib::System per_state{mfptlib::HarmonicOscillator::per_state(
+            {{1.0, 2.0}}, mfptlib::Vectors::Constant(3, 2, 2.0))};
+        REQUIRE_THROWS_AS(
+            mfptlib::Quantity::kinetic_energy(per_state),
+            std::invalid_argument
+        );
+        REQUIRE_THROWS_AS(
+            mfptlib::Quantity::potential(per_state),
+            std::invalid_argument
+        );
+        REQUIRE_THROWS_AS(
+            mfptlib::Quantity::total_energy(per_state),
+            std::invalid_argument
+        );
+    }
+
+    SECTION("HistogramObserver counts values in equally sized bins.")
+    {
+        const mfptlib::HistogramObserver histogram{
+            mfptlib::Quantity::coordinate(1), -1.0, 2.0, 3};
+        const mfptlib::Observer observe = histogram;
+        observe(states, 0.0);
+        observe(states.topRows(2), 1.0);
+
+        REQUIRE_THAT(
+            histogram.edges(),
+            mfptlib::test::approx({-1.0, 0.0, 1.0, 2.0})
+        );
+        REQUIRE_THAT(
+            histogram.counts(),
+            mfptlib::test::equals(mfptlib::Indices{{1, 0, 2}})
+        );
+        REQUIRE(histogram.underflow() == 0);
+        REQUIRE(histogram.overflow() == 2);
+    }
+
+    SECTION("HistogramObserver throws for invalid arguments.")
+    {
+        REQUIRE_THROWS_AS(
+            mfptlib::HistogramObserver(
+                mfptlib::Quantity::coordinates(), 0.0, 1.0, 1),
+            std::invalid_argument
+        );
+        REQUIRE_THROWS_AS(
+            mfptlib::HistogramObserver(
+                mfptlib::Quantity::coordinate(0), 1.0, 1.0, 1),
+            std::invalid_argument
+        );
+        REQUIRE_THROWS_AS(
+            mfptlib::HistogramObserver(
+                mfptlib::Quantity::coordinate(0), 0.0, 1.0, 0),
+            std::invalid_argument
+        );
+    }
+
+    SECTION("SurvivalObserver adds up the number of states per time.")
+    {
+        const mfptlib::SurvivalObserver survival{};
+        const mfptlib::Observer observe = survival;
+        observe(states, 0.0);
+        observe(states.topRows(2), 2.0);
+        observe(states.topRows(1), 1.0);
+        observe(states.topRows(1), 2.0);
+
+        REQUIRE_THAT(survival.times(), mfptlib::test::approx({0.0, 1.0, 2.0}));
+        REQUIRE_THAT(
+            survival.counts(),
+            mfptlib::test::equals(mfptlib::Indices{{3, 1, 3}})
+        );
+    }
+
+    SECTION("combine_observers() calls all observers.")
+    {
+        const mfptlib::SurvivalObserver survival{};
+        const mfptlib::MomentsObserver moments{};
+        const mfptlib::Observer observe = mfptlib::combine_observers(
+            {survival, mfptlib::Observer{}, moments});
+        observe(states, 0.0);
+
+        REQUIRE(survival.counts().size() == 1);
+        REQUIRE(moments.count() == 3);
+    }
+
+    SECTION("SurvivalObserver counts the active states of propagate_while().")
+    {
+        for(const double threshold : {1.0, 0.0})
+        {
+            auto&& [stepper, stepper_stats] = mfptlib::test::euler_stepper();
+            auto [bath, bath_stats] = mfptlib::test::null_bath();
+            const mfptlib::System plane{mfptlib::EmptyPlane{{{1.0, 1.0}}}};
+            mfptlib::Vectors initial{
+                {0.0, 0.0, 1.0, 0.0},
+                {0.0, 0.0, 3.0, 0.0},
+                {0.0, 0.0, 2.0, 0.0},
+                {0.0, 0.0, 4.0, 0.0},
+            };
+            const mfptlib::Predicate predicate{
+                [](const mfptlib::VectorsCRef& s, double) -> mfptlib::Booleans
+                { return s.col(0) < 3.5; }};
+            const mfptlib::SurvivalObserver survival{};
+
+            mfptlib::propagate_while(
+                stepper, bath, plane, initial, 0.0, predicate, survival,
+                mfptlib::PropagateOptions{.compaction_threshold = threshold});
+
+            REQUIRE_THAT(
+                survival.times(),
+                mfptlib::test::approx({0.0, 1.0, 2.0, 3.0, 4.0})
+            );
+            REQUIRE_THAT(
+                survival.counts(),
+                mfptlib::test::equals(mfptlib::Indices{{4, 4, 3, 1, 1}})
+            );
+        }
+    }
+}
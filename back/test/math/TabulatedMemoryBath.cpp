@@ -0,0 +1,153 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <mfptlib/core/Types.hpp>
+#include <mfptlib/math/TabulatedMemoryBath.hpp>
+
+#include "../Matcher.hpp"
+
+
+TEST_CASE("math/TabulatedMemoryBath", "[math]")
+{
+    const double dt = 0.05;
+    const mfptlib::Scalars kernel =
+        (-mfptlib::Scalars::LinSpaced(40, 0.0, 39 * dt) / 0.5).exp();
+
+    SECTION("TabulatedMemoryBath throws iff called with invalid arguments.")
+    {
+        REQUIRE_NOTHROW(mfptlib::TabulatedMemoryBath{1.0, kernel, dt, 42});
+        REQUIRE_THROWS_AS(
+            (mfptlib::TabulatedMemoryBath{-1.0, kernel, dt, 42}),
+            std::invalid_argument
+        );
+        REQUIRE_THROWS_AS(
+            (mfptlib::TabulatedMemoryBath{1.0, kernel, 0.0, 42}),
+            std::invalid_argument
+        );
+        REQUIRE_THROWS_AS(
+            (mfptlib::TabulatedMemoryBath{1.0, {}, dt, 42}),
+            std::invalid_argument
+        );
+    }
+
+    SECTION("The memory force matches the direct convolution.")
+    {
+        mfptlib::TabulatedMemoryBath bath{0.0, kernel, dt, 42};
+        REQUIRE(bath.block_size() > 1);
+
+        const mfptlib::Index rows = 5;
+        const mfptlib::Vectors masses = mfptlib::Vectors::Ones(rows, 2);
+        mfptlib::Vectors momenta{rows, 2};
+        momenta.col(0) = mfptlib::Scalars::LinSpaced(rows, 1.0, 2.0);
+        momenta.col(1) = mfptlib::Scalars::LinSpaced(rows, -1.0, 0.5);
+
+        // Reference with the full history and the same quadrature.
+        std::vector<mfptlib::Vectors> history;
+        mfptlib::Vectors expected = momenta;
+
+        for(int step = 0; step < 150; ++step)
+        {
+            history.push_back(expected);
+            mfptlib::Vectors friction = mfptlib::Vectors::Zero(rows, 2);
+            for(mfptlib::Index lag = 0; lag < kernel.size()
+                and lag < static_cast<mfptlib::Index>(history.size()); ++lag)
+            {
+                const double weight = (lag == 0 ? 0.5 : 1.0) * dt * kernel[lag];
+                friction += weight * history[history.size() - 1 - lag];
+            }
+            expected -= dt * friction;
+
+            bath.apply_forces(momenta, masses, dt);
+        }
+
+        REQUIRE(std::abs(expected(0, 0) - 1.0) > 0.1);
+        REQUIRE_THAT(momenta, mfptlib::test::approx(expected, 1e-12));
+    }
+
+    SECTION("Per-state history follows filter_states() and split_states().")
+    {
+        const auto run = [&](bool split)
+        {
+            mfptlib::TabulatedMemoryBath bath{1.0, kernel, dt,
+                mfptlib::NoiseSource{42, mfptlib::NoiseGenerator::Counter}};
+            const mfptlib::Vectors masses = mfptlib::Vectors::Ones(8, 1);
+            mfptlib::Vectors momenta = mfptlib::Vectors::Zero(8, 1);
+            for(int step = 0; step < 30; ++step)
+                bath.apply_forces(momenta, masses, dt);
+
+            mfptlib::Booleans keep{8};
+            keep << true, false, true, true, false, true, true, true;
+            bath.filter_states(keep);
+            mfptlib::Vectors kept{6, 1};
+            for(mfptlib::Index i = 0, j = 0; i < keep.size(); ++i)
+                if(keep[i])
+                    kept(j++, 0) = momenta(i, 0);
+
+            if(split)
+            {
+                mfptlib::TabulatedMemoryBath tail = bath.split_states(2);
+                for(int step = 0; step < 30; ++step)
+                {
+                    bath.apply_forces(kept.topRows(2), masses.topRows(2), dt);
+                    tail.apply_forces(
+                        kept.bottomRows(4), masses.topRows(4), dt);
+                }
+            }
+            else
+            {
+                for(int step = 0; step < 30; ++step)
+                    bath.apply_forces(kept, masses.topRows(6), dt);
+                REQUIRE_THROWS_AS(
+                    bath.apply_forces(momenta, masses, dt),
+                    std::invalid_argument
+                );
+            }
+            return kept;
+        };
+
+        REQUIRE_THAT(run(true), mfptlib::test::equals(run(false)));
+    }
+
+    SECTION("The colored noise is stationary from the first step on.")
+    {
+        // Zero momenta only pick up dt times the colored noise,
+        // whose variance is kb_t K(0).
+        const double kb_t = 2.0;
+        mfptlib::TabulatedMemoryBath bath{kb_t, kernel, dt, 42};
+        const mfptlib::Vectors masses = mfptlib::Vectors::Ones(4000, 1);
+
+        for(const int steps : {120, 10})
+        {
+            for(int step = 0; step < steps; ++step)
+            {
+                mfptlib::Vectors momenta = mfptlib::Vectors::Zero(4000, 1);
+                bath.apply_forces(momenta, masses, dt);
+                const double variance = (momenta / dt).square().mean();
+                INFO("step " << step);
+                REQUIRE(std::abs(variance / (kb_t * kernel[0]) - 1.0) < 0.1);
+            }
+            bath.reset();
+        }
+    }
+
+    SECTION("Colored noise and friction thermalize the momenta.")
+    {
+        const double kb_t = 2.0;
+        mfptlib::TabulatedMemoryBath bath{kb_t, 2.0 * kernel, dt, 42};
+        const mfptlib::Vectors masses =
+            mfptlib::Vectors::Constant(4000, 1, 1.5);
+        mfptlib::Vectors momenta = mfptlib::Vectors::Zero(4000, 1);
+        for(int step = 0; step < 400; ++step)
+            bath.apply_forces(momenta, masses, dt);
+
+        const double variance = momenta.square().mean();
+        REQUIRE(std::abs(momenta.mean()) < 0.1);
+        REQUIRE(std::abs(variance / (1.5 * kb_t) - 1.0) < 0.1);
+    }
+}
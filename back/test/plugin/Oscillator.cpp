@@ -0,0 +1,89 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+// Plugin for the tests of PluginSystem implementing harmonic oscillators
+// with masses 1 and 2. The options contain the strengths, e.g., "1.0 1.5".
+
+#include <cstdint>
+#include <sstream>
+
+#include <mfptlib/sys/Plugin.h>
+
+
+namespace {
+
+struct Oscillator
+{
+    double strengths[2];
+};
+
+constexpr double Masses[2] = {1.0, 2.0};
+
+
+void potential(
+    const void* context,
+    std::int64_t rows,
+    const double* states,
+    std::int64_t states_stride,
+    double,
+    double* out
+)
+{
+    const auto* osc = static_cast<const Oscillator*>(context);
+    for(std::int64_t row = 0; row < rows; ++row)
+    {
+        const double q0 = states[row];
+        const double q1 = states[states_stride + row];
+        out[row] = 0.5 * (osc->strengths[0] * q0 * q0
+            + osc->strengths[1] * q1 * q1);
+    }
+}
+
+
+void force(
+    const void* context,
+    std::int64_t rows,
+    const double* states,
+    std::int64_t states_stride,
+    double,
+    double* out,
+    std::int64_t out_stride
+)
+{
+    const auto* osc = static_cast<const Oscillator*>(context);
+    for(std::int64_t dof = 0; dof < 2; ++dof)
+        for(std::int64_t row = 0; row < rows; ++row)
+            out[dof * out_stride + row] =
+                -osc->strengths[dof] * states[dof * states_stride + row];
+}
+
+
+void release(void* context)
+{
+    delete static_cast<Oscillator*>(context);
+}
+
+} // namespace
+
+
+extern "C" __attribute__((visibility("default")))
+int mfptlib_plugin_init(mfptlib_plugin* plugin, const char* options)
+{
+    Oscillator osc{};
+    std::istringstream in{options};
+    if(!(in >> osc.strengths[0] >> osc.strengths[1]))
+        return 1;
+
+    *plugin = mfptlib_plugin{
+        .abi_version = MFPTLIB_PLUGIN_ABI_VERSION,
+        .context = new Oscillator{osc},
+        .degrees_of_freedom = 2,
+        .potential = potential,
+        .force = force,
+        .energy_and_force = nullptr,
+        .masses = nullptr,
+        .constant_masses = Masses,
+        .release = release,
+    };
+    return 0;
+}
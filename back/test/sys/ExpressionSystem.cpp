@@ -0,0 +1,187 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+
+#include <catch2/catch.hpp>
+
+#include <mfptlib/core/Types.hpp>
+#include <mfptlib/sys/ExpressionSystem.hpp>
+#include <mfptlib/sys/HarmonicOscillator.hpp>
+#include <mfptlib/sys/System.hpp>
+
+#include "../Matcher.hpp"
+
+
+namespace {
+
+auto gradient_force(
+    const mfptlib::System& system,
+    const mfptlib::Vectors& states,
+    double t,
+    double eps = 1e-6
+) -> mfptlib::Vectors
+{
+    const mfptlib::Index dofs = degrees_of_freedom(system);
+    mfptlib::Vectors res{states.rows(), dofs};
+    for(mfptlib::Index dof = 0; dof < dofs; ++dof)
+    {
+        mfptlib::Vectors lower = states;
+        mfptlib::Vectors upper = states;
+        lower.col(dof) -= eps;
+        upper.col(dof) += eps;
+        res.col(dof) = (potential(system, lower, t)
+            - potential(system, upper, t)) / (2.0 * eps);
+    }
+    return res;
+}
+
+} // namespace
+
+
+TEST_CASE("sys/ExpressionSystem", "[sys]")
+{
+    constexpr double t{0.5};
+
+    SECTION("A quadratic expression matches HarmonicOscillator.")
+    {
+        const mfptlib::Vector dof_masses{{1.0, 2.0}};
+        const mfptlib::System expression{mfptlib::ExpressionSystem{
+            "0.5 * k0 * q0^2 + 0.5 * k1 * q1**2",
+            dof_masses,
+            {{"k0", 1.0}, {"k1", 1.5}},
+        }};
+        const mfptlib::System oscillator{mfptlib::HarmonicOscillator{
+            dof_masses, mfptlib::Vector{{1.0, 1.5}}}};
+
+        // Spans multiple chunks.
+        const mfptlib::Vectors states = mfptlib::Vectors::Random(600, 4);
+        const auto [energy, forces] = energy_and_force(expression, states, t);
+        REQUIRE_THAT(
+            energy,
+            mfptlib::test::approx(potential(oscillator, states, t), 1e-15)
+        );
+        REQUIRE_THAT(
+            forces,
+            mfptlib::test::approx(force(oscillator, states, t), 1e-15)
+        );
+        REQUIRE_THAT(
+            potential(expression, states, t),
+            mfptlib::test::equals(energy)
+        );
+        REQUIRE_THAT(
+            force(expression, states, t),
+            mfptlib::test::equals(forces)
+        );
+        REQUIRE_THAT(
+            masses(expression, states),
+            mfptlib::test::equals(dof_masses.replicate(states.rows(), 1))
+        );
+    }
+
+    SECTION("Forces are the gradient of all supported operations.")
+    {
+        const mfptlib::System system{mfptlib::ExpressionSystem{
+            "a * cos(q1) + sin(q0) * exp(-q1^2 / 2) + sqrt(1 + q0^2)"
+            " + log(2 + tanh(q0 * q1)) - atan(q0) + abs(q1) / (1 + q0^2)"
+            " + pow(1.5 + q0^2, q1) + 2^q0 + q0^3 - tan(0.2 * q1)"
+            " + cosh(0.3 * q0) * sinh(q1 / 4) - pi * e * t * q1",
+            mfptlib::Vector{{1.0, 1.0}},
+            {{"a", 0.7}},
+        }};
+        const mfptlib::Vectors states{
+            {0.1, 0.4, 0.0, 0.0},
+            {-1.2, 0.7, 1.0, 2.0},
+            {0.8, -0.9, 0.0, 0.0},
+            {2.0, 1.5, 0.0, 0.0},
+        };
+
+        mfptlib::Scalars expected{states.rows()};
+        for(mfptlib::Index row = 0; row < states.rows(); ++row)
+        {
+            const double x = states(row, 0);
+            const double y = states(row, 1);
+            expected[row] = 0.7 * std::cos(y)
+                + std::sin(x) * std::exp(-y * y / 2) + std::sqrt(1 + x * x)
+                + std::log(2 + std::tanh(x * y)) - std::atan(x)
+                + std::abs(y) / (1 + x * x) + std::pow(1.5 + x * x, y)
+                + std::pow(2.0, x) + x * x * x - std::tan(0.2 * y)
+                + std::cosh(0.3 * x) * std::sinh(y / 4)
+                - std::numbers::pi * std::numbers::e * t * y;
+        }
+
+        const auto [energy, forces] = energy_and_force(system, states, t);
+        REQUIRE_THAT(energy, mfptlib::test::approx(expected, 1e-14));
+        REQUIRE_THAT(
+            forces,
+            mfptlib::test::approx(gradient_force(system, states, t), 1e-8)
+        );
+    }
+
+    SECTION("Operators follow the usual precedence.")
+    {
+        const auto evaluate = [&](const char* expression)
+        {
+            const mfptlib::System system{mfptlib::ExpressionSystem{
+                expression, mfptlib::Vector{{1.0}}}};
+            return potential(system, mfptlib::Vectors{{3.0, 0.0}}, t)[0];
+        };
+
+        REQUIRE(evaluate("2^3^2") == 512.0);
+        REQUIRE(evaluate("-2^2") == -4.0);
+        REQUIRE(evaluate("2 ** -1") == 0.5);
+        REQUIRE(evaluate("1 + 2 * 3 - 8 / 4 / 2") == 6.0);
+        REQUIRE(evaluate("(1 + 2) * -q0") == -9.0);
+        REQUIRE(evaluate("q0 - q0 * 2 + 1.5e1") == 12.0);
+        REQUIRE(evaluate("4 * t") == 2.0);
+    }
+
+    SECTION("Constant and time-dependent expressions exert no force.")
+    {
+        const mfptlib::System system{mfptlib::ExpressionSystem{
+            "sin(t) + 2", mfptlib::Vector{{1.0, 1.0}}}};
+        const mfptlib::Vectors states = mfptlib::Vectors::Random(3, 4);
+
+        const auto [energy, forces] = energy_and_force(system, states, t);
+        REQUIRE_THAT(
+            energy,
+            mfptlib::test::equals(mfptlib::Scalars::Constant(
+                3, std::sin(t) + 2.0))
+        );
+        REQUIRE_THAT(forces, mfptlib::test::equals(
+            mfptlib::Vectors::Zero(3, 2)));
+    }
+
+    SECTION("Only expressions using t are time-dependent.")
+    {
+        const mfptlib::Vector masses{{1.0}};
+        REQUIRE(traits(mfptlib::System{mfptlib::ExpressionSystem{
+            "q0^2", masses}}).time_independent_potential);
+        REQUIRE_FALSE(traits(mfptlib::System{mfptlib::ExpressionSystem{
+            "q0^2 * cos(t)", masses}}).time_independent_potential);
+    }
+
+    SECTION("Invalid expressions throw.")
+    {
+        const mfptlib::Vector masses{{1.0, 1.0}};
+        for(const char* expression : {
+            "", "q0 +", "(q0", "q0 q1", "q2", "foo", "foo(q0)", "pow(q0)",
+            "2 * * q0", "sin q0",
+        })
+            REQUIRE_THROWS_AS(
+                mfptlib::ExpressionSystem(expression, masses),
+                std::invalid_argument
+            );
+
+        REQUIRE_THROWS_AS(
+            mfptlib::ExpressionSystem("t", masses, {{"t", 1.0}}),
+            std::invalid_argument
+        );
+        REQUIRE_THROWS_AS(
+            mfptlib::ExpressionSystem("q1", masses, {{"q1", 1.0}}),
+            std::invalid_argument
+        );
+    }
+}
@@ -0,0 +1,244 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cmath>
+#include <memory>
+#include <numbers>
+#include <stdexcept>
+
+#include <catch2/catch.hpp>
+
+#include <mfptlib/core/Types.hpp>
+#include <mfptlib/sys/GridSystem.hpp>
+#include <mfptlib/sys/System.hpp>
+
+#include "../Matcher.hpp"
+
+
+namespace {
+
+// Quadratic polynomials are interpolated exactly away from the boundaries.
+auto quadratic(double x, double y, double z) -> double
+{
+    return 1.0 + 2.0 * x - y + 0.5 * z
+        + 0.5 * x * x + x * y - 1.5 * y * y + 0.25 * y * z - z * z;
+}
+
+auto quadratic_force(double x, double y, double z) -> mfptlib::Vector
+{
+    return mfptlib::Vector{{
+        -(2.0 + x + y),
+        -(-1.0 + x - 3.0 * y + 0.25 * z),
+        -(0.5 + 0.25 * y - 2.0 * z),
+    }};
+}
+
+} // namespace
+
+
+TEST_CASE("sys/GridSystem", "[sys]")
+{
+    constexpr double t{0.0};
+    constexpr double prec{1e-12};
+
+    const mfptlib::Indices shape{{9, 11, 5}};
+    const mfptlib::Vector lower{{-1.0, 0.0, 2.0}};
+    const mfptlib::Vector upper{{1.0, 2.0, 3.0}};
+    const mfptlib::Vector dof_masses{{1.0, 2.0, 3.0}};
+
+    mfptlib::Scalars values{shape.prod()};
+    for(mfptlib::Index i = 0; i < shape[0]; ++i)
+        for(mfptlib::Index j = 0; j < shape[1]; ++j)
+            for(mfptlib::Index k = 0; k < shape[2]; ++k)
+                values[(i * shape[1] + j) * shape[2] + k] = quadratic(
+                    -1.0 + 0.25 * static_cast<double>(i),
+                    0.2 * static_cast<double>(j),
+                    2.0 + 0.25 * static_cast<double>(k));
+
+    const mfptlib::GridSystem model{values, shape, lower, upper, dof_masses};
+    const mfptlib::System system{model};
+
+    REQUIRE(degrees_of_freedom(system) == 3);
+    REQUIRE_THAT(model.spacing(), mfptlib::test::approx({{0.25, 0.2, 0.25}}));
+
+    SECTION("Quadratic polynomials are reproduced inside of the grid.")
+    {
+        const mfptlib::Vectors states{
+            {-0.7, 0.3, 2.3, 0.0, 0.0, 0.0},
+            {0.0, 1.0, 2.5, 1.0, 2.0, 3.0},
+            {0.61, 1.77, 2.74, 0.0, 0.0, 0.0},
+        };
+
+        mfptlib::Scalars expected_potential{states.rows()};
+        mfptlib::Vectors expected_force{states.rows(), 3};
+        for(mfptlib::Index row = 0; row < states.rows(); ++row)
+        {
+            const double x = states(row, 0);
+            const double y = states(row, 1);
+            const double z = states(row, 2);
+            expected_potential[row] = quadratic(x, y, z);
+            expected_force.row(row) = quadratic_force(x, y, z);
+        }
+
+        const auto [energy, forces] = energy_and_force(system, states, t);
+        REQUIRE_THAT(energy, mfptlib::test::approx(expected_potential, prec));
+        REQUIRE_THAT(forces, mfptlib::test::approx(expected_force, prec));
+        REQUIRE_THAT(
+            potential(system, states, t),
+            mfptlib::test::equals(energy)
+        );
+        REQUIRE_THAT(
+            force(system, states, t),
+            mfptlib::test::equals(forces)
+        );
+        REQUIRE_THAT(
+            masses(system, states),
+            mfptlib::test::equals(dof_masses.replicate(states.rows(), 1))
+        );
+    }
+
+    SECTION("The grid values are reproduced on the boundary.")
+    {
+        const mfptlib::Vectors states{
+            {-1.0, 0.0, 2.0, 0.0, 0.0, 0.0},
+            {1.0, 2.0, 3.0, 0.0, 0.0, 0.0},
+            {-1.0, 1.4, 3.0, 0.0, 0.0, 0.0},
+        };
+        REQUIRE_THAT(
+            potential(system, states, t),
+            mfptlib::test::approx({
+                quadratic(-1.0, 0.0, 2.0),
+                quadratic(1.0, 2.0, 3.0),
+                quadratic(-1.0, 1.4, 3.0),
+            }, prec)
+        );
+    }
+
+    SECTION("The potential is constant outside of the grid.")
+    {
+        const mfptlib::Vectors states{
+            {-3.0, 1.0, 2.5, 0.0, 0.0, 0.0},
+            {-1.0, 1.0, 2.5, 0.0, 0.0, 0.0},
+            {0.0, 7.0, 2.5, 0.0, 0.0, 0.0},
+            {0.0, 2.0, 2.5, 0.0, 0.0, 0.0},
+        };
+        const auto [energy, forces] = energy_and_force(system, states, t);
+        REQUIRE(energy[0] == energy[1]);
+        REQUIRE(energy[2] == energy[3]);
+        REQUIRE(forces(0, 0) == 0.0);
+        REQUIRE(forces(2, 1) == 0.0);
+        REQUIRE(forces(0, 1) == forces(1, 1));
+        REQUIRE(forces(2, 0) == forces(3, 0));
+    }
+
+    SECTION("Invalid states yield NaN.")
+    {
+        const mfptlib::Vectors states{{NAN, 1.0, 2.5, 0.0, 0.0, 0.0}};
+        const auto [energy, forces] = energy_and_force(system, states, t);
+        REQUIRE(std::isnan(energy[0]));
+        REQUIRE(forces.isNaN().all());
+    }
+
+    SECTION("Rows are evaluated in chunks.")
+    {
+        // Mix rows inside, outside and NaN across several chunks.
+        const mfptlib::Vectors rows{
+            {-0.7, 0.3, 2.3, 0.0, 0.0, 0.0},
+            {-3.0, 1.0, 2.5, 0.0, 0.0, 0.0},
+            {NAN, 1.0, 2.5, 0.0, 0.0, 0.0},
+        };
+        const mfptlib::Vectors states = rows.replicate(23, 1);
+        const auto [energy, forces] = energy_and_force(system, states, t);
+        const auto [row_energy, row_forces] = energy_and_force(system, rows, t);
+
+        // NaNs never compare equal, so compare their positions separately.
+        const auto finite = [](const auto& a)
+            { return mfptlib::Vectors{a.isNaN().select(0.0, a)}; };
+        REQUIRE((energy.isNaN() == row_energy.replicate(23, 1).isNaN()).all());
+        REQUIRE((forces.isNaN() == row_forces.replicate(23, 1).isNaN()).all());
+        REQUIRE_THAT(finite(energy),
+            mfptlib::test::equals(finite(row_energy.replicate(23, 1))));
+        REQUIRE_THAT(finite(forces),
+            mfptlib::test::equals(finite(row_forces.replicate(23, 1))));
+    }
+
+    SECTION("The values are shared, not copied.")
+    {
+        const auto buffer = std::make_shared<double[]>(4);
+        const mfptlib::GridSystem shared{
+            buffer,
+            mfptlib::Indices{{2, 2}},
+            mfptlib::Vector{{0.0, 0.0}},
+            mfptlib::Vector{{1.0, 1.0}},
+            mfptlib::Vector{{1.0, 1.0}},
+        };
+        const mfptlib::System copy{shared};
+        const mfptlib::Vectors states{{1.0, 0.0, 0.0, 0.0}};
+
+        REQUIRE(shared.values() == buffer.get());
+        REQUIRE_THAT(potential(copy, states, t), mfptlib::test::equals({0.0}));
+        buffer[2] = 5.0;
+        REQUIRE_THAT(potential(copy, states, t), mfptlib::test::equals({5.0}));
+    }
+
+    SECTION("Invalid grids throw.")
+    {
+        REQUIRE_THROWS_AS(
+            mfptlib::GridSystem(
+                mfptlib::Scalars::Zero(4), shape, lower, upper, dof_masses),
+            std::invalid_argument
+        );
+        REQUIRE_THROWS_AS(
+            mfptlib::GridSystem(values, shape, upper, lower, dof_masses),
+            std::invalid_argument
+        );
+        REQUIRE_THROWS_AS(
+            mfptlib::GridSystem(
+                values, shape, lower, upper, mfptlib::Vector{{1.0}}),
+            std::invalid_argument
+        );
+        REQUIRE_THROWS_AS(
+            mfptlib::GridSystem(
+                mfptlib::Scalars::Zero(9),
+                mfptlib::Indices{{9, 1}},
+                mfptlib::Vector{{0.0, 0.0}},
+                mfptlib::Vector{{1.0, 1.0}},
+                mfptlib::Vector{{1.0, 1.0}}),
+            std::invalid_argument
+        );
+    }
+}
+
+
+TEST_CASE("sys/GridSystem/periodic", "[sys]")
+{
+    constexpr double t{0.0};
+    constexpr double period{2.0 * std::numbers::pi};
+    constexpr mfptlib::Index points{128};
+
+    mfptlib::Scalars values{points};
+    for(mfptlib::Index i = 0; i < points; ++i)
+        values[i] = std::sin(period * static_cast<double>(i) / points);
+
+    const mfptlib::System system{mfptlib::GridSystem{
+        values,
+        mfptlib::Indices{{points}},
+        mfptlib::Vector{{0.0}},
+        mfptlib::Vector{{period}},
+        mfptlib::Vector{{1.0}},
+        mfptlib::Booleans{{true}},
+    }};
+
+    const mfptlib::Vectors states{{0.1, 0.0}, {3.0, 0.0}, {6.2, 0.0}};
+    const mfptlib::Vectors shifted{
+        {0.1 + period, 0.0}, {3.0 - 2.0 * period, 0.0}, {6.2 - period, 0.0}};
+
+    const auto [energy, forces] = energy_and_force(system, states, t);
+    REQUIRE_THAT(energy, mfptlib::test::approx(states.col(0).sin(), 1e-4));
+    REQUIRE_THAT(forces, mfptlib::test::approx(-states.col(0).cos(), 1e-3));
+
+    const auto [shifted_energy, shifted_forces] =
+        energy_and_force(system, shifted, t);
+    REQUIRE_THAT(shifted_energy, mfptlib::test::approx(energy, 1e-12));
+    REQUIRE_THAT(shifted_forces, mfptlib::test::approx(forces, 1e-12));
+}
@@ -0,0 +1,133 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include <utility>
+
+#include <catch2/catch.hpp>
+
+#include <mfptlib/core/Types.hpp>
+#include <mfptlib/math/BaoabStepper.hpp>
+#include <mfptlib/math/Observer.hpp>
+#include <mfptlib/math/Propagate.hpp>
+#include <mfptlib/math/Stepper.hpp>
+#include <mfptlib/sys/LithiumCyanide.hpp>
+#include <mfptlib/sys/System.hpp>
+
+#include "../Matcher.hpp"
+#include "../NullBath.hpp"
+
+
+namespace {
+
+// LiCN without any traits, which steppers must treat conservatively.
+struct PlainLithiumCyanide
+{
+    mfptlib::LithiumCyanide model;
+};
+
+auto degrees_of_freedom(const PlainLithiumCyanide&) -> mfptlib::Index
+{ return 2; }
+
+void potential_into(
+    const PlainLithiumCyanide& sys,
+    const mfptlib::VectorsCRef& states,
+    double t,
+    mfptlib::ScalarsRef out
+)
+{ potential_into(sys.model, states, t, std::move(out)); }
+
+void force_into(
+    const PlainLithiumCyanide& sys,
+    const mfptlib::VectorsCRef& states,
+    double t,
+    mfptlib::VectorsRef out
+)
+{ force_into(sys.model, states, t, std::move(out)); }
+
+void masses_into(
+    const PlainLithiumCyanide& sys,
+    const mfptlib::VectorsCRef& states,
+    mfptlib::VectorsRef out
+)
+{ masses_into(sys.model, states, std::move(out)); }
+
+} // namespace
+
+
+TEST_CASE("sys/LithiumCyanide", "[sys]")
+{
+    constexpr double t{0.0};
+    constexpr double prec{1e-12};
+    const mfptlib::System system{mfptlib::LithiumCyanide{}};
+
+    // Reference values of the direct summation of all Legendre polynomials.
+    const mfptlib::Vectors states{
+        {0.0, 4.0, 0.0, 0.0},
+        {1.0, 4.5, 1.0, 2.0},
+        {2.0, 5.0, 3.0, 4.0},
+        {3.0, 3.5, 5.0, 6.0},
+    };
+    const mfptlib::Scalars expected_potential{{
+        -0.17899907834847881,
+        -0.22468577671874437,
+        -0.2054906023887054,
+        -0.16298216448571379,
+    }};
+    const mfptlib::Vectors expected_force{
+        { 0.0                ,  0.17785304677653735 },
+        {-0.019091168803616415, -0.021088806941595498},
+        { 0.020159312318359577, -0.038571725072298141},
+        {-0.053816981255381362,  0.26998769115100024 },
+    };
+
+    SECTION("Potential and force match the direct summation.")
+    {
+        REQUIRE_THAT(
+            potential(system, states, t),
+            mfptlib::test::approx(expected_potential, prec)
+        );
+        REQUIRE_THAT(
+            force(system, states, t),
+            mfptlib::test::approx(expected_force, prec)
+        );
+    }
+
+    SECTION("Energy and force can be evaluated at once.")
+    {
+        const auto [energy, forces] = energy_and_force(system, states, t);
+        REQUIRE_THAT(energy, mfptlib::test::approx(expected_potential, prec));
+        REQUIRE_THAT(forces, mfptlib::test::approx(expected_force, prec));
+    }
+
+    SECTION("Rows are evaluated in chunks.")
+    {
+        const mfptlib::Vectors many = states.replicate(50, 1);
+        const auto [energy, forces] = energy_and_force(system, many, t);
+        REQUIRE_THAT(
+            energy,
+            mfptlib::test::approx(expected_potential.replicate(50, 1), prec)
+        );
+        REQUIRE_THAT(
+            forces,
+            mfptlib::test::approx(expected_force.replicate(50, 1), prec)
+        );
+    }
+
+    SECTION("BaoabStepper does not reuse the momentum-dependent forces.")
+    {
+        // The R-force contains the centrifugal term p_θ² / (μ₁ r³).
+        REQUIRE(!traits(system).velocity_independent_forces);
+
+        const mfptlib::System plain{PlainLithiumCyanide{}};
+        auto [bath, bath_stats] = mfptlib::test::null_bath();
+        mfptlib::Stepper stepper{mfptlib::BaoabStepper{0.1}};
+        mfptlib::Vectors expected = states;
+        mfptlib::propagate_to(stepper, bath, plain, expected, 0.0, 100.0,
+            mfptlib::Observer{});
+
+        mfptlib::Vectors actual = states;
+        mfptlib::propagate_to(stepper, bath, system, actual, 0.0, 100.0,
+            mfptlib::Observer{});
+        REQUIRE_THAT(actual, mfptlib::test::equals(expected));
+    }
+}
@@ -0,0 +1,168 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cstdint>
+#include <stdexcept>
+
+#include <catch2/catch.hpp>
+
+#include <mfptlib/core/Types.hpp>
+#include <mfptlib/sys/HarmonicOscillator.hpp>
+#include <mfptlib/sys/Plugin.h>
+#include <mfptlib/sys/PluginSystem.hpp>
+#include <mfptlib/sys/System.hpp>
+
+#include "../Matcher.hpp"
+
+
+namespace {
+
+// Free particles in 1D with the potential q² t and masses 1 + |q|.
+struct Context
+{
+    int releases{0};
+};
+
+void potential(
+    const void*,
+    std::int64_t rows,
+    const double* states,
+    std::int64_t,
+    double t,
+    double* out
+)
+{
+    for(std::int64_t row = 0; row < rows; ++row)
+        out[row] = states[row] * states[row] * t;
+}
+
+void force(
+    const void*,
+    std::int64_t rows,
+    const double* states,
+    std::int64_t,
+    double t,
+    double* out,
+    std::int64_t
+)
+{
+    for(std::int64_t row = 0; row < rows; ++row)
+        out[row] = -2.0 * states[row] * t;
+}
+
+void masses(
+    const void*,
+    std::int64_t rows,
+    const double* states,
+    std::int64_t,
+    double* out,
+    std::int64_t
+)
+{
+    for(std::int64_t row = 0; row < rows; ++row)
+        out[row] = 1.0 + (states[row] < 0.0 ? -states[row] : states[row]);
+}
+
+void release(void* context)
+{
+    ++static_cast<Context*>(context)->releases;
+}
+
+} // namespace
+
+
+TEST_CASE("sys/PluginSystem", "[sys]")
+{
+    constexpr double t{2.0};
+    Context context{};
+    const mfptlib_plugin plugin{
+        .abi_version = MFPTLIB_PLUGIN_ABI_VERSION,
+        .context = &context,
+        .degrees_of_freedom = 1,
+        .potential = potential,
+        .force = force,
+        .energy_and_force = nullptr,
+        .masses = masses,
+        .constant_masses = nullptr,
+        .release = release,
+    };
+
+    SECTION("Function pointers are called with the whole ensemble.")
+    {
+        {
+            const mfptlib::System system{mfptlib::PluginSystem{plugin}};
+            const mfptlib::System copy = system;
+            const mfptlib::Vectors states{{1.0, 0.0}, {-2.0, 1.0}};
+
+            REQUIRE(degrees_of_freedom(copy) == 1);
+            const auto [energy, forces] = energy_and_force(copy, states, t);
+            REQUIRE_THAT(energy, mfptlib::test::equals({2.0, 8.0}));
+            REQUIRE_THAT(forces, mfptlib::test::equals({{-4.0}, {8.0}}));
+            REQUIRE_THAT(
+                masses(copy, states),
+                mfptlib::test::equals({{2.0}, {3.0}})
+            );
+            REQUIRE(context.releases == 0);
+        }
+        REQUIRE(context.releases == 1);
+    }
+
+    SECTION("Invalid plugins are released and throw.")
+    {
+        mfptlib_plugin invalid = plugin;
+        invalid.masses = nullptr;
+        REQUIRE_THROWS_AS(
+            mfptlib::PluginSystem{invalid},
+            std::invalid_argument
+        );
+        REQUIRE(context.releases == 1);
+
+        invalid = plugin;
+        invalid.abi_version = MFPTLIB_PLUGIN_ABI_VERSION + 1;
+        REQUIRE_THROWS_AS(
+            mfptlib::PluginSystem{invalid},
+            std::invalid_argument
+        );
+        REQUIRE(context.releases == 2);
+    }
+
+    SECTION("Missing libraries throw.")
+    {
+        REQUIRE_THROWS_AS(
+            mfptlib::PluginSystem::load("/nonexistent/libplugin.so"),
+            std::runtime_error
+        );
+    }
+
+#ifdef MFPTLIB_TEST_PLUGIN
+    SECTION("Plugins are loaded from shared libraries.")
+    {
+        const mfptlib::System system{
+            mfptlib::PluginSystem::load(MFPTLIB_TEST_PLUGIN, "1.0 1.5")};
+        const mfptlib::System oscillator{mfptlib::HarmonicOscillator{
+            mfptlib::Vector{{1.0, 2.0}}, mfptlib::Vector{{1.0, 1.5}}}};
+
+        // Strided states, e.g., from padded storage.
+        const mfptlib::Vectors padded = mfptlib::Vectors::Random(8, 4);
+        const mfptlib::VectorsCRef states = padded.topRows(5);
+
+        REQUIRE_THAT(
+            potential(system, states, t),
+            mfptlib::test::equals(potential(oscillator, states, t))
+        );
+        REQUIRE_THAT(
+            force(system, states, t),
+            mfptlib::test::equals(force(oscillator, states, t))
+        );
+        REQUIRE_THAT(
+            masses(system, states),
+            mfptlib::test::equals(masses(oscillator, states))
+        );
+
+        REQUIRE_THROWS_AS(
+            mfptlib::PluginSystem::load(MFPTLIB_TEST_PLUGIN, "invalid"),
+            std::runtime_error
+        );
+    }
+#endif
+}
@@ -3,7 +3,7 @@
 
 #include <cmath>
 #include <stdexcept>
-#include <type_traits>
+#include <utility>
 
 #include <catch2/catch.hpp>
 
@@ -14,6 +14,68 @@
 #include "../Matcher.hpp"
 
 
+namespace {
+
+// System that only provides the value-returning functions.
+struct ValueOscillator
+{
+    mfptlib::HarmonicOscillator model;
+};
+
+auto degrees_of_freedom(const ValueOscillator& sys) -> mfptlib::Index
+{ return degrees_of_freedom(sys.model); }
+
+auto potential(
+    const ValueOscillator& sys, const mfptlib::VectorsCRef& states, double t
+) -> mfptlib::Scalars
+{ return potential(sys.model, states, t); }
+
+auto force(
+    const ValueOscillator& sys, const mfptlib::VectorsCRef& states, double t
+) -> mfptlib::Vectors
+{ return force(sys.model, states, t); }
+
+auto masses(
+    const ValueOscillator& sys, const mfptlib::VectorsCRef& states
+) -> mfptlib::Vectors
+{ return masses(sys.model, states); }
+
+
+// System that only provides the *_into() functions.
+struct BufferOscillator
+{
+    mfptlib::HarmonicOscillator model;
+};
+
+auto degrees_of_freedom(const BufferOscillator& sys) -> mfptlib::Index
+{ return degrees_of_freedom(sys.model); }
+
+void potential_into(
+    const BufferOscillator& sys,
+    const mfptlib::VectorsCRef& states,
+    double t,
+    mfptlib::ScalarsRef out
+)
+{ potential_into(sys.model, states, t, std::move(out)); }
+
+void force_into(
+    const BufferOscillator& sys,
+    const mfptlib::VectorsCRef& states,
+    double t,
+    mfptlib::VectorsRef out
+)
+{ force_into(sys.model, states, t, std::move(out)); }
+
+void masses_into(
+    const BufferOscillator& sys,
+    const mfptlib::VectorsCRef& states,
+    mfptlib::VectorsRef out
+)
+{ masses_into(sys.model, states, std::move(out)); }
+
+} // namespace
+
+
 TEST_CASE("sys/System", "[sys]")
 {
     const double sqrt2 = std::sqrt(2.0);
@@ -72,6 +134,20 @@ TEST_CASE("sys/System", "[sys]")
             masses(system, states),
             mfptlib::test::approx(expected_masses)
         );
+
+        mfptlib::Scalars potential_out{states.rows()};
+        potential_into(system, states, t, potential_out);
+        REQUIRE_THAT(potential_out, mfptlib::test::approx(expected_potential));
+
+        mfptlib::Vectors out{states.rows(), 2};
+        force_into(system, states, t, out);
+        REQUIRE_THAT(out, mfptlib::test::approx(expected_force));
+        masses_into(system, states, out);
+        REQUIRE_THAT(out, mfptlib::test::approx(expected_masses));
+
+        const auto [energy, forces] = energy_and_force(system, states, t);
+        REQUIRE_THAT(energy, mfptlib::test::approx(expected_potential));
+        REQUIRE_THAT(forces, mfptlib::test::approx(expected_force));
     };
 
     SECTION("System forwards calls to the underlying implementation.")
@@ -81,10 +157,27 @@ TEST_CASE("sys/System", "[sys]")
         verify(system);
     }
 
-    static_assert(!std::is_copy_constructible_v<mfptlib::System>,
-        "System should not be copy-constructible.");
-    static_assert(!std::is_copy_assignable_v<mfptlib::System>,
-        "System should not be copy-assignable.");
+    SECTION("System falls back to the value-returning functions.")
+    {
+        const mfptlib::System system{ValueOscillator{
+            mfptlib::HarmonicOscillator{{{1.0, 2.0}}, {{4.0, 1.0}}}}};
+        verify(system);
+    }
+
+    SECTION("System falls back to the *_into() functions.")
+    {
+        const mfptlib::System system{BufferOscillator{
+            mfptlib::HarmonicOscillator{{{1.0, 2.0}}, {{4.0, 1.0}}}}};
+        verify(system);
+    }
+
+    SECTION("System can be copied.")
+    {
+        const mfptlib::System system{mfptlib::HarmonicOscillator{
+            {{1.0, 2.0}}, {{4.0, 1.0}}}};
+        const mfptlib::System copied{system};
+        verify(copied);
+    }
 
     SECTION("System can be moved.")
     {
@@ -94,6 +187,24 @@ TEST_CASE("sys/System", "[sys]")
         verify(moved);
     }
 
+    SECTION("System forwards the traits of the implementation.")
+    {
+        const mfptlib::System system{mfptlib::HarmonicOscillator{
+            {{1.0, 2.0}}, {{4.0, 1.0}}}};
+        const mfptlib::SystemTraits declared = traits(system);
+        REQUIRE(declared.velocity_independent_forces);
+        REQUIRE(declared.constant_masses);
+        REQUIRE(declared.time_independent_potential);
+
+        // Systems without traits make no assumptions.
+        const mfptlib::System fallback{ValueOscillator{
+            mfptlib::HarmonicOscillator{{{1.0, 2.0}}, {{4.0, 1.0}}}}};
+        const mfptlib::SystemTraits assumed = traits(fallback);
+        REQUIRE_FALSE(assumed.velocity_independent_forces);
+        REQUIRE_FALSE(assumed.constant_masses);
+        REQUIRE_FALSE(assumed.time_independent_potential);
+    }
+
     SECTION("System throws if incompatible state/system size is used.")
     {
         const mfptlib::System system{mfptlib::HarmonicOscillator{
@@ -120,4 +231,29 @@ TEST_CASE("sys/System", "[sys]")
             std::invalid_argument
         );
     }
+
+    SECTION("System throws if incompatible output size is used.")
+    {
+        const mfptlib::System system{mfptlib::HarmonicOscillator{
+            {{1.0, 2.0}}, {{4.0, 1.0}}}};
+        mfptlib::Scalars scalars{states.rows() - 1};
+        mfptlib::Vectors vectors{states.rows(), 3};
+
+        REQUIRE_THROWS_AS(
+            potential_into(system, states, t, scalars),
+            std::invalid_argument
+        );
+        REQUIRE_THROWS_AS(
+            force_into(system, states, t, vectors),
+            std::invalid_argument
+        );
+        REQUIRE_THROWS_AS(
+            masses_into(system, states, vectors),
+            std::invalid_argument
+        );
+        REQUIRE_THROWS_AS(
+            energy_and_force_into(system, states, t, scalars, vectors),
+            std::invalid_argument
+        );
+    }
 }
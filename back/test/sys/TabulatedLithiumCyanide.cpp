@@ -0,0 +1,155 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cmath>
+#include <filesystem>
+#include <numbers>
+#include <stdexcept>
+#include <string>
+
+#include <unistd.h>
+
+#include <catch2/catch.hpp>
+
+#include <mfptlib/core/Types.hpp>
+#include <mfptlib/sys/LithiumCyanide.hpp>
+#include <mfptlib/sys/System.hpp>
+#include <mfptlib/sys/TabulatedLithiumCyanide.hpp>
+
+#include "../Matcher.hpp"
+
+
+TEST_CASE("sys/TabulatedLithiumCyanide", "[sys]")
+{
+    constexpr double t{0.0};
+    const auto dir = std::filesystem::temp_directory_path()
+        / ("mfptlib-test-licn-" + std::to_string(::getpid()));
+    const mfptlib::TabulationOptions options{
+        .theta_points = 64,
+        .r_min = 3.5,
+        .r_max = 6.0,
+        .r_points = 48,
+        .cache_dir = dir,
+    };
+
+    const mfptlib::Vectors states{
+        {0.1, 4.0, 0.0, 0.0},
+        {1.0, 4.5, 1.0, 2.0},
+        {2.0, 5.0, 3.0, 4.0},
+        {3.0, 3.7, 5.0, 6.0},
+        {std::numbers::pi, 5.9, 0.0, 0.0},
+    };
+    const mfptlib::System analytic{mfptlib::LithiumCyanide{}};
+    const auto [expected_potential, expected_force] =
+        energy_and_force(analytic, states, t);
+
+    SECTION("The interpolation errors stay below the measured maximum.")
+    {
+        const mfptlib::TabulatedLithiumCyanide model{options};
+        REQUIRE(!model.is_cached());
+        REQUIRE(model.max_potential_error() < 1e-5);
+        REQUIRE(model.max_force_error() < 1e-3);
+
+        const mfptlib::System system{model};
+        const auto [energy, forces] = energy_and_force(system, states, t);
+        REQUIRE((energy - expected_potential).abs().maxCoeff()
+            <= model.max_potential_error());
+        REQUIRE((forces - expected_force).abs().maxCoeff()
+            <= model.max_force_error());
+        REQUIRE_THAT(
+            potential(system, states, t),
+            mfptlib::test::equals(energy)
+        );
+        REQUIRE_THAT(
+            force(system, states, t),
+            mfptlib::test::equals(forces)
+        );
+        REQUIRE_THAT(
+            masses(system, states),
+            mfptlib::test::equals(masses(analytic, states))
+        );
+
+        SECTION("The table is loaded from the cache.")
+        {
+            const mfptlib::TabulatedLithiumCyanide cached{options};
+            REQUIRE(cached.is_cached());
+            REQUIRE(cached.max_potential_error()
+                == model.max_potential_error());
+            REQUIRE(cached.max_force_error() == model.max_force_error());
+            REQUIRE_THAT(
+                potential(mfptlib::System{cached}, states, t),
+                mfptlib::test::equals(energy)
+            );
+        }
+    }
+
+    SECTION("The potential is even and periodic in θ.")
+    {
+        const mfptlib::System system{
+            mfptlib::TabulatedLithiumCyanide{options}};
+        mfptlib::Vectors mirrored = states;
+        mirrored.col(0) = 2.0 * std::numbers::pi - states.col(0);
+
+        REQUIRE_THAT(
+            potential(system, mirrored, t),
+            mfptlib::test::approx(potential(system, states, t), 1e-12)
+        );
+        REQUIRE_THAT(
+            force(system, mirrored, t).col(0),
+            mfptlib::test::approx(-force(system, states, t).col(0), 1e-12)
+        );
+    }
+
+    SECTION("The forces are declared to depend on the momenta.")
+    {
+        // The R-force contains the centrifugal term p_θ² / (μ₁ r³).
+        const mfptlib::System system{
+            mfptlib::TabulatedLithiumCyanide{options}};
+        REQUIRE(!traits(system).velocity_independent_forces);
+        REQUIRE(traits(system).time_independent_potential);
+    }
+
+    SECTION("States outside of the table are evaluated analytically.")
+    {
+        const mfptlib::System system{
+            mfptlib::TabulatedLithiumCyanide{options}};
+        mfptlib::Vectors outside = states;
+        outside.col(1) += 10.0;
+
+        REQUIRE_THAT(
+            potential(system, outside, t),
+            mfptlib::test::equals(potential(analytic, outside, t))
+        );
+        REQUIRE_THAT(
+            force(system, outside, t),
+            mfptlib::test::equals(force(analytic, outside, t))
+        );
+    }
+
+    SECTION("The table can be built without a cache.")
+    {
+        auto uncached = options;
+        uncached.cache_dir.clear();
+        REQUIRE(!mfptlib::TabulatedLithiumCyanide{uncached}.is_cached());
+        REQUIRE(!mfptlib::TabulatedLithiumCyanide{uncached}.is_cached());
+    }
+
+    SECTION("TabulatedLithiumCyanide throws for invalid grids.")
+    {
+        auto invalid = options;
+        invalid.theta_points = 1;
+        REQUIRE_THROWS_AS(
+            mfptlib::TabulatedLithiumCyanide{invalid},
+            std::invalid_argument
+        );
+
+        invalid = options;
+        invalid.r_max = invalid.r_min;
+        REQUIRE_THROWS_AS(
+            mfptlib::TabulatedLithiumCyanide{invalid},
+            std::invalid_argument
+        );
+    }
+
+    std::filesystem::remove_all(dir);
+}
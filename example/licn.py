@@ -31,7 +31,7 @@ def main():
     system = mfptlib.lithium_cyanide()
     ensemble = delta_ensemble(system, ENSEMBLE_SIZE, kb_t, ENSEMBLE_SEED)
     t_0 = 0.0
-    predicate = mfptlib.Predicate(is_reacting)
+    predicate = mfptlib.angle_window(0, center=0.0, half_width=0.6 * np.pi)
 
     # Run the simulation (including a nice progress bar):
     with track_progress(ENSEMBLE_SIZE) as observer:
@@ -44,10 +44,6 @@ def main():
     print(f'Rate: {1 / mfpt} a.u.')
 
 
-def is_reacting(qp, t):
-    return np.abs(mfptlib.positions[qp][..., 0]) < 0.6 * np.pi
-
-
 def licn_minimum(system):
     theta = 0.0
     pot = lambda r: system.potential(qp=np.array([(theta, r[0], 0.0, 0.0)]), t=0.0)[0]
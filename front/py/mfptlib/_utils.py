@@ -12,9 +12,14 @@
     'momenta',
     'states',
     'grid',
+    'padded',
 ]
 
 
+_BLOCK_ROWS = 8
+_ALIGNMENT = 64
+
+
 def dofs(qpt: np.ndarray, /) -> int:
     """Return the number of degrees of freedom for states *qpt*."""
 
@@ -105,3 +110,29 @@ def grid(*ranges: npt.ArrayLike) -> np.ndarray:
         list(map(np.ravel, np.meshgrid(*ranges, indexing='ij'))),
         axis=1,
     ))
+
+
+def padded(qp: npt.ArrayLike, /) -> np.ndarray:
+    """
+    Return a copy of states *qp* in padded, 64-byte aligned storage.
+
+    The storage is column-major with the number of rows rounded up
+    to a multiple of 8, so that every column starts at an aligned address.
+    The padding rows are zero and not part of the returned view,
+    which can be used anywhere a regular state array can.
+    Propagation treats the view like any other strided state array
+    and does not rely on the alignment.
+    """
+
+    qp = np.asarray(qp, dtype=np.float64)
+    rows, cols = qp.shape
+    stride = -(-rows // _BLOCK_ROWS) * _BLOCK_ROWS
+    size = stride * cols
+
+    item = np.dtype(np.float64).itemsize
+    buffer = np.zeros(size + _ALIGNMENT // item)
+    offset = (-buffer.ctypes.data % _ALIGNMENT) // item
+    storage = buffer[offset : offset + size].reshape((stride, cols), order='F')
+    storage[:rows] = qp
+
+    return storage[:rows]
@@ -7,10 +7,15 @@
 #include "math/Observer.hpp"
 #include "math/Predicate.hpp"
 #include "math/Propagate.hpp"
+#include "math/Statistics.hpp"
 #include "math/Stepper.hpp"
 #include "sys/EmptyPlane.hpp"
+#include "sys/ExpressionSystem.hpp"
+#include "sys/GridSystem.hpp"
 #include "sys/HarmonicOscillator.hpp"
 #include "sys/LithiumCyanide.hpp"
+#include "sys/PluginSystem.hpp"
+#include "sys/PythonSystem.hpp"
 #include "sys/System.hpp"
 
 
@@ -18,12 +23,19 @@ PYBIND11_MODULE(_backend, m)
 {
     mfptlib::class_system(m);
     mfptlib::def_empty_plane(m);
+    mfptlib::def_expression_system(m);
+    mfptlib::def_grid_system(m);
     mfptlib::def_harmonic_oscillator(m);
     mfptlib::def_lithium_cyanide(m);
+    mfptlib::def_plugin_system(m);
+    mfptlib::def_python_system(m);
 
     mfptlib::class_bath(m);
+    mfptlib::enum_noise_generator(m);
     mfptlib::def_langevin_bath(m);
     mfptlib::def_exp_memory_bath(m);
+    mfptlib::def_prony_memory_bath(m);
+    mfptlib::def_tabulated_memory_bath(m);
 
     mfptlib::class_stepper(m);
     mfptlib::def_baoab_stepper(m);
@@ -31,7 +43,13 @@ PYBIND11_MODULE(_backend, m)
     mfptlib::def_lf_middle_stepper(m);
 
     mfptlib::class_observer(m);
+    mfptlib::class_quantity(m);
+    mfptlib::class_statistics(m);
     mfptlib::class_predicate(m);
+    mfptlib::def_native_predicates(m);
+    mfptlib::class_ensemble(m);
+    mfptlib::enum_schedule(m);
     mfptlib::def_propagate_to(m);
     mfptlib::def_propagate_while(m);
+    mfptlib::def_has_static_kernel(m);
 }
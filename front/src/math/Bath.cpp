@@ -3,18 +3,41 @@
 
 #include "Bath.hpp"
 
+#include <optional>
+#include <utility>
+
 #include <pybind11/eigen.h>
+#include <pybind11/stl.h>
 
 #include <mfptlib/core/Types.hpp>
 #include <mfptlib/math/Bath.hpp>
 #include <mfptlib/math/ExpMemoryBath.hpp>
 #include <mfptlib/math/LangevinBath.hpp>
+#include <mfptlib/math/NoiseSource.hpp>
+#include <mfptlib/math/PronyMemoryBath.hpp>
+#include <mfptlib/math/TabulatedMemoryBath.hpp>
 
 namespace py = pybind11;
 
 
 namespace mfptlib {
 
+namespace {
+
+auto make_noise_source(
+    Seed seed, NoiseGenerator noise, std::optional<Vectors> replay,
+    bool prefetch
+) -> NoiseSource
+{
+    if(replay)
+        return NoiseSource{std::move(*replay)};
+    return NoiseSource{
+        seed, noise, prefetch ? Prefetch::On : Prefetch::Off};
+}
+
+} // namespace
+
+
 void class_bath(pybind11::module& m)
 {
     py::class_<Bath>{m, "Bath",
@@ -35,25 +58,100 @@ void class_bath(pybind11::module& m)
     .def("reset",
         &Bath::reset,
         "Reset internal state in preparation for a different ensemble."
+    )
+    .def("split_states",
+        &Bath::split_states,
+        "Move the internal state of states [*first*, n) into a new bath.",
+        py::arg{"first"}
+    )
+    .def("fork",
+        &Bath::fork,
+        "Return a copy of the bath without internal state "
+        "and with an independent random stream seeded from this bath."
     );
 }
 
 
+void enum_noise_generator(pybind11::module& m)
+{
+    py::enum_<NoiseGenerator>{m, "NoiseGenerator",
+        "Generator of the normally-distributed noise used by baths."
+    }
+    .value("VECTORIZED", NoiseGenerator::Vectorized,
+        "Interleaved xoshiro256+ streams and a vectorized Box-Muller "
+        "transform.")
+    .value("SCALAR", NoiseGenerator::Scalar,
+        "PCG64 and std::normal_distribution, reproducing earlier versions.")
+    .value("COUNTER", NoiseGenerator::Counter,
+        "Philox4x32-10 keyed by seed, trajectory, and step, making results "
+        "independent of threading and compaction.")
+    .value("REPLAY", NoiseGenerator::Replay,
+        "Noise read from a buffer passed as *replay*.");
+}
+
+
 void def_langevin_bath(pybind11::module& m)
 {
     m.def("langevin_bath",
-        [](double kb_t, double friction, Seed seed) -> Bath
-            { return Bath{LangevinBath{kb_t, friction, seed}}; },
+        [](
+            double kb_t, double friction, Seed seed, NoiseGenerator noise,
+            std::optional<Vectors> replay, bool prefetch
+        ) -> Bath
+        {
+            return Bath{LangevinBath{kb_t, friction,
+                make_noise_source(
+                    seed, noise, std::move(replay), prefetch)}};
+        },
         R"----(
 Return a Langevin bath with friction and memoryless noise.
 
 :param kb_t: The temperature :math:`k_\mathrm{B} T`.
 :param friction: The strength of the friction :math:`\gamma`.
 :param seed: The seed used to initialize the PRNG.
+:param noise: The generator of the noise.
+:param replay: Standard normal noise to replay instead of generating it,
+    with one row per state and one block of columns per step.
+:param prefetch: Whether a background thread generates the noise ahead of
+    time. This only supports vectorized noise and does not change it.
+    Threaded or tiled propagation uses forks of the bath, which do not.
+        )----",
+        py::arg{"kb_t"},
+        py::arg{"friction"},
+        py::arg{"seed"},
+        py::kw_only{},
+        py::arg{"noise"} = NoiseGenerator::Vectorized,
+        py::arg{"replay"} = std::nullopt,
+        py::arg{"prefetch"} = false
+    );
+
+    m.def("langevin_bath",
+        [](
+            Scalars kb_t, Scalars friction, Seed seed, NoiseGenerator noise,
+            std::optional<Vectors> replay, bool prefetch
+        ) -> Bath
+        {
+            return Bath{LangevinBath{std::move(kb_t), std::move(friction),
+                make_noise_source(
+                    seed, noise, std::move(replay), prefetch)}};
+        },
+        R"----(
+Return a Langevin bath with a temperature and friction per state.
+
+This allows sweeping over the parameters within a single ensemble, whose
+:math:`i`-th state uses the :math:`i`-th parameters. The parameters follow
+their states during propagation, so this bath requires :meth:`Bath.reset`
+to be called before the bath can be reused for another ensemble.
+
+:param kb_t: The temperatures :math:`k_\mathrm{B} T` of the states.
+:param friction: The strengths of the friction :math:`\gamma` of the states.
         )----",
         py::arg{"kb_t"},
         py::arg{"friction"},
-        py::arg{"seed"}
+        py::arg{"seed"},
+        py::kw_only{},
+        py::arg{"noise"} = NoiseGenerator::Vectorized,
+        py::arg{"replay"} = std::nullopt,
+        py::arg{"prefetch"} = false
     );
 }
 
@@ -61,8 +159,16 @@ Return a Langevin bath with friction and memoryless noise.
 void def_exp_memory_bath(pybind11::module& m)
 {
     m.def("exp_memory_bath",
-        [](double kb_t, double friction, double memory, Seed seed) -> Bath
-            { return Bath{ExpMemoryBath{kb_t, friction, memory, seed}}; },
+        [](
+            double kb_t, double friction, double memory, Seed seed,
+            NoiseGenerator noise, std::optional<Vectors> replay,
+            bool prefetch
+        ) -> Bath
+        {
+            return Bath{ExpMemoryBath{kb_t, friction, memory,
+                make_noise_source(
+                    seed, noise, std::move(replay), prefetch)}};
+        },
         R"----(
 Return a bath with friction, noise, and an exponential memory kernel.
 
@@ -74,11 +180,148 @@ The memory time scale is given by :math:`\tau = \gamma \alpha`.
 :param friction: The strength of the friction :math:`\gamma`.
 :param memory: The memory parameter :math:`\alpha`.
 :param seed: The seed used to initialize the PRNG.
+:param noise: The generator of the noise.
+:param replay: Standard normal noise to replay instead of generating it,
+    with one row per state and one block of columns per step.
+:param prefetch: Whether a background thread generates the noise ahead of
+    time. This only supports vectorized noise and does not change it.
+    Threaded or tiled propagation uses forks of the bath, which do not.
+        )----",
+        py::arg{"kb_t"},
+        py::arg{"friction"},
+        py::arg{"memory"},
+        py::arg{"seed"},
+        py::kw_only{},
+        py::arg{"noise"} = NoiseGenerator::Vectorized,
+        py::arg{"replay"} = std::nullopt,
+        py::arg{"prefetch"} = false
+    );
+
+    m.def("exp_memory_bath",
+        [](
+            Scalars kb_t, Scalars friction, Scalars memory, Seed seed,
+            NoiseGenerator noise, std::optional<Vectors> replay,
+            bool prefetch
+        ) -> Bath
+        {
+            return Bath{ExpMemoryBath{
+                std::move(kb_t), std::move(friction), std::move(memory),
+                make_noise_source(
+                    seed, noise, std::move(replay), prefetch)}};
+        },
+        R"----(
+Return a bath with an exponential memory kernel and parameters per state.
+
+The :math:`i`-th state of the ensemble uses the :math:`i`-th parameters,
+which follow their states during propagation.
+
+:param kb_t: The temperatures :math:`k_\mathrm{B} T` of the states.
+:param friction: The strengths of the friction :math:`\gamma` of the states.
+:param memory: The memory parameters :math:`\alpha` of the states.
         )----",
         py::arg{"kb_t"},
         py::arg{"friction"},
         py::arg{"memory"},
-        py::arg{"seed"}
+        py::arg{"seed"},
+        py::kw_only{},
+        py::arg{"noise"} = NoiseGenerator::Vectorized,
+        py::arg{"replay"} = std::nullopt,
+        py::arg{"prefetch"} = false
+    );
+}
+
+
+
+void def_prony_memory_bath(pybind11::module& m)
+{
+    m.def("prony_memory_bath",
+        [](
+            double kb_t, Scalars frictions, Scalars memories, Seed seed,
+            NoiseGenerator noise, std::optional<Vectors> replay,
+            bool prefetch
+        ) -> Bath
+        {
+            return Bath{PronyMemoryBath{
+                kb_t, std::move(frictions), std::move(memories),
+                make_noise_source(
+                    seed, noise, std::move(replay), prefetch)}};
+        },
+        R"----(
+Return a bath with friction, noise, and a memory kernel made up of several
+exponentials, i.e., a Prony series.
+
+Every term :math:`k` contributes like :func:`exp_memory_bath` with its own
+friction :math:`\gamma_k` and memory time scale
+:math:`\tau_k = \gamma_k \alpha_k`, so that the costs grow linearly with
+the number of terms. This bath requires :meth:`Bath.reset` to be called
+before the bath can be reused for another ensemble.
+
+:param kb_t: The temperature :math:`k_\mathrm{B} T`.
+:param frictions: The strengths of the friction :math:`\gamma_k`.
+:param memories: The memory parameters :math:`\alpha_k`.
+:param seed: The seed used to initialize the PRNG.
+:param noise: The generator of the noise.
+:param replay: Standard normal noise to replay instead of generating it,
+    with one row per state and one block of columns per step and term.
+:param prefetch: Whether a background thread generates the noise ahead of
+    time. This only supports vectorized noise and does not change it.
+    Threaded or tiled propagation uses forks of the bath, which do not.
+        )----",
+        py::arg{"kb_t"},
+        py::arg{"frictions"},
+        py::arg{"memories"},
+        py::arg{"seed"},
+        py::kw_only{},
+        py::arg{"noise"} = NoiseGenerator::Vectorized,
+        py::arg{"replay"} = std::nullopt,
+        py::arg{"prefetch"} = false
+    );
+}
+
+
+
+void def_tabulated_memory_bath(pybind11::module& m)
+{
+    m.def("tabulated_memory_bath",
+        [](
+            double kb_t, Scalars kernel, double dt, Seed seed,
+            NoiseGenerator noise, std::optional<Vectors> replay,
+            bool prefetch
+        ) -> Bath
+        {
+            return Bath{TabulatedMemoryBath{kb_t, std::move(kernel), dt,
+                make_noise_source(
+                    seed, noise, std::move(replay), prefetch)}};
+        },
+        R"----(
+Return a bath with friction, colored noise, and a tabulated memory kernel.
+
+The memory integral over the past momenta and the colored noise are
+evaluated by FFT convolutions over blocks of steps. This bath keeps the
+history of every state, requires :meth:`Bath.reset` to be called before
+the bath can be reused for another ensemble, and only supports steppers
+with the time step *dt*.
+
+:param kb_t: The temperature :math:`k_\mathrm{B} T`.
+:param kernel: The memory kernel :math:`K(j \, \mathrm{d}t)`
+    for :math:`j = 0, 1, \ldots`.
+:param dt: The time step of the kernel and the stepper.
+:param seed: The seed used to initialize the PRNG.
+:param noise: The generator of the white noise that is filtered.
+:param replay: Standard normal noise to replay instead of generating it,
+    with one row per state and one block of columns per block of steps.
+:param prefetch: Whether a background thread generates the noise ahead of
+    time. This only supports vectorized noise and does not change it.
+    Threaded or tiled propagation uses forks of the bath, which do not.
+        )----",
+        py::arg{"kb_t"},
+        py::arg{"kernel"},
+        py::arg{"dt"},
+        py::arg{"seed"},
+        py::kw_only{},
+        py::arg{"noise"} = NoiseGenerator::Vectorized,
+        py::arg{"replay"} = std::nullopt,
+        py::arg{"prefetch"} = false
     );
 }
 
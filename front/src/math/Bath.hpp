@@ -11,8 +11,11 @@
 namespace mfptlib {
 
 void class_bath(pybind11::module& m);
+void enum_noise_generator(pybind11::module& m);
 void def_langevin_bath(pybind11::module& m);
 void def_exp_memory_bath(pybind11::module& m);
+void def_prony_memory_bath(pybind11::module& m);
+void def_tabulated_memory_bath(pybind11::module& m);
 
 } // namespace mfptlib
 
@@ -8,6 +8,7 @@
 
 #include <mfptlib/core/Types.hpp>
 #include <mfptlib/math/Observer.hpp>
+#include <mfptlib/math/Statistics.hpp>
 
 namespace py = pybind11;
 
@@ -23,6 +24,18 @@ void class_observer(pybind11::module& m)
         "Construct an Observer from a Python function. Defaults to a no-op.",
         py::arg{"func"} = Observer::Function{}
     )
+    .def(py::init([](const MomentsObserver& obs) -> Observer { return obs; }),
+        "Construct an Observer accumulating into *obs*.",
+        py::arg{"obs"}
+    )
+    .def(py::init([](const HistogramObserver& obs) -> Observer { return obs; }),
+        "Construct an Observer accumulating into *obs*.",
+        py::arg{"obs"}
+    )
+    .def(py::init([](const SurvivalObserver& obs) -> Observer { return obs; }),
+        "Construct an Observer accumulating into *obs*.",
+        py::arg{"obs"}
+    )
     .def("__call__",
         &Observer::operator(),
         "Call the observer function for states *qp* at time *t*.",
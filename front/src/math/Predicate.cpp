@@ -8,6 +8,7 @@
 
 #include <mfptlib/core/Types.hpp>
 #include <mfptlib/math/Predicate.hpp>
+#include <mfptlib/sys/System.hpp>
 
 namespace py = pybind11;
 
@@ -28,6 +29,131 @@ void class_predicate(pybind11::module& m)
         "Evaluate the predicate function for states *qp* at time *t*.",
         py::arg{"qp"},
         py::arg{"t"}
+    )
+    .def("__and__",
+        [](const Predicate& lhs, const Predicate& rhs) { return lhs && rhs; },
+        "Return a predicate that holds if both predicates hold.",
+        py::arg{"other"}
+    )
+    .def("__or__",
+        [](const Predicate& lhs, const Predicate& rhs) { return lhs || rhs; },
+        "Return a predicate that holds if either predicate holds.",
+        py::arg{"other"}
+    )
+    .def("__invert__",
+        [](const Predicate& pred) { return !pred; },
+        "Return a predicate that holds if this predicate does not hold."
+    );
+}
+
+
+void def_native_predicates(pybind11::module& m)
+{
+    m.def("coordinate_interval",
+        &coordinate_interval,
+        R"----(
+Return a predicate checking :math:`a \le x_j < b`
+for column :math:`j` of the states.
+
+Columns :math:`0, \dots, n - 1` contain the positions,
+columns :math:`n, \dots, 2n - 1` the momenta.
+
+:param column: The column :math:`j` of the states.
+:param lower: The lower bound :math:`a` (inclusive).
+:param upper: The upper bound :math:`b` (exclusive).
+        )----",
+        py::arg{"column"},
+        py::arg{"lower"},
+        py::arg{"upper"}
+    );
+
+    m.def("coordinate_box",
+        &coordinate_box,
+        R"----(
+Return a predicate checking :math:`\vec{a} \le \vec{q} < \vec{b}`
+element-wise for the positions :math:`\vec{q}`.
+
+:param lower: The lower corner :math:`\vec{a}` (inclusive).
+:param upper: The upper corner :math:`\vec{b}` (exclusive).
+        )----",
+        py::arg{"lower"},
+        py::arg{"upper"}
+    );
+
+    m.def("half_space",
+        &half_space,
+        R"----(
+Return a predicate checking :math:`\vec{n} \cdot \vec{q} < c`
+for the positions :math:`\vec{q}`.
+
+:param normal: The normal vector :math:`\vec{n}`.
+:param offset: The offset :math:`c`.
+        )----",
+        py::arg{"normal"},
+        py::arg{"offset"}
+    );
+
+    m.def("radial_distance",
+        &radial_distance,
+        R"----(
+Return a predicate checking :math:`a \le |\vec{q} - \vec{c}| < b`
+for the positions :math:`\vec{q}`.
+
+:param center: The center :math:`\vec{c}`.
+:param lower: The lower bound :math:`a` (inclusive).
+:param upper: The upper bound :math:`b` (exclusive).
+        )----",
+        py::arg{"center"},
+        py::arg{"lower"},
+        py::arg{"upper"}
+    );
+
+    m.def("angle_window",
+        &angle_window,
+        R"----(
+Return a predicate checking :math:`|q_j - c| < w`
+for a periodic angle :math:`q_j`.
+
+The difference is wrapped into the interval :math:`[-\pi, \pi]`.
+
+:param column: The index :math:`j` of the angle in the positions.
+:param center: The center :math:`c` of the window.
+:param half_width: The half width :math:`w` of the window.
+        )----",
+        py::arg{"column"},
+        py::arg{"center"},
+        py::arg{"half_width"}
+    );
+
+    m.def("potential_interval",
+        &potential_interval,
+        R"----(
+Return a predicate checking :math:`a \le V(\vec{q}, t) < b`.
+
+:param system: The system providing the potential :math:`V`.
+    Systems with parameters per state are not supported.
+:param lower: The lower bound :math:`a` (inclusive).
+:param upper: The upper bound :math:`b` (exclusive).
+        )----",
+        py::arg{"system"},
+        py::arg{"lower"},
+        py::arg{"upper"}
+    );
+
+    m.def("total_energy_interval",
+        &total_energy_interval,
+        R"----(
+Return a predicate checking :math:`a \le E(\vec{q}, \vec{p}, t) < b`
+for the total energy :math:`E`.
+
+:param system: The system providing the potential and the masses.
+    Systems with parameters per state are not supported.
+:param lower: The lower bound :math:`a` (inclusive).
+:param upper: The upper bound :math:`b` (exclusive).
+        )----",
+        py::arg{"system"},
+        py::arg{"lower"},
+        py::arg{"upper"}
     );
 }
 
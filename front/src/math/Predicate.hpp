@@ -11,6 +11,7 @@
 namespace mfptlib {
 
 void class_predicate(pybind11::module& m);
+void def_native_predicates(pybind11::module& m);
 
 } // namespace mfptlib
 
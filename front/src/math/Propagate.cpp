@@ -6,7 +6,10 @@
 
 #include <pybind11/eigen.h>
 
+#include <mfptlib/core/Ensemble.hpp>
+#include <mfptlib/core/Errors.hpp>
 #include <mfptlib/core/Types.hpp>
+#include <mfptlib/math/Dispatch.hpp>
 #include <mfptlib/math/Observer.hpp>
 #include <mfptlib/math/Predicate.hpp>
 #include <mfptlib/math/Stepper.hpp>
@@ -17,14 +20,136 @@ namespace py = pybind11;
 
 namespace mfptlib {
 
+namespace {
+
+void validate_columns(const Ensemble& ensemble, Index first, Index cols)
+{
+    expect(first >= ensemble.state_cols() and cols >= 0
+            and first + cols <= ensemble.data().cols(),
+        "The columns must be auxiliary columns of the ensemble.");
+}
+
+} // namespace
+
+
+void class_ensemble(pybind11::module& m)
+{
+    py::class_<Ensemble>{m, "Ensemble",
+        R"----(
+States of an ensemble together with auxiliary columns per state.
+
+The auxiliary columns, e.g., labels or parameters of the trajectories,
+are stored next to the states and follow them
+when :func:`propagate_while` reorders the states.
+During the propagation, the ensemble also holds per-state data
+of the stepper and the bath, which it removes again afterwards.
+Since its storage may thus be reallocated,
+the states and columns are returned as copies
+and written via :attr:`qp` and :meth:`set_columns`.
+        )----"
+    }
+    .def(py::init<Vectors>(),
+        "Construct an ensemble from the states *qp* without auxiliary columns.",
+        py::arg{"qp"}
+    )
+    .def("add_columns",
+        &Ensemble::add_columns,
+        R"----(
+Append *cols* auxiliary columns initialized to *value*.
+
+:returns: The index of the first new column.
+        )----",
+        py::arg{"cols"},
+        py::arg{"value"} = 0.0
+    )
+    .def_property_readonly("rows",
+        &Ensemble::rows,
+        "The number of states."
+    )
+    .def_property_readonly("state_cols",
+        &Ensemble::state_cols,
+        "The number of columns of the states."
+    )
+    .def_property("qp",
+        [](const Ensemble& self) -> Vectors { return self.states(); },
+        [](Ensemble& self, const VectorsCRef& qp)
+        {
+            expect(qp.rows() == self.rows() and qp.cols() == self.state_cols(),
+                "The shape of the states must not change.");
+            self.states() = qp;
+        },
+        "A copy of the states."
+    )
+    .def("columns",
+        [](const Ensemble& self, Index first, Index cols) -> Vectors
+        {
+            validate_columns(self, first, cols);
+            return self.columns(first, cols);
+        },
+        "A copy of *cols* auxiliary columns starting at *first*.",
+        py::arg{"first"},
+        py::arg{"cols"} = 1
+    )
+    .def("set_columns",
+        [](Ensemble& self, Index first, const VectorsCRef& values)
+        {
+            validate_columns(self, first, values.cols());
+            expect(values.rows() == self.rows(),
+                "The values must have one row per state.");
+            self.columns(first, values.cols()) = values;
+        },
+        "Overwrite the auxiliary columns starting at *first* with *values*.",
+        py::arg{"first"},
+        py::arg{"values"}
+    )
+    .def_property_readonly("data",
+        [](const Ensemble& self) -> Vectors { return self.data(); },
+        "A copy of the states followed by all auxiliary columns."
+    );
+}
+
+
+void enum_schedule(pybind11::module& m)
+{
+    py::enum_<Schedule>{m, "Schedule",
+        "Distribution of states among multiple threads."
+    }
+    .value("STATIC", Schedule::Static,
+        "Every thread propagates a fixed, contiguous block of states.")
+    .value("WORK_STEALING", Schedule::WorkStealing,
+        "Idle threads take over half of the active states of busy threads.");
+}
+
+
 void def_propagate_to(pybind11::module& m)
 {
     m.def("propagate_to",
-        &propagate_to,
+        [](
+            Stepper& stepper, Bath& bath, const System& system,
+            VectorsRef states, double t, double t_end,
+            const Observer& observe, Index threads,
+            Index tile_rows, Index tile_steps
+        ) -> double
+        {
+            const PropagateOptions options{
+                .num_threads = threads,
+                .tile_rows = tile_rows,
+                .tile_steps = tile_steps,
+            };
+            return propagate_to(
+                stepper, bath, system, states, t, t_end, observe, options);
+        },
         py::call_guard<py::gil_scoped_release>{},
         R"----(
 Propagate states *qp* of *system* from time *t* to *t_end*.
 
+If *threads* is larger than one or *tile_rows* is positive,
+the states are propagated in blocks
+using forked copies of *stepper* and *bath*
+as described for :func:`propagate_while`.
+Afterwards, their per-state data is joined back into *stepper* and *bath*,
+so that consecutive calls continue like on a single thread.
+
 :param stepper: The implementation of the integrator scheme.
 :param bath: The implementation of noise and friction from the surrounding bath.
 :param system: The physical system to propagate.
@@ -32,6 +157,9 @@ Propagate states *qp* of *system* from time *t* to *t_end*.
 :param t: The initial time.
 :param t_end: The target for the final time.
 :param observer: A callback being called before/after every integrator step.
+:param threads: The number of threads used for the propagation.
+:param tile_rows: The number of states per tile, 0 disables tiling.
+:param tile_steps: The number of steps a tile is advanced at once.
 :returns: The actual final time ≥ *t_end*.
     It may differ from *t_end* because of finite integrator steps.
         )----",
@@ -41,7 +169,10 @@ Propagate states *qp* of *system* from time *t* to *t_end*.
         py::arg{"qp"},
         py::arg{"t"},
         py::arg{"t_end"},
-        py::arg{"observer"} = Observer{}
+        py::arg{"observer"} = Observer{},
+        py::arg{"threads"} = 1,
+        py::arg{"tile_rows"} = 0,
+        py::arg{"tile_steps"} = 64
     );
 }
 
@@ -49,7 +180,23 @@ Propagate states *qp* of *system* from time *t* to *t_end*.
 void def_propagate_while(pybind11::module& m)
 {
     m.def("propagate_while",
-        &propagate_while,
+        [](
+            Stepper& stepper, Bath& bath, const System& system,
+            VectorsRef states, double t, const Predicate& predicate,
+            const Observer& observe, Index threads, Schedule schedule,
+            double compaction_threshold, Index tile_rows, Index tile_steps
+        ) -> Scalars
+        {
+            const PropagateOptions options{
+                .num_threads = threads,
+                .schedule = schedule,
+                .compaction_threshold = compaction_threshold,
+                .tile_rows = tile_rows,
+                .tile_steps = tile_steps,
+            };
+            return propagate_while(
+                stepper, bath, system, states, t, predicate, observe, options);
+        },
         py::call_guard<py::gil_scoped_release>{},
         R"----(
 Propagate states *qp* of *system* from time *t* while *predicate* holds true.
@@ -57,6 +204,30 @@ Propagate states *qp* of *system* from time *t* while *predicate* holds true.
 The *predicate* and the *observer* are only called with
 the subset of states that are still actively being propagated.
 
+If *threads* is larger than one,
+the states are split into contiguous blocks
+that are propagated concurrently
+using forked copies of *stepper* and *bath* (see :meth:`Bath.fork`).
+In this case, *predicate* and *observer* are called once per block
+and possibly from multiple threads at the same time.
+With :attr:`Schedule.WORK_STEALING`,
+threads that have finished their blocks
+take over half of the remaining states of busy threads.
+Since the random streams are forked whenever states change hands,
+results then depend on the timing of the threads.
+
+Stopped states are removed from the propagated block
+once the fraction of active states drops below *compaction_threshold*.
+Until then, they are masked out and restored to their final state later,
+which saves the cost of reordering states after every step.
+The active states are copied for *observer* in this case.
+
+If *tile_rows* is positive, the states are cut into tiles of that size
+with their own forked copies of *stepper* and *bath*.
+The tiles take turns advancing *tile_steps* steps,
+which keeps the working set of a tile in the CPU caches.
+Tiles are distributed among *threads* threads.
+
 :param stepper: The implementation of the integrator scheme.
 :param bath: The implementation of noise and friction from the surrounding bath.
 :param system: The physical system to propagate.
@@ -66,6 +237,12 @@ the subset of states that are still actively being propagated.
     which states should continue to propagate.
 :param observer: A callback being called before/after every integrator step
     with the actively propagating states.
+:param threads: The number of threads used for the propagation.
+:param schedule: How the states are distributed among the threads.
+:param compaction_threshold: The fraction of active states
+    below which stopped states are removed from the block.
+:param tile_rows: The number of states per tile, 0 disables tiling.
+:param tile_steps: The number of steps a tile is advanced at once.
 :returns: The final times of the states being propagated.
         )----",
         py::arg{"stepper"},
@@ -74,7 +251,74 @@ the subset of states that are still actively being propagated.
         py::arg{"qp"},
         py::arg{"t"},
         py::arg{"predicate"},
-        py::arg{"observer"} = Observer{}
+        py::arg{"observer"} = Observer{},
+        py::arg{"threads"} = 1,
+        py::arg{"schedule"} = Schedule::Static,
+        py::arg{"compaction_threshold"} = 1.0,
+        py::arg{"tile_rows"} = 0,
+        py::arg{"tile_steps"} = 64
+    );
+
+    m.def("propagate_while",
+        [](
+            Stepper& stepper, Bath& bath, const System& system,
+            Ensemble& ensemble, double t, const Predicate& predicate,
+            const Observer& observe, Index threads, Schedule schedule,
+            double compaction_threshold, Index tile_rows, Index tile_steps
+        ) -> Scalars
+        {
+            const PropagateOptions options{
+                .num_threads = threads,
+                .schedule = schedule,
+                .compaction_threshold = compaction_threshold,
+                .tile_rows = tile_rows,
+                .tile_steps = tile_steps,
+            };
+            return propagate_while(stepper, bath, system,
+                ensemble, t, predicate, observe, options);
+        },
+        py::call_guard<py::gil_scoped_release>{},
+        R"----(
+Propagate the states of *ensemble* from time *t* while *predicate* holds true.
+
+This works like the overload for plain states,
+but the auxiliary columns of *ensemble* are moved along with the states.
+*predicate* and *observer* only receive the states.
+        )----",
+        py::arg{"stepper"},
+        py::arg{"bath"},
+        py::arg{"system"},
+        py::arg{"ensemble"},
+        py::arg{"t"},
+        py::arg{"predicate"},
+        py::arg{"observer"} = Observer{},
+        py::arg{"threads"} = 1,
+        py::arg{"schedule"} = Schedule::Static,
+        py::arg{"compaction_threshold"} = 1.0,
+        py::arg{"tile_rows"} = 0,
+        py::arg{"tile_steps"} = 64
+    );
+}
+
+
+void def_has_static_kernel(pybind11::module& m)
+{
+    m.def("has_static_kernel",
+        &has_static_kernel,
+        R"----(
+Return whether a precompiled kernel exists for *stepper*, *bath*, and *system*.
+
+Single-threaded propagation without tiling or lazy compaction
+automatically uses these kernels for all combinations of the built-in
+steppers, baths, and systems, which avoids the overhead of type erasure.
+
+:param stepper: The implementation of the integrator scheme.
+:param bath: The implementation of noise and friction from the surrounding bath.
+:param system: The physical system to propagate.
+        )----",
+        py::arg{"stepper"},
+        py::arg{"bath"},
+        py::arg{"system"}
     );
 }
 
@@ -10,8 +10,11 @@
 
 namespace mfptlib {
 
+void class_ensemble(pybind11::module& m);
+void enum_schedule(pybind11::module& m);
 void def_propagate_to(pybind11::module& m);
 void def_propagate_while(pybind11::module& m);
+void def_has_static_kernel(pybind11::module& m);
 
 } // namespace mfptlib
 
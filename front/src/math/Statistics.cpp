@@ -0,0 +1,154 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Statistics.hpp"
+
+#include <pybind11/eigen.h>
+#include <pybind11/stl.h>
+
+#include <mfptlib/core/Types.hpp>
+#include <mfptlib/math/Observer.hpp>
+#include <mfptlib/math/Statistics.hpp>
+#include <mfptlib/sys/System.hpp>
+
+namespace py = pybind11;
+
+
+namespace mfptlib {
+
+void class_quantity(pybind11::module& m)
+{
+    py::class_<Quantity>{m, "Quantity",
+        "Per-state values accumulated by the native observers."
+    }
+    .def_static("coordinates",
+        &Quantity::coordinates,
+        "All columns of the states."
+    )
+    .def_static("coordinate",
+        &Quantity::coordinate,
+        "A single *column* of the states.",
+        py::arg{"column"}
+    )
+    .def_static("kinetic_energy",
+        &Quantity::kinetic_energy,
+        "The kinetic energy of the states in *system*.",
+        py::arg{"system"}
+    )
+    .def_static("potential",
+        &Quantity::potential,
+        "The potential energy of the states in *system*.",
+        py::arg{"system"}
+    )
+    .def_static("total_energy",
+        &Quantity::total_energy,
+        "The total energy of the states in *system*.",
+        py::arg{"system"}
+    );
+}
+
+
+void class_statistics(pybind11::module& m)
+{
+    py::class_<MomentsObserver>{m, "MomentsObserver",
+        R"----(
+Observer accumulating the running mean and variance of a quantity
+over all observed states and times.
+
+It can be passed as *observer* to :func:`propagate_while`
+and :func:`propagate_to` without calling back into Python.
+        )----"
+    }
+    .def(py::init<Quantity>(),
+        "Construct an empty accumulator for *quantity*.",
+        py::arg{"quantity"} = Quantity::coordinates()
+    )
+    .def_property_readonly("count",
+        &MomentsObserver::count,
+        "The number of accumulated values per column."
+    )
+    .def_property_readonly("mean",
+        &MomentsObserver::mean,
+        "The mean of every column."
+    )
+    .def_property_readonly("variance",
+        &MomentsObserver::variance,
+        "The unbiased sample variance of every column."
+    )
+    .def("reset",
+        &MomentsObserver::reset,
+        "Discard all accumulated values."
+    );
+
+    py::class_<HistogramObserver>{m, "HistogramObserver",
+        R"----(
+Observer accumulating a histogram of a scalar quantity
+over all observed states and times.
+
+Values outside of [*lower*, *upper*) are counted separately
+and NaNs are ignored.
+        )----"
+    }
+    .def(py::init<Quantity, double, double, Index>(),
+        "Construct an empty histogram with *bins* equally sized bins.",
+        py::arg{"quantity"},
+        py::arg{"lower"},
+        py::arg{"upper"},
+        py::arg{"bins"}
+    )
+    .def_property_readonly("edges",
+        &HistogramObserver::edges,
+        "The *bins* + 1 edges of the bins."
+    )
+    .def_property_readonly("counts",
+        &HistogramObserver::counts,
+        "The number of values in every bin."
+    )
+    .def_property_readonly("underflow",
+        &HistogramObserver::underflow,
+        "The number of values below *lower*."
+    )
+    .def_property_readonly("overflow",
+        &HistogramObserver::overflow,
+        "The number of values above or equal to *upper*."
+    )
+    .def("reset",
+        &HistogramObserver::reset,
+        "Discard all accumulated values."
+    );
+
+    py::class_<SurvivalObserver>{m, "SurvivalObserver",
+        R"----(
+Observer recording the number of actively propagated states over time.
+
+Observations of multiple threads at the same time are added up.
+        )----"
+    }
+    .def(py::init<>(),
+        "Construct an empty survival curve."
+    )
+    .def_property_readonly("times",
+        &SurvivalObserver::times,
+        "The distinct observation times in ascending order."
+    )
+    .def_property_readonly("counts",
+        &SurvivalObserver::counts,
+        "The number of observed states at every time."
+    )
+    .def("reset",
+        &SurvivalObserver::reset,
+        "Discard all accumulated values."
+    );
+
+    py::implicitly_convertible<MomentsObserver, Observer>();
+    py::implicitly_convertible<HistogramObserver, Observer>();
+    py::implicitly_convertible<SurvivalObserver, Observer>();
+
+    m.def("combine_observers",
+        &combine_observers,
+        "Return an Observer that calls all *observers* in order.",
+        py::arg{"observers"}
+    );
+}
+
+} // namespace mfptlib
@@ -0,0 +1,18 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef MFPTLIB_GLUE_MATH_STATISTICS_HPP
+#define MFPTLIB_GLUE_MATH_STATISTICS_HPP
+
+#include <pybind11/pybind11.h>
+
+
+namespace mfptlib {
+
+void class_quantity(pybind11::module& m);
+void class_statistics(pybind11::module& m);
+
+} // namespace mfptlib
+
+#endif
@@ -41,6 +41,15 @@ void class_stepper(pybind11::module& m)
     .def("reset",
         &Stepper::reset,
         "Reset internal state in preparation for a different ensemble."
+    )
+    .def("split_states",
+        &Stepper::split_states,
+        "Move the internal state of states [*first*, n) into a new stepper.",
+        py::arg{"first"}
+    )
+    .def("fork",
+        &Stepper::fork,
+        "Return an independent copy of the stepper without internal state."
     );
 }
 
@@ -58,6 +67,11 @@ can even be reproduced exactly,
 independent of the time step.
 Kinetic properties, however, exhibit much larger errors.
 
+For systems with velocity- and time-independent forces,
+:func:`propagate_to` and :func:`propagate_while` reuse the forces of a step
+at the start of the next step.
+Manual calls to :meth:`Stepper.step` always evaluate all forces.
+
 See [Leimk2015]_ and [Fass2018]_ for details about the BAOAB scheme.
 
 :param dt: The integration step size :math:`\Delta t`.
@@ -0,0 +1,68 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ExpressionSystem.hpp"
+
+#include <optional>
+#include <string>
+#include <utility>
+
+#include <pybind11/eigen.h>
+#include <pybind11/stl.h>
+
+#include <mfptlib/core/Types.hpp>
+#include <mfptlib/sys/ExpressionSystem.hpp>
+#include <mfptlib/sys/System.hpp>
+
+namespace py = pybind11;
+
+
+namespace mfptlib {
+
+void def_expression_system(pybind11::module& m)
+{
+    m.def("expression_system",
+        [](
+            std::string expression,
+            Vector masses,
+            std::optional<ExpressionSystem::Parameters> parameters
+        ) -> System
+        {
+            return System{ExpressionSystem{
+                std::move(expression),
+                std::move(masses),
+                parameters.value_or(ExpressionSystem::Parameters{}),
+            }};
+        },
+        R"----(
+Return a system with a potential given by a mathematical expression.
+
+The expression may use the positions ``q0``, ``q1``, …, the time ``t``,
+the constants ``pi`` and ``e``, the names in *parameters*, numbers,
+the operators ``+ - * /`` and ``^`` or ``**`` for powers, and the functions
+``sin``, ``cos``, ``tan``, ``sinh``, ``cosh``, ``tanh``, ``atan``, ``exp``,
+``log``, ``sqrt``, ``abs``, and ``pow(x, y)``.
+
+The expression is compiled once and evaluated natively for whole ensembles.
+Forces are obtained by automatic differentiation.
+
+.. code-block:: python
+
+    mfptlib.expression_system(
+        '0.5 * k * q0^2 + a * cos(q1)',
+        masses=[1.0, 1.0],
+        parameters={'k': 2.0, 'a': 0.5},
+    )
+
+:param expression: The potential :math:`V(\vec{q}, t)`.
+:param masses: The :math:`n` masses corresponding to each dimension.
+:param parameters: Named constants used in the expression.
+        )----",
+        py::arg{"expression"},
+        py::kw_only{},
+        py::arg{"masses"},
+        py::arg{"parameters"} = py::none{}
+    );
+}
+
+} // namespace mfptlib
@@ -0,0 +1,91 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include "GridSystem.hpp"
+#include "System.hpp"
+
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include <pybind11/eigen.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+
+#include <mfptlib/core/Types.hpp>
+#include <mfptlib/sys/GridSystem.hpp>
+#include <mfptlib/sys/System.hpp>
+
+namespace py = pybind11;
+
+
+namespace mfptlib {
+
+namespace {
+
+using GridArray =
+    py::array_t<double, py::array::c_style | py::array::forcecast>;
+
+} // namespace
+
+
+void def_grid_system(pybind11::module& m)
+{
+    m.def("grid_system",
+        [](
+            const GridArray& values,
+            Vector lower,
+            Vector upper,
+            Vector masses,
+            std::optional<Booleans> periodic
+        ) -> System
+        {
+            Indices shape{values.ndim()};
+            for(Index axis = 0; axis < shape.size(); ++axis)
+                shape[axis] = values.shape(axis);
+
+            return System{GridSystem{
+                std::shared_ptr<const double[]>{
+                    keep_alive(values), values.data()},
+                std::move(shape),
+                std::move(lower),
+                std::move(upper),
+                std::move(masses),
+                periodic.value_or(Booleans{}),
+            }};
+        },
+        R"----(
+Return a system with a potential interpolated from values on a regular grid.
+
+The :math:`n`-dimensional array *values* contains the potential at
+``values.shape[d]`` equidistant points along every axis :math:`d`.
+For non-periodic axes, the first and last point lie on ``lower[d]`` and
+``upper[d]``. For periodic axes, ``upper[d]`` is identified with
+``lower[d]`` and therefore not part of the grid.
+
+The potential and forces are evaluated by tensor-product Catmull-Rom
+interpolation, which is continuously differentiable and exact for quadratic
+polynomials away from non-periodic boundaries. Beyond non-periodic
+boundaries, the potential is continued as a constant.
+
+C-contiguous ``float64`` arrays are shared without copying them, so they
+must not be modified while the system is in use.
+Other arrays are converted first.
+
+:param values: The potential on the grid with up to 8 dimensions.
+:param lower: The :math:`n` lower bounds of the grid.
+:param upper: The :math:`n` upper bounds of the grid.
+:param masses: The :math:`n` masses corresponding to each dimension.
+:param periodic: The :math:`n` flags for periodic axes,
+    all axes are non-periodic by default.
+        )----",
+        py::arg{"values"},
+        py::kw_only{},
+        py::arg{"lower"},
+        py::arg{"upper"},
+        py::arg{"masses"},
+        py::arg{"periodic"} = py::none{}
+    );
+}
+
+} // namespace mfptlib
@@ -38,6 +38,25 @@ Return a test system with a potential given by :math:`n` harmonic oscillators.
         py::arg{"strengths"}
     );
 
+    m.def("harmonic_oscillator",
+        [](Vector masses, Vectors strengths) -> System
+        {
+            return System{HarmonicOscillator::per_state(
+                std::move(masses), std::move(strengths))};
+        },
+        R"----(
+Return harmonic oscillators with strengths per state.
+
+The :math:`i`-th state of the ensemble uses the :math:`i`-th row of the
+strengths, which follows its state during propagation.
+
+:param masses: The :math:`n` masses corresponding to each dimension.
+:param strengths: The strengths with one row per state and :math:`n` columns.
+        )----",
+        py::arg{"masses"},
+        py::arg{"strengths"}
+    );
+
 }
 
 } // namespace mfptlib
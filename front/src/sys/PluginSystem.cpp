@@ -0,0 +1,135 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include "PluginSystem.hpp"
+#include "System.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+#include <pybind11/eigen.h>
+#include <pybind11/stl.h>
+#include <pybind11/stl/filesystem.h>
+
+#include <mfptlib/core/Types.hpp>
+#include <mfptlib/sys/Plugin.h>
+#include <mfptlib/sys/PluginSystem.hpp>
+#include <mfptlib/sys/System.hpp>
+
+namespace py = pybind11;
+
+
+namespace mfptlib {
+
+namespace {
+
+// Address of a numba cfunc, ctypes function pointer, or plain integer.
+auto address_of(const py::object& obj) -> std::uintptr_t
+{
+    if(obj.is_none())
+        return 0;
+    if(py::hasattr(obj, "address"))
+        return obj.attr("address").cast<std::uintptr_t>();
+    if(py::isinstance<py::int_>(obj))
+        return obj.cast<std::uintptr_t>();
+
+    const py::module_ ctypes = py::module_::import("ctypes");
+    const py::object ptr = ctypes.attr("cast")(obj, ctypes.attr("c_void_p"));
+    return ptr.attr("value").cast<std::uintptr_t>();
+}
+
+
+template<typename Func>
+auto function_from(const py::object& obj) -> Func*
+{ return reinterpret_cast<Func*>(address_of(obj)); }
+
+} // namespace
+
+
+void def_plugin_system(pybind11::module& m)
+{
+    m.def("plugin_system",
+        [](const std::filesystem::path& library, const std::string& options)
+            -> System
+            { return System{PluginSystem::load(library, options)}; },
+        R"----(
+Return a system implemented by a plugin library.
+
+The shared library must export ``mfptlib_plugin_init`` following the C ABI
+defined in ``mfptlib/sys/Plugin.h``. The plugin is called on whole ensembles
+without holding the GIL.
+
+:param library: Path of the shared library.
+:param options: String passed to ``mfptlib_plugin_init``.
+        )----",
+        py::arg{"library"},
+        py::arg{"options"} = std::string{}
+    );
+
+    m.def("function_system",
+        [](
+            const py::object& potential,
+            const py::object& force,
+            Vector masses,
+            const py::object& energy_and_force,
+            const py::object& context
+        ) -> System
+        {
+            const Index dofs = masses.size();
+            const mfptlib_plugin plugin{
+                .abi_version = MFPTLIB_PLUGIN_ABI_VERSION,
+                .context = reinterpret_cast<void*>(address_of(context)),
+                .degrees_of_freedom = dofs,
+                .potential = function_from<mfptlib_potential_fn>(potential),
+                .force = function_from<mfptlib_force_fn>(force),
+                .energy_and_force = function_from<mfptlib_energy_and_force_fn>(
+                    energy_and_force),
+                .masses = nullptr,
+                .constant_masses = masses.data(),
+                .release = nullptr,
+            };
+
+            return System{PluginSystem{
+                plugin,
+                keep_alive(py::make_tuple(
+                    potential, force, energy_and_force, context)),
+            }};
+        },
+        R"----(
+Return a system implemented by native functions, e.g., numba cfuncs.
+
+The functions follow the C ABI defined in ``mfptlib/sys/Plugin.h`` and are
+called on whole ensembles without holding the GIL. They may be given as
+numba cfuncs, ctypes function pointers, or integer addresses. For example,
+the potential has the numba signature
+
+.. code-block:: python
+
+    numba.types.void(
+        numba.types.voidptr,                    # context
+        numba.types.int64,                      # number of states
+        numba.types.CPointer(numba.types.float64),  # states
+        numba.types.int64,                      # column stride of states
+        numba.types.float64,                    # time
+        numba.types.CPointer(numba.types.float64),  # potential output
+    )
+
+The force function additionally receives the column stride of its output.
+
+:param potential: Function evaluating the potential.
+:param force: Function evaluating the forces.
+:param masses: The :math:`n` masses corresponding to each dimension.
+:param energy_and_force: Optional function evaluating both at once.
+:param context: Optional address passed to all functions.
+        )----",
+        py::arg{"potential"},
+        py::arg{"force"},
+        py::kw_only{},
+        py::arg{"masses"},
+        py::arg{"energy_and_force"} = py::none{},
+        py::arg{"context"} = py::none{}
+    );
+}
+
+} // namespace mfptlib
@@ -0,0 +1,243 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#include "PythonSystem.hpp"
+
+#include <cassert>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <pybind11/eigen.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+
+#include <mfptlib/core/Errors.hpp>
+#include <mfptlib/core/Types.hpp>
+#include <mfptlib/sys/System.hpp>
+
+namespace py = pybind11;
+
+
+namespace mfptlib {
+
+namespace {
+
+struct Callbacks
+{
+    py::object potential;
+    py::object force;
+    py::object energy_and_force; // None if not provided.
+    py::object masses; // None if the masses are constant.
+};
+
+
+// System calling vectorized Python functions on whole ensembles.
+// Each call acquires the GIL once, constant masses do not need it at all.
+class PythonSystem
+{
+public:
+    explicit PythonSystem(Callbacks callbacks, Vector masses, Index dofs)
+        : callbacks_{
+            new Callbacks{std::move(callbacks)},
+            [](const Callbacks* ptr)
+            {
+                // Systems may be released without holding the GIL.
+                py::gil_scoped_acquire gil;
+                delete ptr;
+            }}
+        , masses_{std::move(masses)}
+        , dofs_{dofs}
+    {
+        expect(dofs_ > 0, "The system must have at least one DoF.");
+        expect(masses_.size() == 0 or masses_.size() == dofs_,
+            "The number of masses must match the number of DoFs.");
+    }
+
+
+    auto callbacks() const noexcept -> const Callbacks&
+    { return *callbacks_; }
+
+    // Empty if the masses are computed by a callback.
+    auto constant_masses() const noexcept -> const Vector&
+    { return masses_; }
+
+    auto dofs() const noexcept -> Index
+    { return dofs_; }
+
+
+private:
+    std::shared_ptr<const Callbacks> callbacks_;
+    Vector masses_;
+    Index dofs_;
+};
+
+
+using ResultMap = Eigen::Map<
+    const Vectors, 0, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>>;
+
+
+// Copy the array returned by a callback to out, which has its expected size.
+template<typename Out>
+void read_result(const py::handle& result, Out&& out, const char* name)
+{
+    constexpr bool is_column = std::decay_t<Out>::ColsAtCompileTime == 1;
+    const auto arr = py::array_t<double, py::array::forcecast>::ensure(result);
+    expect(arr and arr.ndim() == (is_column ? 1 : 2)
+        and arr.shape(0) == out.rows()
+        and (is_column or arr.shape(1) == out.cols()),
+        std::string{name} + " returned an array of the wrong shape.");
+
+    constexpr auto size = static_cast<py::ssize_t>(sizeof(double));
+    out = ResultMap{arr.data(), out.rows(), out.cols(), {
+        is_column ? 0 : arr.strides(1) / size, arr.strides(0) / size}};
+}
+
+
+[[nodiscard]]
+auto degrees_of_freedom(const PythonSystem& model) noexcept -> Index
+{ return model.dofs(); }
+
+// Nothing is known about the callbacks except whether masses are constant.
+[[nodiscard]]
+auto traits(const PythonSystem& model) noexcept -> SystemTraits
+{ return {.constant_masses = model.constant_masses().size() != 0}; }
+
+
+void potential_into(
+    const PythonSystem& model,
+    const VectorsCRef& states,
+    double t,
+    ScalarsRef out
+)
+{
+    py::gil_scoped_acquire gil;
+    read_result(model.callbacks().potential(states, t), out, "potential");
+}
+
+
+void force_into(
+    const PythonSystem& model,
+    const VectorsCRef& states,
+    double t,
+    VectorsRef out
+)
+{
+    py::gil_scoped_acquire gil;
+    read_result(model.callbacks().force(states, t), out, "force");
+}
+
+
+void energy_and_force_into(
+    const PythonSystem& model,
+    const VectorsCRef& states,
+    double t,
+    ScalarsRef potential_out,
+    VectorsRef force_out
+)
+{
+    py::gil_scoped_acquire gil;
+    const Callbacks& callbacks = model.callbacks();
+
+    if(callbacks.energy_and_force.is_none())
+    {
+        read_result(callbacks.potential(states, t), potential_out,
+            "potential");
+        read_result(callbacks.force(states, t), force_out, "force");
+        return;
+    }
+
+    const auto res = callbacks.energy_and_force(states, t)
+        .cast<std::pair<py::object, py::object>>();
+    read_result(res.first, potential_out, "energy_and_force");
+    read_result(res.second, force_out, "energy_and_force");
+}
+
+
+void masses_into(
+    const PythonSystem& model,
+    [[maybe_unused]] const VectorsCRef& states,
+    VectorsRef out
+)
+{
+    assert(states.cols() == 2 * model.dofs());
+    if(model.constant_masses().size() != 0)
+    {
+        out.rowwise() = model.constant_masses();
+        return;
+    }
+
+    py::gil_scoped_acquire gil;
+    read_result(model.callbacks().masses(states), out, "masses");
+}
+
+} // namespace
+
+
+void def_python_system(pybind11::module& m)
+{
+    m.def("python_system",
+        [](
+            py::object potential,
+            py::object force,
+            py::object masses,
+            py::object energy_and_force,
+            std::optional<Index> dofs
+        ) -> System
+        {
+            Vector constant_masses;
+            if(!py::isinstance<py::function>(masses))
+            {
+                constant_masses = masses.cast<Vector>();
+                dofs = dofs.value_or(constant_masses.size());
+                masses = py::none{};
+            }
+            expect(dofs.has_value(),
+                "The number of DoFs is required for callable masses.");
+
+            return System{PythonSystem{
+                Callbacks{
+                    .potential = std::move(potential),
+                    .force = std::move(force),
+                    .energy_and_force = std::move(energy_and_force),
+                    .masses = std::move(masses),
+                },
+                std::move(constant_masses),
+                *dofs,
+            }};
+        },
+        R"----(
+Return a system implemented by vectorized Python functions.
+
+The functions are called with read-only views of the states *qp* of the
+whole ensemble and the time *t*:
+
+- ``potential(qp, t)`` returns the :math:`m` potential energies.
+- ``force(qp, t)`` returns the :math:`m \times n` forces.
+- ``energy_and_force(qp, t)``, if given, returns both at once.
+- ``masses(qp)`` returns the :math:`m \times n` masses if *masses* is
+  callable.
+
+Constant masses are passed as an array of :math:`n` values and do not
+require calling into Python, so each force evaluation acquires the GIL only
+once.
+
+:param potential: Function returning the potential energy.
+:param force: Function returning the forces.
+:param masses: The :math:`n` masses or a function returning them.
+:param energy_and_force: Optional function returning both potential energy
+    and forces.
+:param dofs: Number of degrees of freedom, required for callable *masses*.
+        )----",
+        py::arg{"potential"},
+        py::arg{"force"},
+        py::kw_only{},
+        py::arg{"masses"},
+        py::arg{"energy_and_force"} = py::none{},
+        py::arg{"dofs"} = py::none{}
+    );
+}
+
+} // namespace mfptlib
@@ -0,0 +1,17 @@
+// Copyright 2022 Johannes Reiff
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef MFPTLIB_GLUE_SYS_PYTHONSYSTEM_HPP
+#define MFPTLIB_GLUE_SYS_PYTHONSYSTEM_HPP
+
+#include <pybind11/pybind11.h>
+
+
+namespace mfptlib {
+
+void def_python_system(pybind11::module& m);
+
+} // namespace mfptlib
+
+#endif
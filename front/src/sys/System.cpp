@@ -3,6 +3,9 @@
 
 #include "System.hpp"
 
+#include <memory>
+#include <utility>
+
 #include <pybind11/eigen.h>
 
 #include <mfptlib/core/Types.hpp>
@@ -45,6 +48,19 @@ void class_system(pybind11::module& m)
             py::arg{"qp"},
             py::arg{"t"}
         )
+        .def("energy_and_force",
+            [](const System& sys, const VectorsCRef& qp, double t)
+                -> std::pair<Scalars, Vectors>
+                { return energy_and_force(sys, qp, t); },
+            R"----(
+Return the potential energy and the forces for states *qp* at time *t*.
+
+This is faster than calling :meth:`potential` and :meth:`force` separately
+for systems that share intermediate results, e.g., :func:`lithium_cyanide`.
+            )----",
+            py::arg{"qp"},
+            py::arg{"t"}
+        )
         .def("masses",
             [](const System& sys, const VectorsCRef& qp) -> Vectors
                 { return masses(sys, qp); },
@@ -58,4 +74,17 @@ void class_system(pybind11::module& m)
         );
 }
 
+
+auto keep_alive(pybind11::object obj) -> std::shared_ptr<const void>
+{
+    return std::shared_ptr<const void>{
+        obj.release().ptr(),
+        [](const void* ptr)
+        {
+            py::gil_scoped_acquire gil;
+            Py_DECREF(static_cast<PyObject*>(const_cast<void*>(ptr)));
+        },
+    };
+}
+
 } // namespace mfptlib
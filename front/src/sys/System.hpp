@@ -5,6 +5,8 @@
 #ifndef MFPTLIB_GLUE_SYS_SYSTEM_HPP
 #define MFPTLIB_GLUE_SYS_SYSTEM_HPP
 
+#include <memory>
+
 #include <pybind11/pybind11.h>
 
 
@@ -12,6 +14,10 @@ namespace mfptlib {
 
 void class_system(pybind11::module& m);
 
+// Keep obj alive as long as the returned pointer is used, e.g., by systems
+// sharing its memory. It may be released without holding the GIL.
+auto keep_alive(pybind11::object obj) -> std::shared_ptr<const void>;
+
 } // namespace mfptlib
 
 #endif
@@ -0,0 +1,118 @@
+# Copyright 2022 Johannes Reiff
+# SPDX-License-Identifier: Apache-2.0
+
+import numpy as np
+import pytest
+
+import mfptlib
+
+
+TIME_STEP = 1e-2
+ENSEMBLE_SIZE = 512
+SYSTEM = mfptlib.harmonic_oscillator(masses=[1.0, 2.0], strengths=[1.0, 0.5])
+QUANTITIES = {
+    'kinetic_energy': (mfptlib.Quantity.kinetic_energy(SYSTEM),
+        SYSTEM.kinetic_energy),
+    'potential': (mfptlib.Quantity.potential(SYSTEM),
+        lambda qp: SYSTEM.potential(qp, 0.0)),
+    'total_energy': (mfptlib.Quantity.total_energy(SYSTEM),
+        lambda qp: SYSTEM.total_energy(qp, 0.0)),
+}
+
+
+def random_states(size=ENSEMBLE_SIZE, seed=42):
+    return mfptlib.random_gen(seed).normal(size=(size, 4))
+
+
+def test_python_observer():
+    calls = []
+    observe = mfptlib.Observer(lambda qp, t: calls.append((qp.shape, t)))
+    observe(random_states(3), 1.5)
+    assert calls == [((3, 4), 1.5)]
+
+
+def test_moments_observer_coordinates():
+    qp = random_states()
+    moments = mfptlib.MomentsObserver()
+    observe = mfptlib.Observer(moments)
+    observe(qp[:100], 0.0)
+    observe(qp[100:], 1.0)
+
+    assert moments.count == ENSEMBLE_SIZE
+    assert moments.mean == pytest.approx(np.mean(qp, axis=0))
+    assert moments.variance == pytest.approx(np.var(qp, axis=0, ddof=1))
+
+    moments.reset()
+    assert moments.count == 0
+
+
+@pytest.mark.parametrize(['quantity', 'expected'],
+    QUANTITIES.values(), ids=QUANTITIES.keys())
+def test_moments_observer_energies(quantity, expected):
+    qp = random_states()
+    moments = mfptlib.MomentsObserver(quantity)
+    observe = mfptlib.Observer(moments)
+    # Changing numbers of states reuse the buffers of the observer.
+    observe(qp, 0.0)
+    observe(qp[:10], 0.0)
+    observe(qp[10:], 0.0)
+
+    values = np.concatenate([expected(qp), expected(qp)])
+    assert moments.count == values.size
+    assert moments.mean == pytest.approx([np.mean(values)])
+    assert moments.variance == pytest.approx([np.var(values, ddof=1)])
+
+
+def test_histogram_observer():
+    qp = random_states()
+    histogram = mfptlib.HistogramObserver(
+        mfptlib.Quantity.coordinate(0), -1.0, 1.0, 8)
+    mfptlib.Observer(histogram)(qp, 0.0)
+
+    counts, edges = np.histogram(qp[:, 0], bins=8, range=(-1.0, 1.0))
+    assert histogram.edges == pytest.approx(edges)
+    assert np.all(histogram.counts == counts)
+    assert histogram.underflow == np.count_nonzero(qp[:, 0] < -1.0)
+    assert histogram.overflow == np.count_nonzero(qp[:, 0] >= 1.0)
+
+    with pytest.raises(ValueError):
+        mfptlib.HistogramObserver(mfptlib.Quantity.coordinates(), 0.0, 1.0, 8)
+
+
+def test_survival_observer():
+    survival = mfptlib.SurvivalObserver()
+    observe = mfptlib.Observer(survival)
+    observe(random_states(5), 1.0)
+    observe(random_states(3), 0.0)
+    observe(random_states(2), 1.0)
+
+    assert survival.times == pytest.approx([0.0, 1.0])
+    assert np.all(survival.counts == [3, 7])
+
+
+@pytest.mark.parametrize('threads', [1, 4])
+def test_energy_observers_during_propagation(threads):
+    qp = random_states()
+    moments = mfptlib.MomentsObserver(mfptlib.Quantity.total_energy(SYSTEM))
+    histogram = mfptlib.HistogramObserver(
+        mfptlib.Quantity.kinetic_energy(SYSTEM), 0.0, 10.0, 20)
+    energies = []
+    observe = mfptlib.combine_observers([
+        mfptlib.Observer(moments),
+        mfptlib.Observer(histogram),
+        mfptlib.Observer(lambda qp, t: energies.append(
+            (SYSTEM.total_energy(qp, t), SYSTEM.kinetic_energy(qp)))),
+    ])
+
+    stepper = mfptlib.baoab_stepper(TIME_STEP)
+    bath = mfptlib.langevin_bath(1.0, 0.5, 42)
+    mfptlib.propagate_to(stepper, bath, SYSTEM, qp, 0.0, 10 * TIME_STEP,
+        observer=observe, threads=threads)
+
+    total = np.concatenate([total for total, _ in energies])
+    kinetic = np.concatenate([kinetic for _, kinetic in energies])
+    assert moments.count == total.size
+    assert moments.mean == pytest.approx([np.mean(total)])
+    counts, _ = np.histogram(kinetic, bins=20, range=(0.0, 10.0))
+    assert np.all(histogram.counts == counts)
+    assert histogram.overflow == np.count_nonzero(kinetic >= 10.0)
@@ -0,0 +1,67 @@
+# Copyright 2022 Johannes Reiff
+# SPDX-License-Identifier: Apache-2.0
+
+import numpy as np
+import pytest
+
+import mfptlib
+
+
+TIME_STEP = 1e-2
+ENSEMBLE_SIZE = 256
+SYSTEM = mfptlib.harmonic_oscillator(masses=[1.0, 1.0], strengths=[1.0, 0.5])
+
+
+def test_ensemble_columns():
+    qp = np.zeros((ENSEMBLE_SIZE, 4))
+    ensemble = mfptlib.Ensemble(qp)
+    labels = ensemble.add_columns(1)
+    weights = ensemble.add_columns(2, 0.5)
+
+    assert ensemble.rows == ENSEMBLE_SIZE
+    assert ensemble.state_cols == 4
+    assert (labels, weights) == (4, 5)
+    assert ensemble.data.shape == (ENSEMBLE_SIZE, 7)
+    assert np.all(ensemble.columns(weights, 2) == 0.5)
+
+    ensemble.set_columns(labels, np.arange(ENSEMBLE_SIZE)[:, np.newaxis])
+    assert np.all(ensemble.data[:, labels] == np.arange(ENSEMBLE_SIZE))
+
+    # Copies stay valid when the ensemble grows.
+    qp = ensemble.qp
+    ensemble.add_columns(1)
+    ensemble.qp = qp + 1.0
+    assert np.all(qp == 0.0)
+    assert np.all(ensemble.qp == 1.0)
+
+    with pytest.raises(ValueError):
+        ensemble.columns(0, 1)
+    with pytest.raises(ValueError):
+        ensemble.set_columns(labels, np.zeros((ENSEMBLE_SIZE, 4)))
+    with pytest.raises(ValueError):
+        ensemble.add_columns(-1)
+
+
+@pytest.mark.parametrize('options', [
+    {},
+    {'compaction_threshold': 0.5},
+    {'threads': 2, 'schedule': mfptlib.Schedule.WORK_STEALING},
+])
+def test_ensemble_propagate_while(options):
+    rng = np.random.default_rng(42)
+    qp = np.zeros((ENSEMBLE_SIZE, 4))
+    qp[:, :2] = rng.uniform(-0.5, 0.5, (ENSEMBLE_SIZE, 2))
+
+    ensemble = mfptlib.Ensemble(qp)
+    labels = ensemble.add_columns(1)
+    ensemble.set_columns(labels, np.arange(ENSEMBLE_SIZE)[:, np.newaxis])
+
+    stepper = mfptlib.baoab_stepper(TIME_STEP)
+    bath = mfptlib.langevin_bath(1.0, 0.5, 42)
+    predicate = mfptlib.coordinate_interval(0, -1.0, 1.0)
+    t_end = mfptlib.propagate_while(
+        stepper, bath, SYSTEM, ensemble, 0.0, predicate, **options)
+
+    assert t_end.shape == (ENSEMBLE_SIZE,)
+    assert np.all(ensemble.columns(labels)[:, 0] == np.arange(ENSEMBLE_SIZE))
+    assert np.all(np.abs(ensemble.qp[:, 0]) >= 1.0)
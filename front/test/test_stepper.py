@@ -40,6 +40,97 @@ def test_temperature_gle(stepper):
     assert avrg_estimate == pytest.approx(KB_T, rel=0.01)
 
 
+@pytest.mark.parametrize(['stepper'], STEPPERS.values(), ids=STEPPERS.keys())
+def test_temperature_prony_gle(stepper):
+    bath = mfptlib.prony_memory_bath(
+        KB_T, [0.5 * FRICTION, 0.5 * FRICTION], [MEMORY, 0.1 * MEMORY],
+        BATH_SEED)
+    fit_estimate, avrg_estimate = estimate_kb_t(stepper, bath)
+    assert fit_estimate == pytest.approx(KB_T, rel=0.01)
+    assert avrg_estimate == pytest.approx(KB_T, rel=0.01)
+
+
+def test_temperature_tabulated_gle():
+    stepper = mfptlib.baoab_stepper(TIME_STEP)
+    tau = 0.01
+    times = np.arange(int(10 * tau / TIME_STEP)) * TIME_STEP
+    kernel = FRICTION / tau * np.exp(-times / tau)
+    bath = mfptlib.tabulated_memory_bath(KB_T, kernel, TIME_STEP, BATH_SEED)
+    fit_estimate, avrg_estimate = estimate_kb_t(stepper, bath)
+    assert fit_estimate == pytest.approx(KB_T, rel=0.01)
+    assert avrg_estimate == pytest.approx(KB_T, rel=0.01)
+
+
+@pytest.mark.parametrize(['stepper'], STEPPERS.values(), ids=STEPPERS.keys())
+def test_temperature_scalar_noise(stepper):
+    bath = mfptlib.langevin_bath(
+        KB_T, FRICTION, BATH_SEED, noise=mfptlib.NoiseGenerator.SCALAR)
+    fit_estimate, avrg_estimate = estimate_kb_t(stepper, bath)
+    assert fit_estimate == pytest.approx(KB_T, rel=0.01)
+    assert avrg_estimate == pytest.approx(KB_T, rel=0.01)
+
+
+@pytest.mark.parametrize(['stepper'], STEPPERS.values(), ids=STEPPERS.keys())
+def test_temperature_counter_noise(stepper):
+    bath = mfptlib.langevin_bath(
+        KB_T, FRICTION, BATH_SEED, noise=mfptlib.NoiseGenerator.COUNTER)
+    fit_estimate, avrg_estimate = estimate_kb_t(stepper, bath)
+    assert fit_estimate == pytest.approx(KB_T, rel=0.01)
+    assert avrg_estimate == pytest.approx(KB_T, rel=0.01)
+
+
+def test_replayed_noise():
+    stepper = mfptlib.baoab_stepper(TIME_STEP)
+    replay = np.random.default_rng(BATH_SEED).standard_normal((16, 2 * 20))
+    results = []
+    for _ in range(2):
+        bath = mfptlib.langevin_bath(KB_T, FRICTION, 0, replay=replay)
+        qp = np.zeros((16, 4), order='F')
+        mfptlib.propagate_to(stepper, bath, SYSTEM, qp, 0.0, 10 * TIME_STEP)
+        results.append(qp)
+    np.testing.assert_array_equal(results[0], results[1])
+    assert np.all(results[0][:, 2:] != 0.0)
+
+
+def test_prefetched_noise():
+    stepper = mfptlib.baoab_stepper(TIME_STEP)
+    results = []
+    for prefetch in [False, True]:
+        bath = mfptlib.langevin_bath(
+            KB_T, FRICTION, BATH_SEED, prefetch=prefetch)
+        qp = np.zeros((ENSEMBLE_SIZE, 4), order='F')
+        mfptlib.propagate_to(stepper, bath, SYSTEM, qp, 0.0, 1.0)
+        results.append(qp)
+    np.testing.assert_array_equal(results[0], results[1])
+
+
+def test_parameter_sweep():
+    stepper = mfptlib.baoab_stepper(TIME_STEP)
+    kb_t = np.tile([KB_T, 2 * KB_T], ENSEMBLE_SIZE)
+    strengths = np.repeat([[1.0, 1.0], [4.0, 4.0]], ENSEMBLE_SIZE, axis=0)
+    system = mfptlib.harmonic_oscillator([2.0, 2.0], strengths)
+    bath = mfptlib.langevin_bath(kb_t, np.ones_like(kb_t), BATH_SEED)
+    qp = np.zeros((2 * ENSEMBLE_SIZE, 4), order='F')
+    mfptlib.propagate_to(stepper, bath, system, qp, 0.0, 20.0)
+
+    for kb_t_i in [KB_T, 2 * KB_T]:
+        for strength in [1.0, 4.0]:
+            mask = (kb_t == kb_t_i) & (strengths[:, 0] == strength)
+            assert np.mean(qp[mask, 2:]**2) / 2.0 == pytest.approx(
+                kb_t_i, rel=0.15)
+            assert np.mean(qp[mask, :2]**2) * strength == pytest.approx(
+                kb_t_i, rel=0.15)
+
+
+def test_parameter_sweep_energy_predicates():
+    strengths = np.ones((ENSEMBLE_SIZE, 2))
+    system = mfptlib.harmonic_oscillator([2.0, 2.0], strengths)
+    with pytest.raises(ValueError):
+        mfptlib.potential_interval(system, 0.0, 1.0)
+    with pytest.raises(ValueError):
+        mfptlib.Quantity.total_energy(system)
+
+
 def estimate_kb_t(stepper, bath):
     estimates = np.array([
         sample_kb_t(stepper, bath) for _ in range(NUM_ENSEMBLES)
@@ -1,6 +1,8 @@
 # Copyright 2022 Johannes Reiff
 # SPDX-License-Identifier: Apache-2.0
 
+import ctypes
+
 import numpy as np
 import pytest
 
@@ -22,6 +24,14 @@
         mfptlib.harmonic_oscillator(masses=[1.0, 2.0], strengths=[1.0, 1.5]),
         [(-1.0, +1.0), (-1.0, +1.0)],
     ),
+    'ExpressionSystem': (
+        mfptlib.expression_system(
+            'a * cos(q0) * exp(-q1^2) + 0.5 * q1**2',
+            masses=[1.0, 2.0],
+            parameters={'a': 0.3},
+        ),
+        [(-1.0, +1.0), (-1.0, +1.0)],
+    ),
     'LithiumCyanide': (
         mfptlib.lithium_cyanide(),
         [(0.0, np.pi), (3.0, 5.5)],
@@ -39,6 +49,15 @@ def test_force(sys, extent):
     assert np.abs(analytical - numerical).max() <= GRAD_TOLERANCE
 
 
+@pytest.mark.parametrize(['sys', 'extent'], SYSTEMS.values(), ids=SYSTEMS.keys())
+def test_energy_and_force(sys, extent):
+    states = states_on_grid(extent)
+    energy, force = sys.energy_and_force(states, t=0.0)
+
+    assert np.allclose(energy, sys.potential(states, t=0.0))
+    assert np.allclose(force, sys.force(states, t=0.0))
+
+
 def test_lithium_cyanide():
     sys, extent = SYSTEMS['LithiumCyanide']
     states = states_on_grid(extent)
@@ -48,6 +67,154 @@ def test_lithium_cyanide():
     assert np.abs(cpp - py).max() <= POT_TOLERANCE
 
 
+def test_lithium_cyanide_tabulated(tmp_path):
+    analytic, extent = SYSTEMS['LithiumCyanide']
+    tabulated = mfptlib.lithium_cyanide(tabulated=True, cache_dir=tmp_path)
+    states = states_on_grid(extent)
+
+    energy, force = tabulated.energy_and_force(states, t=0.0)
+    assert np.abs(energy - analytic.potential(states, t=0.0)).max() <= 1e-7
+    assert np.abs(force - analytic.force(states, t=0.0)).max() <= 1e-5
+    assert list(tmp_path.iterdir())
+
+
+def test_expression_system():
+    oscillator, extent = SYSTEMS['HarmonicOscillator']
+    sys = mfptlib.expression_system(
+        '0.5 * q0^2 + 0.75 * q1^2', masses=[1.0, 2.0])
+    states = states_on_grid(extent)
+
+    energy, force = sys.energy_and_force(states, t=0.0)
+    assert np.abs(energy - oscillator.potential(states, t=0.0)).max() <= 1e-15
+    assert np.abs(force - oscillator.force(states, t=0.0)).max() <= 1e-15
+
+    with pytest.raises(ValueError):
+        mfptlib.expression_system('q2', masses=[1.0, 2.0])
+
+
+def test_function_system():
+    oscillator, extent = SYSTEMS['HarmonicOscillator']
+    strengths = [1.0, 1.5]
+    c_double_p = ctypes.POINTER(ctypes.c_double)
+
+    @ctypes.CFUNCTYPE(None, ctypes.c_void_p, ctypes.c_int64, c_double_p,
+                      ctypes.c_int64, ctypes.c_double, c_double_p)
+    def potential(context, rows, states, stride, t, out):
+        for row in range(rows):
+            out[row] = 0.5 * sum(
+                k * states[dof * stride + row] ** 2
+                for dof, k in enumerate(strengths)
+            )
+
+    @ctypes.CFUNCTYPE(None, ctypes.c_void_p, ctypes.c_int64, c_double_p,
+                      ctypes.c_int64, ctypes.c_double, c_double_p,
+                      ctypes.c_int64)
+    def force(context, rows, states, stride, t, out, out_stride):
+        for dof, k in enumerate(strengths):
+            for row in range(rows):
+                out[dof * out_stride + row] = -k * states[dof * stride + row]
+
+    sys = mfptlib.function_system(potential, force, masses=[1.0, 2.0])
+    states = mfptlib.states(q=np.random.default_rng(42).normal(size=(50, 2)))
+
+    energy, forces = sys.energy_and_force(states, t=0.0)
+    assert np.allclose(energy, oscillator.potential(states, t=0.0))
+    assert np.allclose(forces, oscillator.force(states, t=0.0))
+    assert np.array_equal(sys.masses(states), oscillator.masses(states))
+
+
+def test_python_system():
+    oscillator, extent = SYSTEMS['HarmonicOscillator']
+    strengths = np.array([1.0, 1.5])
+    calls = []
+
+    def potential(qp, t):
+        calls.append('potential')
+        assert not qp.flags.writeable
+        return 0.5 * (strengths * qp[:, :2] ** 2).sum(axis=1)
+
+    def force(qp, t):
+        calls.append('force')
+        return -strengths * qp[:, :2]
+
+    def energy_and_force(qp, t):
+        calls.append('energy_and_force')
+        return potential(qp, t), force(qp, t)
+
+    sys = mfptlib.python_system(
+        potential, force, masses=[1.0, 2.0],
+        energy_and_force=energy_and_force,
+    )
+    states = mfptlib.states(q=np.random.default_rng(42).normal(size=(50, 2)))
+
+    energy, forces = sys.energy_and_force(states, t=0.0)
+    assert calls == ['energy_and_force', 'potential', 'force']
+    assert np.allclose(energy, oscillator.potential(states, t=0.0))
+    assert np.allclose(forces, oscillator.force(states, t=0.0))
+    assert np.array_equal(sys.masses(states), oscillator.masses(states))
+    assert len(calls) == 3
+
+    sys = mfptlib.python_system(
+        potential, force, masses=lambda qp: 1.0 + np.abs(qp[:, :2]), dofs=2,
+    )
+    assert np.array_equal(sys.masses(states), 1.0 + np.abs(states[:, :2]))
+
+
+def test_python_system_errors():
+    def potential(qp, t):
+        raise ZeroDivisionError
+
+    def force(qp, t):
+        return np.zeros((len(qp), 2))
+
+    sys = mfptlib.python_system(potential, force, masses=[1.0])
+    states = mfptlib.states(q=np.zeros((4, 1)))
+
+    with pytest.raises(ZeroDivisionError):
+        sys.potential(states, t=0.0)
+    with pytest.raises(ValueError):
+        sys.force(states, t=0.0)
+    with pytest.raises(ValueError):
+        mfptlib.python_system(potential, force, masses=np.abs)
+
+
+def test_plugin_system_missing(tmp_path):
+    with pytest.raises(RuntimeError):
+        mfptlib.plugin_system(tmp_path / 'missing.so')
+
+
+def test_grid_system():
+    oscillator, extent = SYSTEMS['HarmonicOscillator']
+    axes = [np.linspace(*lim, 41) for lim in extent]
+    values = 0.5 * (axes[0][:, None] ** 2 + 1.5 * axes[1][None, :] ** 2)
+    sys = mfptlib.grid_system(
+        values,
+        lower=[lim[0] for lim in extent],
+        upper=[lim[1] for lim in extent],
+        masses=[1.0, 2.0],
+    )
+    states = states_on_grid([(-0.9, +0.9), (-0.9, +0.9)])
+
+    # Catmull-Rom interpolation is exact for quadratic potentials.
+    energy, force = sys.energy_and_force(states, t=0.0)
+    assert np.abs(energy - oscillator.potential(states, t=0.0)).max() <= 1e-12
+    assert np.abs(force - oscillator.force(states, t=0.0)).max() <= 1e-10
+    assert np.array_equal(sys.masses(states), oscillator.masses(states))
+
+
+def test_grid_system_periodic():
+    angles = np.linspace(0.0, 2 * np.pi, 256, endpoint=False)
+    sys = mfptlib.grid_system(
+        np.cos(angles), lower=[0.0], upper=[2 * np.pi], masses=[1.0],
+        periodic=[True],
+    )
+    states = states_on_grid([(-10.0, +10.0)])
+    q = states[:, 0]
+
+    assert np.abs(sys.potential(states, t=0.0) - np.cos(q)).max() <= 1e-4
+    assert np.abs(sys.force(states, t=0.0)[:, 0] - np.sin(q)).max() <= 1e-3
+
+
 def states_on_grid(extent):
     ranges = (np.linspace(*lim, POINTS_PER_DOF) for lim in extent)
     return mfptlib.states(q=mfptlib.grid(*ranges))
@@ -61,3 +228,4 @@ def grad_force(sys, states, t, eps=GRAD_EPSILON):
         [(pot(i, -eps) - pot(i, +eps)) / (2 * eps) for i in range(n)],
         axis=1,
     )
+
@@ -120,3 +120,11 @@ def test_grid():
         [2.0, 1.1], [2.0, 2.1], [2.0, 3.1],
         [3.0, 1.1], [3.0, 2.1], [3.0, 3.1],
     ])
+
+
+def test_padded():
+    qp = mfptlib.padded(STATES)
+
+    assert np.all(qp == STATES)
+    assert qp.strides == (8, 8 * 8)
+    assert qp.ctypes.data % 64 == 0